@@ -97,6 +97,18 @@ enum custom_errors
     invalid_hex_type_error          = 0x22,
     missing_mem_size_type_error     = 0x23,
     missing_parts_error             = 0x24,
+    /* Incremental compilation errors. */
+    invalid_edit_error              = 0x25,
+    /* Variable resolution errors. */
+    undeclared_variable_error       = 0x26,
+    variable_redeclared_error       = 0x27,
+    /* Include errors. */
+    incmem_in_included_file_error   = 0x28,
+    /* Executable errors. */
+    executable_write_error          = 0x29,
+    c_source_write_error            = 0x2A,
+    /* Command line errors. */
+    batch_option_error              = 0x2B,
 };
 
 /* Colors for printing. */
@@ -104,13 +116,16 @@ enum custom_errors
 #define warning_color   "\e[0;33m"
 #define reset           "\e[0m"
 
+/* Record the error and recover, or print it and end the program(see `diagnostics.h`). */
+void report_error(nT32 error_code, const nT8 *err_msg, ...) __attribute__((noreturn, format(printf, 2, 3)));
+
+/* Is `filename` a `.sum` file, with a name that is not too long? */
+bool check_file(nT8 *filename);
+
 /* Assertion/Error. */
 #define lang_error(err_msg, error_code, ...)               \
 {                                                          \
-    fprintf(stderr, "\n%s[ERROR]%s ", error_color, reset); \
-    fprintf(stderr, err_msg, ##__VA_ARGS__);               \
-    fprintf(stderr, "\n");                                 \
-    exit(error_code);                                      \
+    report_error(error_code, err_msg, ##__VA_ARGS__);      \
 }
 
 #define lang_assert(cond, err_msg, error_code, ...)     \
@@ -138,7 +153,7 @@ uT8 *initiate_path(uT8 data1[], uT8 data2[])
 	lang_assert(data1, "Cannot initiate the path. No data given to configure the path.\n", unknown_error)
 
 	/* Initiate `array` and concat `data1` to it. */
-	uT8 *array = calloc(strlen(nT8_PCC data1), sizeof(*array));
+	uT8 *array = calloc(strlen(nT8_PCC data1) + 1, sizeof(*array));
     lang_assert(array,
         "Error allocating memory for `initiate_path`.\n\tTry rerunning the program.\n",
         OOC_allocation_error)
@@ -168,49 +183,20 @@ uT8 *initiate_path(uT8 data1[], uT8 data2[])
 /* Check file extension and length. */
 bool check_file(nT8 *filename)
 {
-    uT8 i = 0;
+    /* If `filename` is a path(e.g. `dir/file.sum`) only its last part is the name of the file. */
+    nT8 *file_name = strrchr(filename, '/');
+    file_name = file_name ? file_name + 1 : filename;
 
     /* Where does the extension start in the filename? */
-    nT8 extension_start_index = 0;
+    nT8 *extension = strchr(file_name, '.');
 
-    /* If `filename` is a path(e.g. `dir/file.sum`) we want to know where the filename starts. */
-    nT8 file_name_start_index = 0;
-
-    nT8 *extension = malloc(4 * sizeof(nT8));
-    lang_assert(extension,
-        "Error allocating memory for `check_file`.\n\tTry rerunning the program.\n",
-        OOC_allocation_error)
-    uT8 index = 0;
-    memset(extension, 0, 4);
-
-    /* Before we check the length, check if it is a full given path. */
-    for(; i < strlen(nT8_PCC filename); i++)
-    {
-        if(filename[i] == '/') { file_name_start_index = i; break; }
-        if(i == strlen(nT8_PCC filename) - 1) i = 0;
-    }
-
-    /* Get the start of the extension. */
-    for(i = file_name_start_index + 1; i < strlen(nT8_PCC filename); i++)
-        if(filename[i] == '.') { extension_start_index = i + 1; break; }
-    
     /* Make sure the filename does not exceed the max length. */
-    lang_assert(strlen(nT8_PCC filename) - extension_start_index <= 10, "The file `%s` has a length > 10.\n", filename_too_long_error, filename)
+    lang_assert(!(extension) || extension - file_name <= filename_max_size, "The file `%s` has a length > %d.\n", filename_too_long_error, filename, filename_max_size)
 
-    for(i = 0; i < strlen(nT8_PCC filename); i++)
-        if(filename[i] == '.') { extension_start_index = i + 1; break; }
-    
-    lang_assert(extension_start_index != 0, "The file `%s` has no extension.\n\tAdd the extension `.sum` to the file.\n", no_extension_error, filename)
-    lang_assert((strlen(nT8_PCC filename) - (i + 1)) == extension_length, "The extension for the file `%s` is too long.\n\tThe extension should be `.sum`.\n", extension_too_long_error, filename)
-    
-    /* Get the extension. */
-    for(i = i+1; i < strlen(nT8_PCC filename); i++)
-    { extension[index] = filename[i]; index++; }
-    
-    if(strcmp(extension, "sum") == 0) { free(extension); return true; }
+    lang_assert(extension, "The file `%s` has no extension.\n\tAdd the extension `.sum` to the file.\n", no_extension_error, filename)
+    lang_assert(strlen(extension + 1) == extension_length, "The extension for the file `%s` is too long.\n\tThe extension should be `.sum`.\n", extension_too_long_error, filename)
 
-    free(extension);
-    return false;
+    return strcmp(extension + 1, "sum") == 0;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,187 @@
+#ifndef arena_allocator
+#define arena_allocator
+
+/* Size of a block of the arena. Allocations bigger than this get a block of their own. */
+#define arena_block_size        0x10000
+
+/* Every allocation is aligned to this. */
+#define arena_alignment         0x10
+
+/* One block of an arena. Blocks are chained newest first. */
+typedef struct arena_block
+{
+    struct arena_block  *previous;
+    uSIZE               capacity;
+    uSIZE               used;
+    uT8                 data[];
+} _arena_block;
+
+/* Region allocator.
+ * Memory is handed out by bumping `used` in the newest block, and is never freed on its own;
+ * everything goes at once in `destroy_arena`. The lexer, the parser, the AST and the `.mem`
+ * parser all allocate from `front_end_arena`, so tearing a compilation down is one walk over
+ * the blocks instead of one `free` per allocation.
+ * */
+typedef struct arena
+{
+    _arena_block    *current;
+
+    /* Bytes handed out, for tracing. */
+    uSIZE           allocated;
+} _arena;
+
+_arena *new_arena()
+{
+    _arena *a = calloc(1, sizeof(*a));
+    lang_assert(a,
+        "Error allocating memory for an arena.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    return a;
+}
+
+/* `size` bytes of zeroed memory from `a`. Valid until `a` is destroyed. */
+void *arena_alloc(_arena *a, uSIZE size)
+{
+    size = (size + arena_alignment - 1) & ~((uSIZE) arena_alignment - 1);
+
+    if(!(a->current) || a->current->used + size > a->current->capacity)
+    {
+        uSIZE capacity = size > arena_block_size ? size : arena_block_size;
+        _arena_block *block = malloc(sizeof(*block) + capacity);
+        lang_assert(block,
+            "Error allocating memory for an arena block(%llu bytes).\n\tTry rerunning the program.\n",
+            OOC_allocation_error, capacity)
+
+        block->capacity = capacity;
+        block->used = 0;
+
+        /* An oversized block goes behind the current one, so the rest of the current one is not wasted. */
+        if(a->current && capacity > arena_block_size)
+        {
+            block->previous = a->current->previous;
+            a->current->previous = block;
+        }
+        else
+        {
+            block->previous = a->current;
+            a->current = block;
+        }
+
+        block->used = size;
+        a->allocated += size;
+        return memset(block->data, 0, size);
+    }
+
+    void *memory = &a->current->data[a->current->used];
+    a->current->used += size;
+    a->allocated += size;
+
+    return memset(memory, 0, size);
+}
+
+/* Copy `length` bytes of `value` into `a`, followed by a `\0`. */
+uT8 *arena_copy(_arena *a, const uT8 *value, uSIZE length)
+{
+    uT8 *copy = arena_alloc(a, length + 1);
+
+    memcpy(copy, value, length);
+    return copy;
+}
+
+/* How far an arena was filled, see `arena_rewind`. */
+typedef struct arena_mark
+{
+    _arena_block    *current;
+    _arena_block    *previous;
+    uSIZE           used;
+    uSIZE           allocated;
+} _arena_mark;
+
+_arena_mark arena_mark(_arena *a)
+{
+    if(!(a->current)) return (_arena_mark) { .allocated = a->allocated };
+
+    return (_arena_mark) { a->current, a->current->previous, a->current->used, a->allocated };
+}
+
+/* Free everything `a` handed out since `mark` was taken, the memory from before it stays valid.
+ * Blocks made since are all in front of `mark.current`, or(oversized ones) between it and `mark.previous`.
+ * */
+void arena_rewind(_arena *a, _arena_mark mark)
+{
+    while(a->current != mark.current)
+    {
+        _arena_block *previous = a->current->previous;
+
+        free(a->current);
+        a->current = previous;
+    }
+
+    a->allocated = mark.allocated;
+    if(!(mark.current)) return;
+
+    while(mark.current->previous != mark.previous)
+    {
+        _arena_block *oversized = mark.current->previous;
+
+        mark.current->previous = oversized->previous;
+        free(oversized);
+    }
+
+    mark.current->used = mark.used;
+}
+
+/* Copy the `size` bytes at `data` to the heap, into room for `capacity` bytes(at least `size`). */
+void *heap_copy(const void *data, uSIZE size, uSIZE capacity)
+{
+    uT8 *copy = malloc(capacity + 1);
+    lang_assert(copy,
+        "Error allocating memory(%llu bytes).\n\tTry rerunning the program.\n",
+        OOC_allocation_error, capacity)
+
+    memcpy(copy, data, size);
+    return copy;
+}
+
+void destroy_arena(_arena *a)
+{
+    if(!(a)) return;
+
+    trace(TC_ast, TL_info, "Arena released %llu bytes", a->allocated);
+
+    while(a->current)
+    {
+        _arena_block *previous = a->current->previous;
+
+        free(a->current);
+        a->current = previous;
+    }
+
+    free(a);
+}
+
+/* The arena of the compilation that is running(see `context.h`). Created on first use. */
+#define front_end_arena     (active_context->arena)
+
+void *front_end_alloc(uSIZE size)
+{
+    if(!(front_end_arena)) front_end_arena = new_arena();
+
+    return arena_alloc(front_end_arena, size);
+}
+
+uT8 *front_end_copy(const uT8 *value, uSIZE length)
+{
+    if(!(front_end_arena)) front_end_arena = new_arena();
+
+    return arena_copy(front_end_arena, value, length);
+}
+
+void destroy_front_end_arena()
+{
+    destroy_arena(front_end_arena);
+    front_end_arena = NULL;
+}
+
+#endif
@@ -1,11 +1,24 @@
 #ifndef ast
 #define ast
 
+/* Kind of an AST node.
+ * Statements come first, the operands of statements after them.
+ * */
 enum action
 {
-    print_statement = 0x0,
-    variable_decl,
-    ast_tree_init
+    print_statement = 0x0,      // a: the operand node
+    variable_decl,              // a: symbol of the variable, b: the operand node(its value)
+    exit_statement,             // a: exit status
+    include_statement,          // a: offset of the path into `tree.strings`, b: nodes the included file added right after it(see `include.h`)
+
+    /* Operands. */
+    string_operand,             // a: offset into `tree.strings`, b: length
+    char_operand,               // a: offset into `tree.strings`, b: length(always 1)
+    integer_operand,            // a: low 32 bits, b: high 32 bits
+    float_operand,              // a: low 32 bits, b: high 32 bits(of the double)
+    hex_operand,                // a: low 32 bits, b: high 32 bits
+    variable_operand,           // a: symbol of the variable, b: its slot(see `resolve_variables`)
+    no_operand                  // a: `enum var_decl_DT`(a variable that was not given a value)
 };
 
 enum var_decl_DT
@@ -13,7 +26,8 @@ enum var_decl_DT
     Char = 0x03,
     Str,
     Int,
-    Hex
+    Hex,
+    Unknown     // a declaration that did not parse(see `skip_failed_statement`)
 };
 
 enum ast_state
@@ -23,166 +37,297 @@ enum ast_state
     adding_variable_decl,
     adding_print_statement,
     adding_function,
-    ready
+    ready,
+    adding_exit_statement
 };
 
+/* Node that does not exist. */
+#define no_node     0xFFFFFFFF
+
+/* `b` of an include that has not been linked yet, and of one whose file was already included earlier(see `include.h`). */
+#define include_pending     0xFFFFFFFF
+#define include_repeated    0xFFFFFFFE
+
+/* The AST, as parallel arrays indexed by node.
+ * Nodes refer to each other, to symbols and to strings by index or offset, never by pointer,
+ * so the whole tree can be written out and read back(or mapped) as it is.
+ *
+ * A statement's operand is added right before the statement, and statements are in source
+ * order, so walking the nodes in order walks the program. `span_start` is an offset into the
+ * whole file; statements never span lines, which is what lets an edit(see `incremental.h`) find
+ * the nodes it touched and keep the rest.
+ * */
 typedef struct ast_tree
 {
-    enum action action_occurred;
-
-    union {
-        struct {
-            uT8 *value_to_print;
-        } print;
-
-        struct {
-            enum var_decl_DT variable_datatype;
-            uT8 *variable_name;
-            
-            union {
-                uT8 *string_value;
-                uT32 integer_value;
-                uT8 char_value;
-                uT8 *hex_value;
-            } variable_value;
-        } var_declaration;
-    } action_data;
-
-    /* What is the "state" of the ast at the current index?
-     * `stuck` - an error ocurred. The ast is trying to fix it.
+    uT8         *kind;
+    uT32        *a;
+    uT32        *b;
+    uSIZE       *span_start;
+    uT32        *span_length;
+
+    uT32        amount;
+    uT32        capacity;
+
+    /* Values of the string operands(and paths of the includes), back to back(each `\0` terminated), in the
+     * order of their nodes.
+     * */
+    uT8         *strings;
+    uT32        strings_size;
+    uT32        strings_capacity;
+
+    /* What is the "state" of the ast?
+     * `ready` - the ast is ready for the next statement.
      * `comitted` - the program is done, the ast is complete.
-     * `adding_variable_decl` - the ast is creating a "tree entry" for a variable declaration.
-     * `adding_print_statement` - the ast is creating a "tree entry" for a print statement.
-     * `adding_function` - the ast is creating a "tree entry" for a function.
-     * `ready` - the current index of the ast is ready to be filled with data.
      * */
-    enum ast_state      state;
+    enum ast_state  state;
 
-    /* When `state` is `comitted`, `entire_tree` will be assigned to `tree`. */
-    struct ast_tree     **entire_tree;
+    /* The arrays point into a cache file(see `cache.h`), they are not freed. */
+    bool            mapped;
 } _ast_tree;
 
-_ast_tree **tree = NULL;
-static uT32 tree_index = 0;
+/* The ast of the compilation that is running(see `context.h`). */
+#define tree                (*active_context->syntax_tree)
 
-/* Create a new "entry" in the tree.
- * AO - Action Ocurred
- * */
-void new_tree_entry(enum action AO)
+/* Start an empty ast(keeping whatever memory it already has). */
+void init_ast()
+{
+    tree.amount = 0;
+    tree.strings_size = 0;
+    tree.state = ready;
+}
+
+/* A tree loaded from the cache moves to the heap before it grows. */
+static void unmap_ast_tree()
+{
+    if(!(tree.mapped)) return;
+
+    tree.kind = heap_copy(tree.kind, tree.amount * sizeof(*tree.kind), tree.amount * sizeof(*tree.kind));
+    tree.a = heap_copy(tree.a, tree.amount * sizeof(*tree.a), tree.amount * sizeof(*tree.a));
+    tree.b = heap_copy(tree.b, tree.amount * sizeof(*tree.b), tree.amount * sizeof(*tree.b));
+    tree.span_start = heap_copy(tree.span_start, tree.amount * sizeof(*tree.span_start), tree.amount * sizeof(*tree.span_start));
+    tree.span_length = heap_copy(tree.span_length, tree.amount * sizeof(*tree.span_length), tree.amount * sizeof(*tree.span_length));
+    tree.strings = heap_copy(tree.strings, tree.strings_size, tree.strings_size);
+
+    tree.capacity = tree.amount;
+    tree.strings_capacity = tree.strings_size;
+    tree.mapped = false;
+}
+
+/* Make sure there is room for `amount` nodes. The arrays double in size, up to the most nodes there can be. */
+void reserve_ast_nodes(uSIZE amount)
+{
+    /* Nodes are numbered with 32 bits, and `no_node` is not one. */
+    lang_assert(amount < no_node,
+        "The program has more than %u AST nodes.\n",
+        OOC_allocation_error, no_node - 1)
+
+    if(amount <= tree.capacity) return;
+    unmap_ast_tree();
+
+    uSIZE capacity = tree.capacity ? tree.capacity : 0x40;
+    while(capacity < amount) capacity *= 2;
+    if(capacity >= no_node) capacity = no_node - 1;
+
+    tree.kind = realloc(tree.kind, capacity * sizeof(*tree.kind));
+    tree.a = realloc(tree.a, capacity * sizeof(*tree.a));
+    tree.b = realloc(tree.b, capacity * sizeof(*tree.b));
+    tree.span_start = realloc(tree.span_start, capacity * sizeof(*tree.span_start));
+    tree.span_length = realloc(tree.span_length, capacity * sizeof(*tree.span_length));
+    lang_assert(tree.kind && tree.a && tree.b && tree.span_start && tree.span_length,
+        "Error allocating memory for the AST tree(%llu nodes).\n",
+        OOC_allocation_error, capacity)
+
+    tree.capacity = capacity;
+}
+
+/* Add a node covering the tokens `first` to `last`, and return its index. */
+uT32 add_ast_node(enum action kind, uT32 a, uT32 b, _token *first, _token *last)
 {
-    /* Make sure we have memory allocated. */
-    if(!(tree)) tree = calloc((tree_index + 1), sizeof(*tree));
-    lang_assert(tree, 
-        "Error allocating memory for the AST tree.\n", 
+    reserve_ast_nodes((uSIZE) tree.amount + 1);
+
+    uT32 node = tree.amount++;
+    tree.kind[node] = kind;
+    tree.a[node] = a;
+    tree.b[node] = b;
+    tree.span_start[node] = first->offset;
+    tree.span_length[node] = last->offset + last->length - first->offset;
+
+    trace(TC_ast, TL_debug, "New node %llu, kind %llu", node, kind);
+    return node;
+}
+
+/* Add an operand node holding a 64-bit value(an integer, a hexadecimal number, or the bits of a double). */
+uT32 add_ast_number(enum action kind, uSIZE value, _token *t)
+{
+    return add_ast_node(kind, (uT32) value, (uT32) (value >> 32), t, t);
+}
+
+/* The 64-bit value of a number operand. */
+uSIZE ast_number(uT32 node)
+{
+    return (uSIZE) tree.a[node] | (uSIZE) tree.b[node] << 32;
+}
+
+/* Make sure `tree.strings` has room for `size` bytes. */
+void reserve_ast_strings(uSIZE size)
+{
+    if(size <= tree.strings_capacity) return;
+    unmap_ast_tree();
+
+    uSIZE capacity = tree.strings_capacity ? tree.strings_capacity : 0x400;
+    while(capacity < size) capacity *= 2;
+
+    lang_assert(capacity <= 0xFFFFFFFF,
+        "The strings of the program are larger than 4GB.\n",
+        OOC_allocation_error)
+
+    tree.strings = realloc(tree.strings, capacity);
+    lang_assert(tree.strings,
+        "Error allocating memory for the AST strings.\n",
         OOC_allocation_error)
+    tree.strings_capacity = capacity;
+}
+
+/* Copy the `length` bytes at `value` to `tree.strings`, and return their offset. */
+static uT32 add_ast_bytes(const uT8 *value, uT32 length)
+{
+    reserve_ast_strings((uSIZE) tree.strings_size + length + 1);
 
-    if(!(tree[tree_index])) tree[tree_index] = calloc(1, sizeof(*tree[tree_index]));
-    lang_assert(tree[tree_index], 
-        "Error allocating memory for the AST tree entry %d.\n", 
-        OOC_allocation_error, tree_index)
+    uT32 offset = tree.strings_size;
+    memcpy(&tree.strings[offset], value, length);
+    tree.strings[offset + length] = '\0';
+    tree.strings_size += length + 1;
 
-    switch(AO)
+    return offset;
+}
+
+/* Add a string operand for the `length` bytes at `value`. */
+uT32 add_ast_string(const uT8 *value, uT32 length, _token *first, _token *last)
+{
+    uT32 offset = add_ast_bytes(value, length);
+    return add_ast_node(string_operand, offset, length, first, last);
+}
+
+/* Add a character operand for `value`. It is kept like a string of one character, and printed like one. */
+uT32 add_ast_character(uT8 value, _token *first, _token *last)
+{
+    uT32 offset = add_ast_bytes(&value, 1);
+    return add_ast_node(char_operand, offset, 1, first, last);
+}
+
+/* Add an include of the file at the `length` bytes of `path`, to be linked later(see `link_includes`). */
+uT32 add_ast_include(const uT8 *path, uT32 length, _token *first, _token *last)
+{
+    uT32 offset = add_ast_bytes(path, length);
+    return add_ast_node(include_statement, offset, include_pending, first, last);
+}
+
+/* The value of a string operand. */
+const uT8 *ast_string(uT32 node)
+{
+    return &tree.strings[tree.a[node]];
+}
+
+/* Which datatype was variable declaration `node` given? */
+enum var_decl_DT variable_decl_datatype(uT32 node)
+{
+    switch(tree.kind[tree.b[node]])
     {
-        case print_statement: {
-            tree[tree_index]->action_data.print.value_to_print = token_data->token_info.DT_token_info.data_type_value;
-            tree[tree_index]->state = adding_print_statement;
-            tree_index++;
-
-            tree = realloc(
-                tree,
-                (tree_index + 1) * sizeof(*tree)
-            );
-            tree[tree_index] = calloc(1, sizeof(*tree[tree_index]));
-            lang_assert(tree[tree_index], 
-                "Error allocating memory for the AST tree entry %d.\n", 
-                OOC_allocation_error, tree_index)
-            tree[tree_index]->state = ready;
-
-            break;
-        }
-        case variable_decl: {
-            tree[tree_index]->state = adding_variable_decl;
-            exit(0);
-            break;
-        }
-        case ast_tree_init: {
-            tree[tree_index]->state = ready;
-            break;
-        }
-        default: break;
+        case string_operand: return Str;
+        case char_operand: return Char;
+        case hex_operand: return Hex;
+        case no_operand: return tree.a[tree.b[node]];
+        default: return Int;
     }
 }
 
+/* Append the nodes of `segment`(an ast built on its own, see `parallel.h`) to `tree`.
+ * Operand indices and string offsets are moved past what `tree` already has, and symbols
+ * are translated through `symbol_map`.
+ * */
+void append_ast_segment(_ast_tree *segment, const uT32 *symbol_map)
+{
+    uT32 first = tree.amount;
+    uT32 strings_base = tree.strings_size;
+
+    reserve_ast_nodes((uSIZE) first + segment->amount);
+
+    if(segment->strings_size)
+    {
+        reserve_ast_strings((uSIZE) tree.strings_size + segment->strings_size);
+        memcpy(&tree.strings[strings_base], segment->strings, segment->strings_size);
+        tree.strings_size += segment->strings_size;
+    }
+
+    memcpy(&tree.kind[first], segment->kind, segment->amount * sizeof(*tree.kind));
+    memcpy(&tree.a[first], segment->a, segment->amount * sizeof(*tree.a));
+    memcpy(&tree.b[first], segment->b, segment->amount * sizeof(*tree.b));
+    memcpy(&tree.span_start[first], segment->span_start, segment->amount * sizeof(*tree.span_start));
+    memcpy(&tree.span_length[first], segment->span_length, segment->amount * sizeof(*tree.span_length));
+
+    for(uT32 node = first; node < first + segment->amount; node++)
+        switch(tree.kind[node])
+        {
+            case print_statement: tree.a[node] += first;break;
+            case variable_decl: {
+                tree.a[node] = symbol_map[tree.a[node]];
+                tree.b[node] += first;
+                break;
+            }
+            case variable_operand: tree.a[node] = symbol_map[tree.a[node]];break;
+            case string_operand:
+            case char_operand:
+            case include_statement: tree.a[node] += strings_base;break;
+            default: break;
+        }
+
+    tree.amount += segment->amount;
+    if(segment->state == comitted) tree.state = comitted;
+}
+
 /* Commit the ast.
  * Set the state of the ast to "official".
  * */
 void commit_ast()
 {
-    /* Make sure there is valid memory allocated for the last index of the ast. */
-    if(!tree[tree_index])
-    {
-        tree[tree_index] = calloc(1, sizeof(*tree[tree_index]));
-        lang_assert(tree[tree_index], 
-            "Error allocating memory for the AST tree entry %d.\n", 
-            OOC_allocation_error, tree_index)
-    }
-    
-    /* Set the state of the ast to `comitted`. Store the entire "tree" in `entire_tree`. */
-    tree[tree_index]->state = comitted;
-    tree[tree_index]->entire_tree = tree;
+    tree.state = comitted;
+
+    trace(TC_ast, TL_info, "Committed the AST with %llu nodes", tree.amount);
 }
 bool ast_has_been_comitted()
 {
-    return tree[tree_index]->state == comitted ? true : false;
+    return tree.state == comitted ? true : false;
 }
 bool check_is_EOF(_parser *p)
 {
-    if(lexer_peek_and_return(p->lang_lexer) == '\0')
+    /* When streaming, END only means the end of the current window. */
+    if(peek_token(p, 1)->type_of_token == END && !(p->lang_lexer->more_input))
         commit_ast();
-    
+
     return ast_has_been_comitted();
 }
 
-void destroy_tree()
+void free_ast_tree(_ast_tree *t)
 {
-    for(uT32 i = 0; i < tree_index; i++)
+    if(t->mapped)
     {
-        switch(tree[i]->action_occurred)
-        {
-            case print_statement: {
-                free(tree[i]->action_data.print.value_to_print);
-                tree[i]->action_data.print.value_to_print = NULL;
-                
-                free(tree[i]);
-                tree[i] = NULL;
-                break;
-            }
-            case variable_decl: {
-                switch(tree[i]->action_data.var_declaration.variable_datatype)
-                {
-                    case Str: {
-                        free(tree[i]->action_data.var_declaration.variable_value.string_value);
-                        tree[i]->action_data.var_declaration.variable_value.string_value = NULL;
-                        break;
-                    }
-                    case Char: {
-                        tree[i]->action_data.var_declaration.variable_value.char_value = '\0';
-                        break;
-                    }
-                    case Int: break;
-                    case Hex: {
-                        free(tree[i]->action_data.var_declaration.variable_value.hex_value);
-                        tree[i]->action_data.var_declaration.variable_value.hex_value = NULL;
-                    }
-                }
-
-                free(tree[i]);
-                tree[i] = NULL;
-                break;
-            }
-            default: break;
-        }
+        *t = (_ast_tree) { 0 };
+        return;
     }
+
+    free(t->kind);
+    free(t->a);
+    free(t->b);
+    free(t->span_start);
+    free(t->span_length);
+    free(t->strings);
+
+    *t = (_ast_tree) { 0 };
+}
+
+void destroy_tree()
+{
+    free_ast_tree(&tree);
 }
 
-#endif
\ No newline at end of file
+#endif
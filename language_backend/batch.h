@@ -0,0 +1,486 @@
+#ifndef batch_compilation
+#define batch_compilation
+#include <pthread.h>
+#include <dirent.h>
+#include <time.h>
+
+/* How many of the slowest files the summary of a batch names. */
+#define batch_slowest_shown     5
+
+/* A `.mem` file, parsed once for every compilation of a batch that uses it. */
+typedef struct shared_dot_mem
+{
+    nT8                 *path;
+
+    /* The compilation it was parsed in. Its memory info is borrowed by every program using the file,
+     * and its errors are handed to each of them.
+     * */
+    _compiler_context   *context;
+
+    /* Programs using it. */
+    uT32                users;
+
+    bool                missing;
+    bool                parsed;
+} _shared_dot_mem;
+
+/* Every `.mem` file of a batch, see `use_shared_dot_mem`. */
+typedef struct dot_mem_store
+{
+    pthread_mutex_t     lock;
+
+    /* Signalled whenever a `.mem` file is done being parsed. */
+    pthread_cond_t      done;
+
+    /* Pointers, so an entry stays put while others are added. */
+    _shared_dot_mem     **entries;
+    uT32                amount;
+    uT32                capacity;
+} _dot_mem_store;
+
+/* `#incmem` in a batch: the first compilation to want `dot_mem_filename` parses it(in a compilation
+ * of its own), every other one waits for that and borrows the result. Either way the program ends
+ * up with the same memory info, and the same errors, as if it had parsed the file itself.
+ * Returns false if the file does not exist.
+ * */
+bool use_shared_dot_mem(_dot_mem_store *store, uT8 *dot_mem_filename)
+{
+    _compiler_context *context = active_context;
+    _shared_dot_mem *entry = NULL;
+    bool parse = false;
+
+    pthread_mutex_lock(&store->lock);
+
+    for(uT32 i = 0; i < store->amount && !(entry); i++)
+        if(strcmp(store->entries[i]->path, nT8_PCC dot_mem_filename) == 0) entry = store->entries[i];
+
+    if(!(entry))
+    {
+        if(store->amount == store->capacity)
+        {
+            store->capacity = store->capacity ? store->capacity * 2 : 0x10;
+            store->entries = realloc(store->entries, store->capacity * sizeof(*store->entries));
+        }
+
+        entry = calloc(1, sizeof(*entry));
+        lang_assert(store->entries && entry && (entry->path = strdup(nT8_PCC dot_mem_filename)),
+            "Error allocating memory for the `.mem` files of the batch.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+
+        store->entries[store->amount++] = entry;
+        parse = true;
+    }
+
+    entry->users++;
+    pthread_mutex_unlock(&store->lock);
+
+    if(parse)
+    {
+        _source_buffer *dot_mem_file_data = init_source_buffer(nT8_PC dot_mem_filename);
+
+        if(dot_mem_file_data)
+        {
+            entry->context = new_compiler_context();
+            run_dot_mem_parser(entry->context, dot_mem_file_data, dot_mem_filename);
+
+            destroy_source_buffer(dot_mem_file_data);
+            use_compiler_context(context);
+        }
+
+        pthread_mutex_lock(&store->lock);
+        entry->missing = !(dot_mem_file_data);
+        entry->parsed = true;
+        pthread_cond_broadcast(&store->done);
+        pthread_mutex_unlock(&store->lock);
+    }
+    else
+    {
+        pthread_mutex_lock(&store->lock);
+        while(!(entry->parsed)) pthread_cond_wait(&store->done, &store->lock);
+        pthread_mutex_unlock(&store->lock);
+    }
+
+    if(entry->missing) return false;
+
+    context->memory_info = entry->context->memory_info;
+    context->memory_info_borrowed = true;
+
+    /* The errors of the `.mem` file are at the `#incmem`, like they are when the program parses it itself. */
+    _diagnostics *errors = &entry->context->diagnostics;
+    for(uT32 i = 0; i < errors->amount; i++)
+        add_diagnostic(&context->diagnostics, errors->entries[i].error_code, context->diagnostics.offset,
+            errors->entries[i].message ? strdup(errors->entries[i].message) : NULL);
+
+    return true;
+}
+
+void destroy_dot_mem_store(_dot_mem_store *store)
+{
+    for(uT32 i = 0; i < store->amount; i++)
+    {
+        destroy_compiler_context(store->entries[i]->context);
+        free(store->entries[i]->path);
+        free(store->entries[i]);
+    }
+
+    free(store->entries);
+    pthread_mutex_destroy(&store->lock);
+    pthread_cond_destroy(&store->done);
+}
+
+/* A file of a batch, and how compiling it went. */
+typedef struct batch_file
+{
+    nT8         *path;
+
+    /* Status the file would have exited with on its own, and how many errors it had. */
+    nT32        status;
+    uT32        errors;
+
+    uSIZE       nanoseconds;
+} _batch_file;
+
+/* Files [`top`, `bottom`) of a batch that a worker still has to compile.
+ * The worker takes them from the bottom, other workers that ran out steal them from the top.
+ * */
+typedef struct batch_queue
+{
+    pthread_mutex_t lock;
+    uT32        top;
+    uT32        bottom;
+} _batch_queue;
+
+typedef struct batch
+{
+    _batch_file *files;
+    uT32        amount;
+    uT32        capacity;
+
+    _batch_queue    *queues;
+    uT32        workers;
+
+    /* Files a worker took from another's queue. */
+    uT32        steals;
+
+    const nT8   *cache_directory;
+    _dot_mem_store  dot_mem_store;
+
+    /* The errors of one file are printed at a time. */
+    pthread_mutex_t output;
+} _batch;
+
+typedef struct batch_worker
+{
+    _batch      *batch;
+    uT32        index;
+    pthread_t   thread;
+} _batch_worker;
+
+static void add_batch_file(_batch *b, const nT8 *path)
+{
+    if(b->amount == b->capacity)
+    {
+        b->capacity = b->capacity ? b->capacity * 2 : 0x100;
+        b->files = realloc(b->files, b->capacity * sizeof(*b->files));
+        lang_assert(b->files,
+            "Error allocating memory for the files of the batch.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    b->files[b->amount] = (_batch_file) { .path = strdup(path) };
+    lang_assert(b->files[b->amount].path,
+        "Error allocating memory for the files of the batch.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    b->amount++;
+}
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(nT8 * const *) a, *(nT8 * const *) b);
+}
+
+static void add_batch_input(_batch *b, const nT8 *input);
+
+/* Every `.sum` file under `directory`, in name order. Hidden files and directories(e.g. the cache) are skipped. */
+static void add_batch_directory(_batch *b, const nT8 *directory)
+{
+    DIR *dir = opendir(directory);
+    lang_assert(dir, "The directory `%s` cannot be read.\n", file_not_exist_error, directory)
+
+    nT8 **names = NULL;
+    uT32 amount = 0, capacity = 0;
+
+    for(struct dirent *entry; (entry = readdir(dir));)
+    {
+        if(entry->d_name[0] == '.') continue;
+
+        if(amount == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 0x40;
+            names = realloc(names, capacity * sizeof(*names));
+        }
+
+        lang_assert(names && (names[amount] = malloc(strlen(directory) + strlen(entry->d_name) + 2)),
+            "Error allocating memory for the files of the batch.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+
+        sprintf(names[amount++], "%s/%s", directory, entry->d_name);
+    }
+
+    closedir(dir);
+    qsort(names, amount, sizeof(*names), compare_names);
+
+    for(uT32 i = 0; i < amount; i++)
+    {
+        struct stat info;
+        uSIZE length = strlen(names[i]);
+
+        if(stat(names[i], &info) == 0 && S_ISDIR(info.st_mode)) add_batch_directory(b, names[i]);
+        else if(length > 4 && strcmp(&names[i][length - 4], ".sum") == 0) add_batch_file(b, names[i]);
+
+        free(names[i]);
+    }
+
+    free(names);
+}
+
+/* Every file of `response_file`, one input per line(a file, a directory or another response file).
+ * Blank lines, and lines starting with `#`, are skipped.
+ * */
+static void add_batch_response_file(_batch *b, const nT8 *response_file)
+{
+    _source_buffer *list = init_source_buffer(nT8_PC response_file);
+    lang_assert(list,
+        "The response file `%s` doesn't exist, or the path is wrong.\n",
+        file_not_exist_error, response_file)
+
+    nT8 *line = malloc(list->size + 1);
+    lang_assert(line,
+        "Error allocating memory for the files of the batch.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    for(uSIZE start = 0; start < list->size;)
+    {
+        const uT8 *newline = memchr(&list->data[start], '\n', list->size - start);
+        uSIZE end = newline ? (uSIZE) (newline - list->data) : list->size;
+        uSIZE length = end - start;
+
+        memcpy(line, &list->data[start], length);
+        while(length && (line[length - 1] == '\r' || line[length - 1] == ' ' || line[length - 1] == '\t')) length--;
+        line[length] = '\0';
+
+        if(length && line[0] != '#') add_batch_input(b, line);
+        start = end + 1;
+    }
+
+    free(line);
+    destroy_source_buffer(list);
+}
+
+/* `input` is a file, a directory, or `@` and a response file. */
+static void add_batch_input(_batch *b, const nT8 *input)
+{
+    struct stat info;
+
+    if(input[0] == '@') add_batch_response_file(b, &input[1]);
+    else if(stat(input, &info) == 0 && S_ISDIR(info.st_mode)) add_batch_directory(b, input);
+    else add_batch_file(b, input);
+}
+
+/* The next file for worker `worker`: from its own queue, or else stolen from another one. */
+static bool next_batch_file(_batch *b, uT32 worker, uT32 *file)
+{
+    for(uT32 i = 0; i < b->workers; i++)
+    {
+        _batch_queue *queue = &b->queues[(worker + i) % b->workers];
+        bool found = false;
+
+        pthread_mutex_lock(&queue->lock);
+        if(queue->top < queue->bottom)
+        {
+            *file = i ? queue->top++ : --queue->bottom;
+            found = true;
+        }
+        pthread_mutex_unlock(&queue->lock);
+
+        if(found)
+        {
+            if(i) __atomic_fetch_add(&b->steals, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uSIZE batch_clock()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uSIZE) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void compile_batch_file(_batch *b, _batch_file *file)
+{
+    uSIZE start = batch_clock();
+    _compiler_context *context = compile(file->path, false, 1, b->cache_directory, &b->dot_mem_store);
+    file->nanoseconds = batch_clock() - start;
+
+    file->errors = context->diagnostics.amount;
+    if(file->errors)
+    {
+        pthread_mutex_lock(&b->output);
+        fprintf(stderr, "\n%s:", file->path);
+        file->status = report_diagnostics(&context->diagnostics);
+        pthread_mutex_unlock(&b->output);
+    }
+
+    destroy_compiler_context(context);
+}
+
+static void *run_batch_worker(void *argument)
+{
+    _batch_worker *worker = argument;
+    uT32 file;
+
+    while(next_batch_file(worker->batch, worker->index, &file))
+        compile_batch_file(worker->batch, &worker->batch->files[file]);
+
+    return NULL;
+}
+
+static int compare_batch_times(const void *a, const void *b)
+{
+    const _batch_file *x = *(_batch_file * const *) a, *y = *(_batch_file * const *) b;
+    return x->nanoseconds < y->nanoseconds ? 1 : x->nanoseconds > y->nanoseconds ? -1 : 0;
+}
+
+/* One summary for the whole batch: how long it took, which files were slowest, and which failed. */
+static void print_batch_summary(_batch *b, uSIZE nanoseconds)
+{
+    uSIZE work = 0;
+    uT32 failed = 0, parsed = 0, users = 0;
+
+    for(uT32 i = 0; i < b->amount; i++)
+    {
+        work += b->files[i].nanoseconds;
+        if(b->files[i].errors) failed++;
+    }
+    for(uT32 i = 0; i < b->dot_mem_store.amount; i++)
+        if(!(b->dot_mem_store.entries[i]->missing))
+        {
+            parsed++;
+            users += b->dot_mem_store.entries[i]->users;
+        }
+
+    printf("\n[BATCH] %u files on %u thread%s in %.3fs(%.3fs of compiling), %u compiled, %u failed.\n",
+        b->amount, b->workers, b->workers == 1 ? "" : "s", nanoseconds / 1e9, work / 1e9, b->amount - failed, failed);
+    printf("\t%u `.mem` files parsed once each for %u programs, %u files stolen between threads.\n",
+        parsed, users, b->steals);
+
+    _batch_file **by_time = malloc(b->amount * sizeof(*by_time) + 1);
+    lang_assert(by_time,
+        "Error allocating memory for the summary of the batch.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    for(uT32 i = 0; i < b->amount; i++) by_time[i] = &b->files[i];
+    qsort(by_time, b->amount, sizeof(*by_time), compare_batch_times);
+
+    printf("\tSlowest:");
+    for(uT32 i = 0; i < b->amount && i < batch_slowest_shown; i++)
+        printf("%s %s(%.3fms)", i ? "," : "", by_time[i]->path, by_time[i]->nanoseconds / 1e6);
+    printf("\n");
+
+    if(failed)
+    {
+        printf("\tFailed:");
+        for(uT32 i = 0, shown = 0; i < b->amount; i++)
+            if(b->files[i].errors)
+                printf("%s %s(error 0x%02X, %u error%s)", shown++ ? "," : "", b->files[i].path,
+                    b->files[i].status, b->files[i].errors, b->files[i].errors == 1 ? "" : "s");
+        printf("\n");
+    }
+
+    free(by_time);
+}
+
+/* Compile every file of `inputs`(files, directories and `@` response files) on a pool of `jobs` threads.
+ *
+ * Each worker starts with a run of the files of its own. Once it is done with them it steals files,
+ * one at a time, from the other workers, so a few slow files do not hold the batch up. Every file is
+ * a compilation of its own, as if it was compiled on its own, but `.mem` files are parsed once for all
+ * of them(see `use_shared_dot_mem`). The errors of each file are printed as soon as it is done, and
+ * the batch ends with one summary of them all.
+ *
+ * Returns the status of the first file(in the order given) that failed, or 0.
+ * */
+nT32 run_batch(nT8 **inputs, uT32 amount, uT32 jobs, const nT8 *cache_directory)
+{
+    _batch b = { .cache_directory = cache_directory };
+
+    pthread_mutex_init(&b.output, NULL);
+    pthread_mutex_init(&b.dot_mem_store.lock, NULL);
+    pthread_cond_init(&b.dot_mem_store.done, NULL);
+
+    for(uT32 i = 0; i < amount; i++)
+        add_batch_input(&b, inputs[i]);
+
+    lang_assert(b.amount, "No `.sum` files to compile.\n", no_file_given_error)
+
+    b.workers = jobs ? jobs : 1;
+    if(b.workers > b.amount) b.workers = b.amount;
+
+    b.queues = calloc(b.workers, sizeof(*b.queues));
+    _batch_worker *workers = calloc(b.workers, sizeof(*workers));
+    lang_assert(b.queues && workers,
+        "Error allocating memory for the batch.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    for(uT32 i = 0; i < b.workers; i++)
+    {
+        pthread_mutex_init(&b.queues[i].lock, NULL);
+        b.queues[i].top = (uSIZE) b.amount * i / b.workers;
+        b.queues[i].bottom = (uSIZE) b.amount * (i + 1) / b.workers;
+        workers[i] = (_batch_worker) { .batch = &b, .index = i };
+    }
+
+    uSIZE start = batch_clock();
+
+    for(uT32 i = 1; i < b.workers; i++)
+    {
+        nT32 failed = pthread_create(&workers[i].thread, NULL, run_batch_worker, &workers[i]);
+        lang_assert(failed == 0,
+            "Error starting a thread for the batch.\n\tTry rerunning with a lower `--jobs`.\n",
+            OOC_allocation_error)
+    }
+
+    /* The calling thread is a worker too. */
+    run_batch_worker(&workers[0]);
+
+    for(uT32 i = 1; i < b.workers; i++)
+        pthread_join(workers[i].thread, NULL);
+
+    print_batch_summary(&b, batch_clock() - start);
+
+    nT32 status = 0;
+    for(uT32 i = 0; i < b.amount; i++)
+    {
+        if(!(status)) status = b.files[i].status;
+        free(b.files[i].path);
+    }
+
+    for(uT32 i = 0; i < b.workers; i++)
+        pthread_mutex_destroy(&b.queues[i].lock);
+
+    destroy_dot_mem_store(&b.dot_mem_store);
+    pthread_mutex_destroy(&b.output);
+    free(workers);
+    free(b.queues);
+    free(b.files);
+
+    return status;
+}
+
+#endif
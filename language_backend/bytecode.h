@@ -0,0 +1,282 @@
+#ifndef bytecode_format
+#define bytecode_format
+
+/* Instructions of the bytecode. Each is one byte, followed by its operands(`uT32`s, see `opcode_operands`).
+ * The virtual machine(see `vm.h`) has one register, the accumulator: values are loaded into it, stored from it and printed from it.
+ * */
+enum opcodes
+{
+    op_load_number = 0x0,       // accumulator = the number at `rodata[operand]`
+    op_load_string,             // accumulator = address of the string at `rodata[operand]`
+    op_load_zero,               // accumulator = 0(the value of a variable that was not given one, strings: the empty string)
+    op_load_slot,               // accumulator = variable `operand`
+    op_store_slot,              // variable `operand` = accumulator
+    op_print_string,
+    op_print_integer,
+    op_print_hex,
+    op_print_float,             // the double printed is also the one at `rodata[operand]`(see `write_executable`)
+    op_exit,                    // end the program with status `operand`
+    op_halt,                    // end of the program, status 0
+
+    /* Superinstructions, see `optimize_bytecode`. Each does what the pair of instructions it replaces did. */
+    op_store_number,            // variable `first` = the number at `rodata[second]`
+    op_store_string,            // variable `first` = address of the string at `rodata[second]`
+    op_store_zero,              // variable `operand` = 0
+    op_print_string_constant,   // print the `second` bytes of the string at `rodata[first]`
+    op_print_integer_constant,  // print the number at `rodata[operand]`, as a decimal
+    op_print_hex_constant,      // ... as a hexadecimal number
+    op_print_float_constant,    // ... as a double
+    op_print_slot_string,       // print variable `operand`, as a string
+    op_print_slot_integer,      // ... as a decimal
+    op_print_slot_hex,          // ... as a hexadecimal number
+
+    opcode_amount
+};
+
+/* How many operands the opcode takes. */
+static const uT8 opcode_operands[opcode_amount] = {
+    [op_load_number] = 1,
+    [op_load_string] = 1,
+    [op_load_slot] = 1,
+    [op_store_slot] = 1,
+    [op_print_float] = 1,
+    [op_exit] = 1,
+    [op_store_number] = 2,
+    [op_store_string] = 2,
+    [op_store_zero] = 1,
+    [op_print_string_constant] = 2,
+    [op_print_integer_constant] = 1,
+    [op_print_hex_constant] = 1,
+    [op_print_float_constant] = 1,
+    [op_print_slot_string] = 1,
+    [op_print_slot_integer] = 1,
+    [op_print_slot_hex] = 1
+};
+
+/* Bytes an instruction with opcode `op` takes. */
+#define instruction_size(op)    (1 + opcode_operands[op] * sizeof(uT32))
+
+/* The program, as bytecode. Numbers and strings are not in it, instructions refer to them by their offset in `rodata`(see `constants.h`). */
+typedef struct bytecode
+{
+    uT8         *code;
+    uT32        size;
+    uT32        capacity;
+
+    /* Variables the program needs room for(`program_variables.amount`). */
+    uT32        slots;
+
+    /* How many instructions the program had before, and after, `optimize_bytecode`. */
+    uT32        instructions;
+    uT32        optimized_instructions;
+} _bytecode;
+
+/* The bytecode of the compilation that is running(see `context.h`). */
+#define program_bytecode    (*active_context->bytecode)
+
+/* Append an instruction to `code`(whose size and capacity are `size` and `capacity`). Operands the opcode does not take are ignored. */
+static void emit_to(uT8 **code, uT32 *size, uT32 *capacity, enum opcodes op, uT32 first, uT32 second)
+{
+    if(*size + instruction_size(op) > *capacity)
+    {
+        *capacity = *capacity ? *capacity * 2 : 0x400;
+        *code = realloc(*code, *capacity);
+        lang_assert(*code,
+            "Error allocating memory for the bytecode.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    uT32 operands[2] = { first, second };
+
+    (*code)[(*size)++] = op;
+    memcpy(&(*code)[*size], operands, opcode_operands[op] * sizeof(uT32));
+    *size += opcode_operands[op] * sizeof(uT32);
+}
+
+#define emit_instruction(op, operand)   emit_to(&program_bytecode.code, &program_bytecode.size, &program_bytecode.capacity, op, operand, 0)
+
+/* Operand `index` of the instruction at `code`. */
+static uT32 instruction_operand(const uT8 *code, uT32 index)
+{
+    uT32 operand;
+
+    memcpy(&operand, &code[1 + index * sizeof(uT32)], sizeof(operand));
+    return operand;
+}
+
+/* How a value given by operand `node` is printed. */
+static enum opcodes print_opcode(uT32 node, const uT8 *print_of_slot)
+{
+    switch(tree.kind[node])
+    {
+        case string_operand:
+        case char_operand: return op_print_string;
+        case hex_operand: return op_print_hex;
+        case float_operand: return op_print_float;
+        case variable_operand: return print_of_slot[tree.b[node]];
+        case no_operand: return tree.a[node] == Str || tree.a[node] == Char ? op_print_string : tree.a[node] == Hex ? op_print_hex : op_print_integer;
+        default: return op_print_integer;
+    }
+}
+
+/* Load the value of operand `node` into the accumulator. */
+static void emit_load(uT32 node)
+{
+    switch(tree.kind[node])
+    {
+        case string_operand:
+        case char_operand: emit_instruction(op_load_string, node_constant(node)->offset);break;
+        case integer_operand:
+        case float_operand:
+        case hex_operand: emit_instruction(op_load_number, node_constant(node)->offset);break;
+        case variable_operand: emit_instruction(op_load_slot, tree.b[node]);break;
+        default: emit_instruction(op_load_zero, 0);break;
+    }
+}
+
+/* Compile `tree` to bytecode. Like `build_constant_pool`, every run starts over.
+ * Run after `build_constant_pool`, and only on a program without errors(every variable operand has a slot).
+ *
+ * Programs have no branches, so how a variable is printed(as a string, a decimal or hexadecimal number, or a
+ * decimal) is known when the bytecode is made: it is however the value the declaration before gave it is printed.
+ * */
+void compile_bytecode()
+{
+    if(!(active_context->bytecode))
+    {
+        active_context->bytecode = calloc(1, sizeof(*active_context->bytecode));
+        lang_assert(active_context->bytecode,
+            "Error allocating memory for the bytecode.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    program_bytecode.size = 0;
+    program_bytecode.slots = program_variables.amount;
+    program_bytecode.instructions = 0;
+
+    uT8 *print_of_slot = calloc(program_variables.amount + 1, sizeof(*print_of_slot));
+    lang_assert(print_of_slot,
+        "Error allocating memory for the bytecode.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    for(uT32 node = 0; node < tree.amount; node++)
+        switch(tree.kind[node])
+        {
+            case print_statement: {
+                enum opcodes print = print_opcode(tree.a[node], print_of_slot);
+
+                emit_load(tree.a[node]);
+                emit_instruction(print, print == op_print_float ? node_constant(tree.a[node])->offset : 0);
+                program_bytecode.instructions += 2;
+                break;
+            }
+            case variable_decl: {
+                uT32 slot = variable_slot(tree.a[node]);
+
+                emit_load(tree.b[node]);
+                emit_instruction(op_store_slot, slot);
+                print_of_slot[slot] = print_opcode(tree.b[node], print_of_slot);
+                program_bytecode.instructions += 2;
+                break;
+            }
+            case exit_statement: {
+                emit_instruction(op_exit, tree.a[node]);
+                program_bytecode.instructions++;
+                break;
+            }
+            default: break;
+        }
+
+    emit_instruction(op_halt, 0);
+    program_bytecode.instructions++;
+    program_bytecode.optimized_instructions = program_bytecode.instructions;
+    free(print_of_slot);
+
+    trace(TC_ast, TL_info, "Compiled %llu nodes to %llu bytes of bytecode", tree.amount, program_bytecode.size);
+}
+
+/* The superinstruction doing what `load`, then `use`, do. `op_halt` if there is none. */
+static enum opcodes superinstruction(enum opcodes load, enum opcodes use)
+{
+    switch(load)
+    {
+        case op_load_number: {
+            switch(use)
+            {
+                case op_store_slot: return op_store_number;
+                case op_print_integer: return op_print_integer_constant;
+                case op_print_hex: return op_print_hex_constant;
+                case op_print_float: return op_print_float_constant;
+                default: return op_halt;
+            }
+        }
+        case op_load_string: return use == op_store_slot ? op_store_string : use == op_print_string ? op_print_string_constant : op_halt;
+        case op_load_zero: return use == op_store_slot ? op_store_zero : op_halt;
+        case op_load_slot: {
+            switch(use)
+            {
+                case op_print_string: return op_print_slot_string;
+                case op_print_integer: return op_print_slot_integer;
+                case op_print_hex: return op_print_slot_hex;
+                default: return op_halt;
+            }
+        }
+        default: return op_halt;
+    }
+}
+
+/* The optimizing tier: fuse every load with the instruction using the value it loaded, so a statement takes one
+ * dispatch instead of two. Declaring a variable becomes one `op_store_*`, printing a literal one `op_print_*_constant`
+ * and printing a variable one `op_print_slot_*`. Run after `compile_bytecode`.
+ * */
+void optimize_bytecode()
+{
+    uT8 *code = NULL;
+    uT32 size = 0, capacity = 0, instructions = 0;
+
+    for(uT32 at = 0; at < program_bytecode.size;)
+    {
+        const uT8 *load = &program_bytecode.code[at];
+        uT32 next = at + instruction_size(*load);
+        enum opcodes fused = next < program_bytecode.size ? superinstruction(*load, program_bytecode.code[next]) : op_halt;
+
+        instructions++;
+
+        if(fused == op_halt)
+        {
+            emit_to(&code, &size, &capacity, *load, opcode_operands[*load] ? instruction_operand(load, 0) : 0, 0);
+            at = next;
+            continue;
+        }
+
+        /* Stores take the slot first, then the value. A string is printed with its length. */
+        const uT8 *use = &program_bytecode.code[next];
+        if(*use == op_store_slot) emit_to(&code, &size, &capacity, fused, instruction_operand(use, 0), opcode_operands[*load] ? instruction_operand(load, 0) : 0);
+        else if(fused == op_print_string_constant)
+            emit_to(&code, &size, &capacity, fused, instruction_operand(load, 0), strlen(nT8_PCC &program_constants.rodata[instruction_operand(load, 0)]));
+        else emit_to(&code, &size, &capacity, fused, instruction_operand(load, 0), 0);
+
+        at = next + instruction_size(*use);
+    }
+
+    free(program_bytecode.code);
+    program_bytecode.code = code;
+    program_bytecode.size = size;
+    program_bytecode.capacity = capacity;
+    program_bytecode.optimized_instructions = instructions;
+
+    trace(TC_ast, TL_info, "Optimized %llu instructions into %llu(%llu bytes)", program_bytecode.instructions, instructions, size);
+}
+
+void destroy_bytecode()
+{
+    if(!(active_context->bytecode)) return;
+
+    free(program_bytecode.code);
+    free(active_context->bytecode);
+    active_context->bytecode = NULL;
+}
+
+#undef emit_instruction
+
+#endif
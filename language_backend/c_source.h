@@ -0,0 +1,278 @@
+#ifndef c_translation
+#define c_translation
+
+/* Statements in one function of the translated program. C compilers take far longer on one huge function than on many small ones. */
+#define c_part_statements   0x400
+
+/* What every translated program starts with: the values of variables, and prints that collect the output
+ * in `sum_output` and `write` it when it is full, or the program ends.
+ * */
+static const nT8 c_source_prelude[] =
+    "#include <errno.h>\n"
+    "#include <stdio.h>\n"
+    "#include <string.h>\n"
+    "#include <unistd.h>\n"
+    "\n"
+    "/* The value of a variable: a number, the bits of a double, or a string(NULL if it was not given one). */\n"
+    "union sum_value\n"
+    "{\n"
+    "    unsigned long long number;\n"
+    "    double decimal;\n"
+    "    const char *string;\n"
+    "};\n"
+    "\n"
+    "static char sum_output[0x10000];\n"
+    "static unsigned long sum_used;\n"
+    "static int sum_failed;\n"
+    "\n"
+    "static void sum_write(const char *bytes, unsigned long length)\n"
+    "{\n"
+    "    while(length && !sum_failed)\n"
+    "    {\n"
+    "        long written = write(1, bytes, length);\n"
+    "\n"
+    "        if(written < 0 && errno == EINTR) continue;\n"
+    "        if(written <= 0) { sum_failed = 1; break; }\n"
+    "\n"
+    "        bytes += written;\n"
+    "        length -= written;\n"
+    "    }\n"
+    "}\n"
+    "\n"
+    "static void sum_put(const char *bytes, unsigned long length)\n"
+    "{\n"
+    "    if(sum_used + length > sizeof(sum_output))\n"
+    "    {\n"
+    "        sum_write(sum_output, sum_used);\n"
+    "        sum_used = 0;\n"
+    "\n"
+    "        if(length > sizeof(sum_output)) { sum_write(bytes, length); return; }\n"
+    "    }\n"
+    "\n"
+    "    memcpy(&sum_output[sum_used], bytes, length);\n"
+    "    sum_used += length;\n"
+    "}\n"
+    "\n"
+    "static inline void sum_put_string(const char *string)\n"
+    "{\n"
+    "    if(string) sum_put(string, strlen(string));\n"
+    "    sum_put(\"\\n\", 1);\n"
+    "}\n"
+    "\n"
+    "/* Hexadecimal numbers start with `0x`, and have their digits in upper case. */\n"
+    "static inline void sum_put_number(unsigned long long value, unsigned base)\n"
+    "{\n"
+    "    char text[24];\n"
+    "    unsigned length = sizeof(text);\n"
+    "\n"
+    "    text[--length] = '\\n';\n"
+    "    do text[--length] = \"0123456789ABCDEF\"[value % base]; while(value /= base);\n"
+    "    if(base == 16) { text[--length] = 'x'; text[--length] = '0'; }\n"
+    "\n"
+    "    sum_put(&text[length], sizeof(text) - length);\n"
+    "}\n"
+    "\n"
+    "static inline void sum_put_decimal(double value)\n"
+    "{\n"
+    "    char text[32];\n"
+    "    sum_put(text, snprintf(text, sizeof(text), \"%.15g\\n\", value));\n"
+    "}\n"
+    "\n"
+    "/* Write what is left of the output. */\n"
+    "static inline int sum_exit(int status)\n"
+    "{\n"
+    "    sum_write(sum_output, sum_used);\n"
+    "    return status;\n"
+    "}\n"
+    "\n";
+
+/* Write the `length` bytes at `bytes` as the inside of a C string literal. Anything that is not printable is an
+ * octal escape of 3 digits, so no digit after it can be taken as part of it.
+ * */
+static void write_c_string(FILE *c_file, const uT8 *bytes, uT32 length)
+{
+    for(uT32 i = 0; i < length; i++)
+    {
+        uT8 c = bytes[i];
+
+        if(c == '"' || c == '\\' || c == '?') fprintf(c_file, "\\%c", c);
+        else if(c >= ' ' && c <= '~') fputc(c, c_file);
+        else fprintf(c_file, "\\%03o", c);
+    }
+}
+
+/* Write the value of operand `node` as a C expression of the member of `union sum_value` that `print` prints. */
+static void write_c_value(FILE *c_file, uT32 node, enum opcodes print)
+{
+    switch(tree.kind[node])
+    {
+        case string_operand:
+        case char_operand: {
+            fprintf(c_file, ".string = \"");
+            write_c_string(c_file, ast_string(node), tree.b[node]);
+            fprintf(c_file, "\"");
+            break;
+        }
+        case integer_operand:
+        case float_operand:
+        case hex_operand: fprintf(c_file, ".number = 0x%llXULL", ast_number(node));break;
+        default: fprintf(c_file, print == op_print_string ? ".string = 0" : ".number = 0");break;
+    }
+}
+
+/* The member of `union sum_value` that `print` prints. */
+static const nT8 *c_value_member(enum opcodes print)
+{
+    switch(print)
+    {
+        case op_print_string: return "string";
+        case op_print_float: return "decimal";
+        default: return "number";
+    }
+}
+
+/* Print `value`(a C expression of the member `c_value_member(print)`) as `print` prints it. */
+static void write_c_print(FILE *c_file, enum opcodes print, const nT8 *value)
+{
+    switch(print)
+    {
+        case op_print_string: fprintf(c_file, "    sum_put_string(%s);\n", value);break;
+        case op_print_hex: fprintf(c_file, "    sum_put_number(%s, 16);\n", value);break;
+        case op_print_float: fprintf(c_file, "    sum_put_decimal(%s);\n", value);break;
+        default: fprintf(c_file, "    sum_put_number(%s, 10);\n", value);break;
+    }
+}
+
+/* Write `tree`, and the memory layout `memory`, as one C translation unit at `path`(`source` is the file it was
+ * compiled from). Building that(e.g. `gcc -O2`) gives an executable that prints what the program prints, and exits
+ * with the status it exits with. Run after `resolve_variables`, on a program without errors.
+ *
+ * Variables are `v[slot]`, each a `union sum_value`: how one is printed is known when it is translated(see
+ * `compile_bytecode`), so every print reads the member it needs. The statements are split into functions of
+ * `c_part_statements` each, which return the status the program exits with, or -1 if it carries on.
+ *
+ * PD variables are arrays named after them, in the section the `.mem` file puts them in(see `mem_outline.h`):
+ * `T_rodata` ones are `const`, `T_data` ones with preset data are initialized(`.data`) and the rest are not(`.bss`).
+ * `T_stack_based` ones are arrays on the stack of `main`.
+ * Like `write_executable`, nothing is run at compile time: folding the program is left to the C compiler.
+ * */
+void write_c_source(const nT8 *source, _memory_info *memory, const nT8 *path)
+{
+    FILE *c_file = fopen(path, "w");
+    lang_assert(c_file,
+        "Could not write the C source `%s`.\n",
+        c_source_write_error, path)
+
+    fprintf(c_file, "/* Translated from `%s`. Build with `gcc -O2`. */\n", source);
+    fwrite(c_source_prelude, 1, sizeof(c_source_prelude) - 1, c_file);
+
+    uT32 PD_vars = memory && memory->PD_vars ? memory->PD_vars_size + 1 : 0;
+    for(uT32 i = 0; i < PD_vars; i++)
+    {
+        _predefined_variables *var = memory->PD_vars[i];
+        const uT8 *bytes = PD_var_bytes(var);
+
+        if(var->PD_var_type == T_stack_based || !(var->PD_var_size)) continue;
+
+        fprintf(c_file, "__attribute__((used)) static %sunsigned char %s[%u]",
+            var->PD_var_type == T_rodata ? "const " : "", var->PD_var_name, var->PD_var_size);
+
+        if(bytes && (var->PD_var_type == T_rodata || var->PD_var_type == T_data))
+        {
+            fprintf(c_file, " = {");
+            for(uT32 b = 0; b < var->PD_var_size; b++) fprintf(c_file, "%s0x%02X", b ? ", " : " ", bytes[b]);
+            fprintf(c_file, " }");
+        }
+        fprintf(c_file, ";\n");
+    }
+
+    if(program_variables.amount) fprintf(c_file, "%sstatic union sum_value v[%u];\n", PD_vars ? "\n" : "", program_variables.amount);
+
+    /* How each variable is printed, see `print_opcode`. */
+    uT8 *print_of_slot = calloc(program_variables.amount + 1, sizeof(*print_of_slot));
+    lang_assert(print_of_slot,
+        "Error allocating memory for the C source.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    uT32 parts = 0, statements = c_part_statements;
+    for(uT32 node = 0; node < tree.amount; node++)
+    {
+        if(tree.kind[node] != print_statement && tree.kind[node] != variable_decl && tree.kind[node] != exit_statement) continue;
+
+        if(statements == c_part_statements)
+        {
+            if(parts) fprintf(c_file, "    return -1;\n}\n");
+            fprintf(c_file, "\nstatic int sum_part_%u(void)\n{\n", parts++);
+            statements = 0;
+        }
+        statements++;
+
+        switch(tree.kind[node])
+        {
+            case print_statement: {
+                uT32 operand = tree.a[node];
+                enum opcodes print = print_opcode(operand, print_of_slot);
+                nT8 value[64];
+
+                if(tree.kind[operand] == string_operand || tree.kind[operand] == char_operand)
+                {
+                    fprintf(c_file, "    sum_put(\"");
+                    write_c_string(c_file, ast_string(operand), tree.b[operand]);
+                    fprintf(c_file, "\\n\", %u);\n", tree.b[operand] + 1);
+                    break;
+                }
+
+                if(tree.kind[operand] == variable_operand) sprintf(value, "v[%u].%s", tree.b[operand], c_value_member(print));
+                else if(tree.kind[operand] == no_operand) sprintf(value, "0");
+                else if(print == op_print_float) sprintf(value, "(union sum_value) { .number = 0x%llXULL }.decimal", ast_number(operand));
+                else sprintf(value, "0x%llXULL", ast_number(operand));
+                write_c_print(c_file, print, value);
+                break;
+            }
+            case variable_decl: {
+                uT32 slot = variable_slot(tree.a[node]);
+                uT32 operand = tree.b[node];
+                enum opcodes print = print_opcode(operand, print_of_slot);
+
+                if(tree.kind[operand] == variable_operand) fprintf(c_file, "    v[%u] = v[%u];", slot, tree.b[operand]);
+                else
+                {
+                    fprintf(c_file, "    v[%u] = (union sum_value) { ", slot);
+                    write_c_value(c_file, operand, print);
+                    fprintf(c_file, " };");
+                }
+                fprintf(c_file, "   // `%s`\n", symbol_name(tree.a[node]));
+
+                print_of_slot[slot] = print;
+                break;
+            }
+
+            /* Exit statuses are 0 to 255, which leaves -1 free. */
+            default: fprintf(c_file, "    return sum_exit(%u);\n", tree.a[node]);break;
+        }
+    }
+    if(parts) fprintf(c_file, "    return -1;\n}\n");
+    free(print_of_slot);
+
+    fprintf(c_file, "\nint main(void)\n{\n");
+    for(uT32 i = 0; i < PD_vars; i++)
+    {
+        _predefined_variables *var = memory->PD_vars[i];
+
+        if(var->PD_var_type != T_stack_based || !(var->PD_var_size)) continue;
+        fprintf(c_file, "    unsigned char %s[%u];\n    (void) %s;\n", var->PD_var_name, var->PD_var_size, var->PD_var_name);
+    }
+    if(parts) fprintf(c_file, "    int status;\n\n");
+    for(uT32 part = 0; part < parts; part++) fprintf(c_file, "    if((status = sum_part_%u()) >= 0) return status;\n", part);
+    fprintf(c_file, "    return sum_exit(0);\n}\n");
+
+    bool written = !(ferror(c_file));
+    written = fclose(c_file) == 0 && written;
+
+    trace(TC_ast, TL_info, "Translated %llu nodes to C", tree.amount);
+    lang_assert(written,
+        "Could not write the C source `%s`.\n",
+        c_source_write_error, path)
+}
+
+#endif
@@ -0,0 +1,690 @@
+#ifndef compilation_cache
+#define compilation_cache
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Where `--cache` keeps its files, unless `SUM_CACHE_DIR` says otherwise. */
+#define default_cache_directory     ".sum_cache"
+
+/* Bump whenever the layout of a cache file(or of anything it stores, e.g. `_ast_tree`) changes. */
+#define cache_format_version        4
+
+/* Part of every key, so a rebuilt compiler never picks up what an older one cached. */
+#define cache_compiler_version      "sum " __DATE__ " " __TIME__
+
+/* Sections of a cache file start on a multiple of this. */
+#define cache_alignment             0x08
+
+/* The start of a cache file.
+ * A cache file is a parsed program: the nodes of `tree`, the symbols they refer to, the `.mem` info
+ * and the files(besides the source code) the program was parsed from. Everything in it refers to
+ * everything else by offset from the start of the file, never by pointer, so it is mapped and used
+ * as it is(see `load_cached_program`).
+ * */
+typedef struct cache_header
+{
+    uT8         magic[4];
+    uT32        format;
+
+    /* Hash of the rest of the file(from `key` on), so a file that was damaged is never used. */
+    uSIZE       checksum;
+
+    /* Hash of `cache_compiler_version` and the source code, the file is named after it. */
+    uSIZE       key;
+
+    /* Size of the whole file. */
+    uSIZE       size;
+
+    uT32        nodes;
+    uT32        strings_size;
+    uT32        state;
+    uT32        symbol_amount;
+    uT32        symbol_slot_mask;
+    uT32        dependencies;
+    uSIZE       symbol_arena_size;
+
+    /* Offsets of the sections. */
+    uSIZE       kind;
+    uSIZE       a;
+    uSIZE       b;
+    uSIZE       span_start;
+    uSIZE       span_length;
+    uSIZE       strings;
+    uSIZE       symbol_arena;
+    uSIZE       symbol_names;
+    uSIZE       symbol_lengths;
+    uSIZE       symbol_slots;
+    uSIZE       dependency_list;
+    uSIZE       memory_info;
+} _cache_header;
+
+/* Where the part of a cache file `checksum` covers starts. */
+#define cache_checksum_start        offsetof(_cache_header, key)
+
+/* A file the program was parsed from. Followed by its path(`\0` terminated). */
+typedef struct cached_dependency
+{
+    uSIZE       hash;
+    uT32        path_length;
+    uT32        size;
+} _cached_dependency;
+
+/* `_memory_info`, followed by its PD variables. */
+typedef struct cached_memory_info
+{
+    uT32        total_memory;
+    uT32        mem_in_bytes;
+    float       mem_in_MB;
+    float       mem_in_GB;
+    uT32        mem_type;
+    uT32        PD_vars;
+    bool        stack_access;
+    bool        require_initialized_variables;
+} _cached_memory_info;
+
+/* A PD variable. Followed by its name(`\0` terminated) and, if `data_size` is not 0, its data. */
+typedef struct cached_PD_var
+{
+    uT32        name_length;
+    uT32        size;
+    uT32        type;
+    uT32        data_size;
+
+    /* The data when it is held in `PD_var_data` itself(`data_size` is 0). */
+    uSIZE       value;
+} _cached_PD_var;
+
+/* XXH64. */
+#define hash_prime_1    0x9E3779B185EBCA87ULL
+#define hash_prime_2    0xC2B2AE3D27D4EB4FULL
+#define hash_prime_3    0x165667B19E3779F9ULL
+#define hash_prime_4    0x85EBCA77C2B2AE63ULL
+#define hash_prime_5    0x27D4EB2F165667C5ULL
+
+#define hash_rotate(x, r)   (((x) << (r)) | ((x) >> (64 - (r))))
+
+static inline uSIZE hash_round(uSIZE accumulator, uSIZE input)
+{
+    accumulator += input * hash_prime_2;
+    return hash_rotate(accumulator, 31) * hash_prime_1;
+}
+
+static inline uSIZE hash_read64(const uT8 *p)
+{
+    uSIZE value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uSIZE hash_read32(const uT8 *p)
+{
+    uT32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/* 64-bit hash of the `size` bytes at `data`, 32 bytes at a time. */
+uSIZE hash_bytes(const uT8 *data, uSIZE size, uSIZE seed)
+{
+    const uT8 *p = data, *end = data + size;
+    uSIZE h;
+
+    if(size >= 32)
+    {
+        uSIZE v1 = seed + hash_prime_1 + hash_prime_2, v2 = seed + hash_prime_2, v3 = seed, v4 = seed - hash_prime_1;
+
+        for(; p + 32 <= end; p += 32)
+        {
+            v1 = hash_round(v1, hash_read64(p));
+            v2 = hash_round(v2, hash_read64(p + 8));
+            v3 = hash_round(v3, hash_read64(p + 16));
+            v4 = hash_round(v4, hash_read64(p + 24));
+        }
+
+        h = hash_rotate(v1, 1) + hash_rotate(v2, 7) + hash_rotate(v3, 12) + hash_rotate(v4, 18);
+        h = (h ^ hash_round(0, v1)) * hash_prime_1 + hash_prime_4;
+        h = (h ^ hash_round(0, v2)) * hash_prime_1 + hash_prime_4;
+        h = (h ^ hash_round(0, v3)) * hash_prime_1 + hash_prime_4;
+        h = (h ^ hash_round(0, v4)) * hash_prime_1 + hash_prime_4;
+    }
+    else h = seed + hash_prime_5;
+
+    h += size;
+
+    for(; p + 8 <= end; p += 8)
+        h = hash_rotate(h ^ hash_round(0, hash_read64(p)), 27) * hash_prime_1 + hash_prime_4;
+    if(p + 4 <= end)
+    {
+        h = hash_rotate(h ^ (hash_read32(p) * hash_prime_1), 23) * hash_prime_2 + hash_prime_3;
+        p += 4;
+    }
+    for(; p < end; p++)
+        h = hash_rotate(h ^ (*p * hash_prime_5), 11) * hash_prime_1;
+
+    h ^= h >> 33;
+    h *= hash_prime_2;
+    h ^= h >> 29;
+    h *= hash_prime_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+/* Key of the cache file for `source`.
+ * A `module`(a file pulled in by `#include`) is parsed under the `.mem` file of the program including it,
+ * and `require_initialized_variables` is all of it the parser looks at, so that is part of its key.
+ * */
+static uSIZE cache_key(_source_buffer *source, bool module)
+{
+    uSIZE seed = hash_bytes(uT8_PCC cache_compiler_version, strlen(cache_compiler_version), cache_format_version);
+    if(module) seed = hash_bytes(uT8_PCC &program_memory_info->require_initialized_variables, 1, seed + 1);
+
+    return hash_bytes(source->data, source->size, seed);
+}
+
+/* `directory/key.sumc`, on the heap. */
+static nT8 *cache_path(const nT8 *directory, uSIZE key)
+{
+    nT8 *path = malloc(strlen(directory) + 32);
+    lang_assert(path,
+        "Error allocating memory for the path of a cache file.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    sprintf(path, "%s/%016llx.sumc", directory, key);
+    return path;
+}
+
+/* Hash of the file at `path`, false if it cannot be read. */
+static bool hash_file(const nT8 *path, uSIZE *hash, uSIZE *size)
+{
+    _source_buffer *file = init_source_buffer(nT8_PC path);
+    if(!(file)) return false;
+
+    *hash = hash_bytes(file->data, file->size, 0);
+    *size = file->size;
+
+    destroy_source_buffer(file);
+    return true;
+}
+
+/* A cache file while it is put together. */
+typedef struct cache_writer
+{
+    uT8         *data;
+    uSIZE       size;
+    uSIZE       capacity;
+} _cache_writer;
+
+/* Append `size` bytes to `w`, on a multiple of `cache_alignment`. Returns their offset. */
+static uSIZE cache_put(_cache_writer *w, const void *data, uSIZE size)
+{
+    uSIZE offset = (w->size + cache_alignment - 1) & ~((uSIZE) cache_alignment - 1);
+
+    if(offset + size > w->capacity)
+    {
+        while(offset + size > w->capacity) w->capacity = w->capacity ? w->capacity * 2 : 0x10000;
+
+        w->data = realloc(w->data, w->capacity);
+        lang_assert(w->data,
+            "Error allocating memory for a cache file.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    memset(&w->data[w->size], 0, offset - w->size);
+    if(size) memcpy(&w->data[offset], data, size);
+    w->size = offset + size;
+
+    return offset;
+}
+
+static void cache_put_memory_info(_cache_writer *w)
+{
+    _memory_info *info = program_memory_info;
+    uT32 PD_vars = info->PD_vars ? info->PD_vars_size + 1 : 0;
+
+    _cached_memory_info cached = {
+        .total_memory = info->total_memory,
+        .mem_in_bytes = info->mem_in_bytes,
+        .mem_in_MB = info->mem_in_MB,
+        .mem_in_GB = info->mem_in_GB,
+        .mem_type = info->mem_type,
+        .PD_vars = PD_vars,
+        .stack_access = info->stack_access,
+        .require_initialized_variables = info->require_initialized_variables
+    };
+    cache_put(w, &cached, sizeof(cached));
+
+    for(uT32 i = 0; i < PD_vars; i++)
+    {
+        _predefined_variables *var = info->PD_vars[i];
+        const uT8 *name = var->PD_var_name ? var->PD_var_name : uT8_PCC "";
+
+        /* Only byte arrays keep their data behind a pointer(see `assign_PD_var_value_byte`). */
+        bool pointer = var->PD_var_size > 1 && var->PD_var_data.ptr_byte_data;
+
+        _cached_PD_var cached_var = {
+            .name_length = strlen(nT8_PCC name),
+            .size = var->PD_var_size,
+            .type = var->PD_var_type,
+            .data_size = pointer ? var->PD_var_size : 0
+        };
+        if(!(pointer)) memcpy(&cached_var.value, &var->PD_var_data, sizeof(cached_var.value));
+
+        cache_put(w, &cached_var, sizeof(cached_var));
+        cache_put(w, name, cached_var.name_length + 1);
+        if(pointer) cache_put(w, var->PD_var_data.ptr_byte_data, cached_var.data_size);
+    }
+}
+
+/* Write the parsed program of `active_context` to the cache, for `load_cached_program` to find next time.
+ * Only programs without errors are cached. The file is written under another name and renamed into
+ * place, so a compilation running at the same time never maps half a file.
+ * A `module` is cached without the `.mem` info, it is not its own(see `cache_key`).
+ * */
+void store_cached_program(_source_buffer *source, const nT8 *directory, bool module)
+{
+    if(source->streaming || active_context->diagnostics.amount) return;
+
+    _cache_writer w = { 0 };
+    _cache_header header = { .magic = { 'S', 'U', 'M', 'C' }, .format = cache_format_version };
+
+    cache_put(&w, &header, sizeof(header));
+
+    header.key = cache_key(source, module);
+    header.nodes = tree.amount;
+    header.strings_size = tree.strings_size;
+    header.state = tree.state;
+    header.kind = cache_put(&w, tree.kind, tree.amount * sizeof(*tree.kind));
+    header.a = cache_put(&w, tree.a, tree.amount * sizeof(*tree.a));
+    header.b = cache_put(&w, tree.b, tree.amount * sizeof(*tree.b));
+    header.span_start = cache_put(&w, tree.span_start, tree.amount * sizeof(*tree.span_start));
+    header.span_length = cache_put(&w, tree.span_length, tree.amount * sizeof(*tree.span_length));
+    header.strings = cache_put(&w, tree.strings, tree.strings_size);
+
+    if(symbol_table)
+    {
+        header.symbol_amount = symbol_table->amount;
+        header.symbol_slot_mask = symbol_table->slot_mask;
+        header.symbol_arena_size = symbol_table->arena_size;
+        header.symbol_arena = cache_put(&w, symbol_table->arena, symbol_table->arena_size);
+        header.symbol_names = cache_put(&w, symbol_table->names, symbol_table->amount * sizeof(*symbol_table->names));
+        header.symbol_lengths = cache_put(&w, symbol_table->lengths, symbol_table->amount * sizeof(*symbol_table->lengths));
+        header.symbol_slots = cache_put(&w, symbol_table->slots, (symbol_table->slot_mask + 1) * sizeof(*symbol_table->slots));
+    }
+
+    header.dependencies = active_context->dependency_amount;
+    header.dependency_list = w.size;
+    for(uT32 i = 0; i < active_context->dependency_amount; i++)
+    {
+        _cached_dependency dependency = { .path_length = strlen(active_context->dependencies[i]) };
+        uSIZE size;
+
+        if(!(hash_file(active_context->dependencies[i], &dependency.hash, &size)))
+        {
+            free(w.data);
+            return;
+        }
+        dependency.size = size;
+
+        cache_put(&w, &dependency, sizeof(dependency));
+        cache_put(&w, active_context->dependencies[i], dependency.path_length + 1);
+    }
+
+    if(!(module))
+    {
+        header.memory_info = cache_put(&w, NULL, 0);
+        cache_put_memory_info(&w);
+    }
+
+    header.size = w.size;
+    memcpy(w.data, &header, sizeof(header));
+
+    header.checksum = hash_bytes(&w.data[cache_checksum_start], w.size - cache_checksum_start, cache_format_version);
+    memcpy(w.data, &header, sizeof(header));
+
+    /* Not being able to cache is not an error, the program just gets parsed again next time. */
+    mkdir(directory, 0755);
+
+    nT8 *path = cache_path(directory, header.key);
+    nT8 *temporary = malloc(strlen(path) + 24);
+    lang_assert(temporary,
+        "Error allocating memory for the path of a cache file.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+    sprintf(temporary, "%s.%d", path, (nT32) getpid());
+
+    nT32 fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd >= 0)
+    {
+        uSIZE written = 0;
+
+        while(written < w.size)
+        {
+            ssize_t amount = write(fd, &w.data[written], w.size - written);
+            if(amount <= 0 && errno != EINTR) break;
+            if(amount > 0) written += amount;
+        }
+
+        close(fd);
+        if(written == w.size && rename(temporary, path) == 0)
+        {
+            trace(TC_ast, TL_info, "Cached %llu nodes, %llu bytes", tree.amount, w.size);
+        }
+        else
+        {
+            unlink(temporary);
+        }
+    }
+
+    free(temporary);
+    free(path);
+    free(w.data);
+}
+
+/* Is [`offset`, `offset + size`) inside a mapping of `mapping_size` bytes, on a multiple of `cache_alignment`? */
+static inline bool cache_section_fits(uSIZE offset, uSIZE size, uSIZE mapping_size)
+{
+    return !(offset & (cache_alignment - 1)) && offset <= mapping_size && size <= mapping_size - offset;
+}
+
+/* Check every reference in the nodes and symbols of the cache file points at something that is there:
+ * operands before the statements using them, strings and symbols that exist, and spans inside `source_size`
+ * bytes of source code. The checksum already catches a damaged file, this makes sure nothing in a file
+ * that got past it(or was written wrong) is ever read out of bounds.
+ * */
+static bool check_cached_tree(const uT8 *mapping, _cache_header *header, uSIZE source_size)
+{
+    const uT8 *kind = &mapping[header->kind];
+    const uT32 *a = (const uT32 *) &mapping[header->a];
+    const uT32 *b = (const uT32 *) &mapping[header->b];
+    const uSIZE *span_start = (const uSIZE *) &mapping[header->span_start];
+    const uT32 *span_length = (const uT32 *) &mapping[header->span_length];
+    const uT8 *strings = &mapping[header->strings];
+
+    if(header->state < stuck || header->state > adding_exit_statement) return false;
+    if(header->strings_size && strings[header->strings_size - 1]) return false;
+
+    for(uT32 node = 0; node < header->nodes; node++)
+    {
+        if(span_start[node] > source_size || span_length[node] > source_size - span_start[node]) return false;
+
+        switch(kind[node])
+        {
+            case print_statement: {
+                if(a[node] >= node || kind[a[node]] < string_operand) return false;
+                break;
+            }
+            case variable_decl: {
+                if(a[node] >= header->symbol_amount || b[node] >= node || kind[b[node]] < string_operand) return false;
+                break;
+            }
+            case exit_statement: {
+                if(a[node] > 0xFF) return false;
+                break;
+            }
+            case include_statement: {
+                if(a[node] >= header->strings_size) return false;
+                if(b[node] != include_pending && b[node] != include_repeated && b[node] >= header->nodes - node) return false;
+                break;
+            }
+            case char_operand:
+            case string_operand: {
+                /* A character is kept like a one-character string. */
+                if(kind[node] == char_operand && b[node] != 1) return false;
+                if((uSIZE) a[node] + b[node] >= header->strings_size || strings[a[node] + b[node]]) return false;
+                break;
+            }
+            case variable_operand: {
+                if(a[node] >= header->symbol_amount) return false;
+                break;
+            }
+            case no_operand: {
+                if(a[node] < Char || a[node] > Hex) return false;
+                break;
+            }
+            case integer_operand:
+            case float_operand:
+            case hex_operand: break;
+            default: return false;
+        }
+    }
+
+    if(!(header->symbol_amount)) return true;
+
+    /* The hash table is a power of two in size, and at most half full(see `grow_symbol_slots`), so a lookup always ends. */
+    const nT8 *arena = nT8_PCC &mapping[header->symbol_arena];
+    const uSIZE *names = (const uSIZE *) &mapping[header->symbol_names];
+    const uT32 *lengths = (const uT32 *) &mapping[header->symbol_lengths];
+    const uT32 *slots = (const uT32 *) &mapping[header->symbol_slots];
+    uT32 used = 0;
+
+    if(header->symbol_slot_mask & (header->symbol_slot_mask + (uSIZE) 1) || (uSIZE) header->symbol_amount * 2 > header->symbol_slot_mask) return false;
+
+    for(uT32 id = 0; id < header->symbol_amount; id++)
+        if(names[id] >= header->symbol_arena_size || lengths[id] >= header->symbol_arena_size - names[id] || arena[names[id] + lengths[id]]) return false;
+
+    for(uSIZE slot = 0; slot <= header->symbol_slot_mask; slot++)
+    {
+        if(slots[slot] > header->symbol_amount) return false;
+        if(slots[slot]) used++;
+    }
+
+    return used == header->symbol_amount;
+}
+
+/* Check every dependency of the cache file is still what the program was parsed from.
+ * Returns where the dependencies end, or 0 if one changed.
+ * */
+static uSIZE check_cached_dependencies(const uT8 *mapping, _cache_header *header)
+{
+    uSIZE offset = header->dependency_list;
+
+    for(uT32 i = 0; i < header->dependencies; i++)
+    {
+        offset = (offset + cache_alignment - 1) & ~((uSIZE) cache_alignment - 1);
+        if(!(cache_section_fits(offset, sizeof(_cached_dependency), header->size))) return 0;
+
+        const _cached_dependency *dependency = (const _cached_dependency *) &mapping[offset];
+        offset += sizeof(*dependency);
+        offset = (offset + cache_alignment - 1) & ~((uSIZE) cache_alignment - 1);
+        if(!(cache_section_fits(offset, dependency->path_length + 1, header->size)) || mapping[offset + dependency->path_length]) return 0;
+
+        uSIZE hash, size;
+        if(!(hash_file(nT8_PCC &mapping[offset], &hash, &size)) || size != dependency->size || hash != dependency->hash) return 0;
+
+        add_dependency(nT8_PCC &mapping[offset]);
+        offset += dependency->path_length + 1;
+    }
+
+    return offset;
+}
+
+/* Set `program_memory_info` from the cache file. False if the file is cut short. */
+static bool load_cached_memory_info(const uT8 *mapping, _cache_header *header)
+{
+    uSIZE offset = header->memory_info;
+    if(!(cache_section_fits(offset, sizeof(_cached_memory_info), header->size))) return false;
+
+    const _cached_memory_info *cached = (const _cached_memory_info *) &mapping[offset];
+    _memory_info *info = program_memory_info;
+
+    if(cached->mem_type > GB) return false;
+
+    info->total_memory = cached->total_memory;
+    info->mem_in_bytes = cached->mem_in_bytes;
+    info->mem_in_MB = cached->mem_in_MB;
+    info->mem_in_GB = cached->mem_in_GB;
+    info->mem_type = cached->mem_type;
+    info->stack_access = cached->stack_access;
+    info->require_initialized_variables = cached->require_initialized_variables;
+    offset += sizeof(*cached);
+
+    for(uT32 i = 0; i < cached->PD_vars; i++)
+    {
+        offset = (offset + cache_alignment - 1) & ~((uSIZE) cache_alignment - 1);
+        if(!(cache_section_fits(offset, sizeof(_cached_PD_var), header->size))) return false;
+
+        const _cached_PD_var *var = (const _cached_PD_var *) &mapping[offset];
+        offset = (offset + sizeof(*var) + cache_alignment - 1) & ~((uSIZE) cache_alignment - 1);
+        if(!(cache_section_fits(offset, var->name_length + 1, header->size)) || mapping[offset + var->name_length]) return false;
+
+        /* Only byte arrays have their data after them, anything else fits in `value`(see `PD_var_bytes`). */
+        if(var->type < T_data || var->type > T_stack_based) return false;
+        if(var->data_size ? var->data_size != var->size || var->size < 2 : var->size > 1 && var->value) return false;
+
+        if(!(info->PD_vars)) try_init_PD_vars();
+        else create_next_PD_var_element();
+
+        _predefined_variables *loaded = info->PD_vars[info->PD_vars_size];
+        loaded->PD_var_name = front_end_copy(&mapping[offset], var->name_length);
+        loaded->PD_var_size = var->size;
+        loaded->PD_var_type = var->type;
+        offset += var->name_length + 1;
+
+        if(!(var->data_size))
+        {
+            memcpy(&loaded->PD_var_data, &var->value, sizeof(var->value));
+            continue;
+        }
+
+        offset = (offset + cache_alignment - 1) & ~((uSIZE) cache_alignment - 1);
+        if(!(cache_section_fits(offset, var->data_size, header->size))) return false;
+
+        loaded->PD_var_data.ptr_byte_data = front_end_copy(&mapping[offset], var->data_size);
+        offset += var->data_size;
+    }
+
+    return true;
+}
+
+/* Look `source` up in the cache. If it is there(and everything it depends on is unchanged), `tree` and
+ * `symbol_table` are pointed straight into the mapped file and the `.mem` info is set from it, so there
+ * is nothing left to lex or parse. Returns false if the program has to be parsed: it is not in the cache,
+ * something it depends on changed, or the file does not check out(see `check_cached_tree`).
+ * A `module` leaves the `.mem` info alone(see `store_cached_program`).
+ * */
+bool load_cached_program(_source_buffer *source, const nT8 *directory, bool module)
+{
+    if(source->streaming) return false;
+
+    uSIZE key = cache_key(source, module);
+    nT8 *path = cache_path(directory, key);
+    nT32 fd = open(path, O_RDONLY);
+    free(path);
+
+    if(fd < 0) return false;
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || (uSIZE) info.st_size < sizeof(_cache_header))
+    {
+        close(fd);
+        return false;
+    }
+
+    /* Private, so `resolve_variables` can write the slots of variable operands without touching the file. */
+    uT8 *mapping = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(mapping == MAP_FAILED) return false;
+
+    _cache_header *header = (_cache_header *) mapping;
+    uSIZE size = info.st_size;
+
+    bool usable = memcmp(header->magic, "SUMC", 4) == 0 && header->format == cache_format_version &&
+                  header->key == key && header->size == size &&
+                  header->checksum == hash_bytes(&mapping[cache_checksum_start], size - cache_checksum_start, cache_format_version) &&
+                  cache_section_fits(header->kind, header->nodes * sizeof(*tree.kind), size) &&
+                  cache_section_fits(header->a, header->nodes * sizeof(*tree.a), size) &&
+                  cache_section_fits(header->b, header->nodes * sizeof(*tree.b), size) &&
+                  cache_section_fits(header->span_start, header->nodes * sizeof(*tree.span_start), size) &&
+                  cache_section_fits(header->span_length, header->nodes * sizeof(*tree.span_length), size) &&
+                  cache_section_fits(header->strings, header->strings_size, size) &&
+                  cache_section_fits(header->symbol_arena, header->symbol_arena_size, size) &&
+                  cache_section_fits(header->symbol_names, header->symbol_amount * sizeof(uSIZE), size) &&
+                  cache_section_fits(header->symbol_lengths, header->symbol_amount * sizeof(uT32), size) &&
+                  (!(header->symbol_amount) || cache_section_fits(header->symbol_slots, (header->symbol_slot_mask + (uSIZE) 1) * sizeof(uT32), size)) &&
+                  check_cached_tree(mapping, header, source->size) &&
+                  check_cached_dependencies(mapping, header);
+
+    /* The `.mem` info is loaded last, so it is all that has to be taken back if it does not check out. There is none
+     * before(the parser reads `.mem` files), so `PD_vars` is the loader's own.
+     * */
+    if(usable && !(module))
+    {
+        _memory_info memory_before = *program_memory_info;
+        _arena_mark arena_before = arena_mark(front_end_arena);
+
+        usable = load_cached_memory_info(mapping, header);
+        if(!(usable))
+        {
+            if(program_memory_info->PD_vars != memory_before.PD_vars) free(program_memory_info->PD_vars);
+            *program_memory_info = memory_before;
+            arena_rewind(front_end_arena, arena_before);
+        }
+    }
+
+    if(!(usable))
+    {
+        /* Undo what was loaded before the file turned out to be stale, the program gets parsed instead. */
+        for(uT32 i = 0; i < active_context->dependency_amount; i++) free(active_context->dependencies[i]);
+        active_context->dependency_amount = 0;
+
+        munmap(mapping, size);
+        return false;
+    }
+
+    free_ast_tree(&tree);
+    tree = (_ast_tree) {
+        .kind = &mapping[header->kind],
+        .a = (uT32 *) &mapping[header->a],
+        .b = (uT32 *) &mapping[header->b],
+        .span_start = (uSIZE *) &mapping[header->span_start],
+        .span_length = (uT32 *) &mapping[header->span_length],
+        .amount = header->nodes,
+        .capacity = header->nodes,
+        .strings = &mapping[header->strings],
+        .strings_size = header->strings_size,
+        .strings_capacity = header->strings_size,
+        .state = header->state,
+        .mapped = true
+    };
+
+    if(header->symbol_amount)
+    {
+        destroy_symbol_table();
+        symbol_table = calloc(1, sizeof(*symbol_table));
+        lang_assert(symbol_table,
+            "Error allocating memory for the symbol table.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+
+        *symbol_table = (_symbol_table) {
+            .arena = nT8_PC &mapping[header->symbol_arena],
+            .arena_size = header->symbol_arena_size,
+            .arena_capacity = header->symbol_arena_size,
+            .names = (uSIZE *) &mapping[header->symbol_names],
+            .lengths = (uT32 *) &mapping[header->symbol_lengths],
+            .amount = header->symbol_amount,
+            .capacity = header->symbol_amount,
+            .slots = (uT32 *) &mapping[header->symbol_slots],
+            .slot_mask = header->symbol_slot_mask,
+            .mapped = true
+        };
+    }
+
+    active_context->cache_mapping = mapping;
+    active_context->cache_mapping_size = size;
+
+    trace(TC_ast, TL_info, "Loaded %llu nodes from the cache", tree.amount);
+    return true;
+}
+
+/* Unmap the cache file of the compilation, once nothing points into it. */
+void release_cached_program()
+{
+    if(!(active_context->cache_mapping)) return;
+
+    munmap(active_context->cache_mapping, active_context->cache_mapping_size);
+    active_context->cache_mapping = NULL;
+}
+
+#endif
@@ -0,0 +1,339 @@
+#ifndef constant_pooling
+#define constant_pooling
+
+/* Constant that does not exist(e.g. the value of a variable that was never given one). */
+#define no_constant     0xFFFFFFFF
+
+/* Numbers take this many bytes in `rodata`, whatever their kind. */
+#define constant_number_size    0x08
+
+enum constant_kinds
+{
+    number_constant,            // integers, hexadecimal numbers and the bits of doubles
+    string_constant
+};
+
+/* A constant in `rodata`. */
+typedef struct constant
+{
+    enum constant_kinds     kind;
+
+    /* Where it is in `rodata`, and how many bytes it takes(strings: not counting the `\0` after them). */
+    uT32        offset;
+    uT32        length;
+
+    uT32        hash;
+
+    /* The value while the pool is built: the number itself, or the offset of the string in `tree.strings`. */
+    uSIZE       value;
+} _constant;
+
+/* Every literal of the program, each distinct one once, laid out the way it goes in the program's
+ * `.rodata`(what `T_rodata` in `mem_outline.h` stands for).
+ *
+ * Numbers come first, `constant_number_size` bytes each so they stay aligned, then the strings, back
+ * to back and `\0` terminated. Operand nodes refer to their constant through `constant_of_node`.
+ * A variable operand is folded into the constant the variable holds when it is read: programs have
+ * no branches, so that is always the value of the declaration before it.
+ * */
+typedef struct constant_pool
+{
+    uT8         *rodata;
+    uT32        rodata_size;
+    uT32        rodata_capacity;
+
+    _constant   *entries;
+    uT32        amount;
+    uT32        capacity;
+
+    /* Open addressing hash table of `index + 1`(0 is an empty slot), like the one of `symbols.h`. */
+    uT32        *slots;
+    uT32        slot_mask;
+
+    /* `constant_of_node[node]` is the constant operand `node` stands for, `no_constant` for every other node. */
+    uT32        *constant_of_node;
+    uT32        nodes_capacity;
+
+    /* Literal operands that were pooled, and how many of their bytes pooling saved. */
+    uT32        literals;
+    uSIZE       bytes_saved;
+} _constant_pool;
+
+/* The constants of the compilation that is running(see `context.h`). */
+#define program_constants   (*active_context->constants)
+
+/* Hash of a constant, its kind is part of it so a number never matches a string. */
+static uT32 constant_hash(enum constant_kinds kind, const uT8 *bytes, uT32 length)
+{
+    return symbol_hash(bytes, length) ^ (kind * 0x9E3779B9);
+}
+
+/* The bytes of constant `c`, while the pool is being built. */
+static const uT8 *constant_bytes(_constant *c)
+{
+    return c->kind == string_constant ? &tree.strings[c->value] : (const uT8 *) &c->value;
+}
+
+/* Bytes constant `c` takes in `rodata`. */
+static uT32 constant_size(_constant *c)
+{
+    return c->kind == string_constant ? c->length + 1 : constant_number_size;
+}
+
+/* Put constants [0, `program_constants.amount`) in the hash table `slots`. */
+static void hash_constants(uT32 *slots, uT32 slot_mask)
+{
+    for(uT32 i = 0; i < program_constants.amount; i++)
+    {
+        uT32 slot = program_constants.entries[i].hash & slot_mask;
+
+        while(slots[slot]) slot = (slot + 1) & slot_mask;
+        slots[slot] = i + 1;
+    }
+}
+
+/* Double the hash table, keeping it at most half full. */
+static void grow_constant_slots()
+{
+    uT32 slot_mask = program_constants.slot_mask ? (program_constants.slot_mask << 1) | 1 : 0x3FF;
+    uT32 *slots = calloc(slot_mask + 1, sizeof(*slots));
+    lang_assert(slots,
+        "Error allocating memory for the constant pool.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    hash_constants(slots, slot_mask);
+
+    free(program_constants.slots);
+    program_constants.slots = slots;
+    program_constants.slot_mask = slot_mask;
+}
+
+/* Index of the constant with the `length` bytes at `bytes`, added if it is new.
+ * `value` is kept to find the bytes again(see `constant_bytes`).
+ * */
+static uT32 pool_constant(enum constant_kinds kind, const uT8 *bytes, uT32 length, uSIZE value)
+{
+    uT32 hash = constant_hash(kind, bytes, length);
+    uT32 slot = hash & program_constants.slot_mask;
+
+    program_constants.literals++;
+
+    for(; program_constants.slots[slot]; slot = (slot + 1) & program_constants.slot_mask)
+    {
+        _constant *c = &program_constants.entries[program_constants.slots[slot] - 1];
+
+        if(c->hash == hash && c->kind == kind && c->length == length && memcmp(constant_bytes(c), bytes, length) == 0)
+        {
+            program_constants.bytes_saved += constant_size(c);
+            return program_constants.slots[slot] - 1;
+        }
+    }
+
+    if(program_constants.amount == program_constants.capacity)
+    {
+        program_constants.capacity = program_constants.capacity ? program_constants.capacity * 2 : 0x100;
+        program_constants.entries = realloc(program_constants.entries, program_constants.capacity * sizeof(*program_constants.entries));
+        lang_assert(program_constants.entries,
+            "Error allocating memory for the constant pool.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    uT32 index = program_constants.amount++;
+    program_constants.entries[index] = (_constant) {
+        .kind = kind,
+        .length = length,
+        .hash = hash,
+        .value = value
+    };
+
+    program_constants.slots[slot] = index + 1;
+    if(program_constants.amount * 2 > program_constants.slot_mask) grow_constant_slots();
+
+    return index;
+}
+
+/* Give every constant its place in `rodata`, and copy it there. */
+static void lay_out_rodata()
+{
+    uSIZE size = 0;
+
+    for(uT32 i = 0; i < program_constants.amount; i++)
+        if(program_constants.entries[i].kind == number_constant) size += constant_number_size;
+
+    uSIZE strings_start = size;
+    for(uT32 i = 0; i < program_constants.amount; i++)
+        if(program_constants.entries[i].kind == string_constant) size += program_constants.entries[i].length + 1;
+
+    lang_assert(size <= 0xFFFFFFFF,
+        "The constants of the program are larger than 4GB.\n",
+        OOC_allocation_error)
+
+    if(size > program_constants.rodata_capacity)
+    {
+        program_constants.rodata = realloc(program_constants.rodata, size);
+        lang_assert(program_constants.rodata,
+            "Error allocating memory for the constant pool.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+        program_constants.rodata_capacity = size;
+    }
+
+    uT32 numbers = 0, strings = strings_start;
+    for(uT32 i = 0; i < program_constants.amount; i++)
+    {
+        _constant *c = &program_constants.entries[i];
+
+        if(c->kind == number_constant)
+        {
+            c->offset = numbers;
+            memcpy(&program_constants.rodata[numbers], &c->value, constant_number_size);
+            numbers += constant_number_size;
+            continue;
+        }
+
+        c->offset = strings;
+        memcpy(&program_constants.rodata[strings], &tree.strings[c->value], c->length);
+        program_constants.rodata[strings + c->length] = '\0';
+        strings += c->length + 1;
+    }
+
+    program_constants.rodata_size = size;
+}
+
+/* Pool the nodes of `tree` from `first` on again(see `build_constant_pool`), keeping the constants of the
+ * nodes before it. For when those nodes did not change(see `apply_edit`).
+ * Run after `resolve_variables_from` with the same `first`.
+ * */
+void build_constant_pool_from(uT32 first)
+{
+    if(!(active_context->constants))
+    {
+        active_context->constants = calloc(1, sizeof(*active_context->constants));
+        lang_assert(active_context->constants,
+            "Error allocating memory for the constant pool.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+        first = 0;
+    }
+
+    if(tree.amount > program_constants.nodes_capacity)
+    {
+        program_constants.constant_of_node = realloc(program_constants.constant_of_node, tree.amount * sizeof(*program_constants.constant_of_node));
+        lang_assert(program_constants.constant_of_node,
+            "Error allocating memory for the constant pool.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+        program_constants.nodes_capacity = tree.amount;
+    }
+
+    /* What each variable holds at the node being looked at. */
+    uT32 *constant_of_slot = malloc(program_variables.amount * sizeof(*constant_of_slot) + 1);
+    lang_assert(constant_of_slot,
+        "Error allocating memory for the constant pool.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+    memset(constant_of_slot, 0xFF, program_variables.amount * sizeof(*constant_of_slot));
+
+    /* Constants are added in the order of the nodes, so the ones the nodes before `first` added come first.
+     * Those are kept, along with what the variables hold after those nodes.
+     * */
+    uT32 kept = 0;
+    uSIZE literal_bytes = 0;
+    program_constants.literals = 0;
+
+    for(uT32 node = 0; node < first; node++)
+    {
+        uT32 constant = program_constants.constant_of_node[node];
+
+        if(tree.kind[node] == variable_decl)
+        {
+            uT32 slot = variable_slot(tree.a[node]);
+            if(slot != no_slot) constant_of_slot[slot] = program_constants.constant_of_node[tree.b[node]];
+        }
+
+        if(constant == no_constant || tree.kind[node] == variable_operand) continue;
+
+        program_constants.literals++;
+        literal_bytes += constant_size(&program_constants.entries[constant]);
+        if(constant >= kept) kept = constant + 1;
+    }
+
+    program_constants.amount = kept;
+    program_constants.bytes_saved = literal_bytes;
+    for(uT32 i = 0; i < kept; i++) program_constants.bytes_saved -= constant_size(&program_constants.entries[i]);
+
+    if(!(program_constants.slots)) grow_constant_slots();
+    else
+    {
+        memset(program_constants.slots, 0, (program_constants.slot_mask + 1) * sizeof(*program_constants.slots));
+        hash_constants(program_constants.slots, program_constants.slot_mask);
+    }
+
+    for(uT32 node = first; node < tree.amount; node++)
+    {
+        uT32 constant = no_constant;
+
+        switch(tree.kind[node])
+        {
+            case string_operand:
+            case char_operand: constant = pool_constant(string_constant, &tree.strings[tree.a[node]], tree.b[node], tree.a[node]);break;
+            case integer_operand:
+            case float_operand:
+            case hex_operand: {
+                uSIZE value = ast_number(node);
+                constant = pool_constant(number_constant, (const uT8 *) &value, constant_number_size, value);
+                break;
+            }
+            case variable_operand: {
+                if(tree.b[node] != no_slot) constant = constant_of_slot[tree.b[node]];
+                break;
+            }
+            case variable_decl: {
+                uT32 slot = variable_slot(tree.a[node]);
+                if(slot != no_slot) constant_of_slot[slot] = program_constants.constant_of_node[tree.b[node]];
+                break;
+            }
+            default: break;
+        }
+
+        program_constants.constant_of_node[node] = constant;
+    }
+
+    free(constant_of_slot);
+    lay_out_rodata();
+
+    trace(TC_ast, TL_info, "%llu literals pooled into %llu bytes of rodata, %llu bytes saved",
+        program_constants.literals, program_constants.rodata_size, program_constants.bytes_saved);
+}
+
+/* Pool the literals of `tree`, fold variable operands into the constants they hold, and lay the
+ * pool out as `rodata`. Like `resolve_variables`, every run starts over.
+ * Run after `resolve_variables`, variable operands are folded through their slots.
+ * */
+void build_constant_pool()
+{
+    build_constant_pool_from(0);
+}
+
+/* Constant operand `node` stands for, `no_constant` if there is none. */
+_constant *node_constant(uT32 node)
+{
+    uT32 constant = program_constants.constant_of_node[node];
+    return constant == no_constant ? NULL : &program_constants.entries[constant];
+}
+
+/* The bytes of `c` in `rodata`. */
+const uT8 *constant_data(_constant *c)
+{
+    return &program_constants.rodata[c->offset];
+}
+
+void destroy_constant_pool()
+{
+    if(!(active_context->constants)) return;
+
+    free(program_constants.rodata);
+    free(program_constants.entries);
+    free(program_constants.slots);
+    free(program_constants.constant_of_node);
+    free(active_context->constants);
+    active_context->constants = NULL;
+}
+
+#endif
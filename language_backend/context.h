@@ -0,0 +1,120 @@
+#ifndef compilation_context
+#define compilation_context
+#include "diagnostics.h"
+
+/* Everything one compilation owns.
+ * Nothing about a compilation lives in a global, so any number of them can run in one process, on
+ * as many threads as needed(see `parallel.h`, which runs one per chunk).
+ *
+ * `init_lexer`, `init_parser`, `run_parser` and `run_dot_mem_parser` are handed the context(directly,
+ * or through the lexer/parser it was given to) and make it the thread's `active_context`. Everything
+ * they call reaches the state of the compilation through it(e.g. `tree` is `*active_context->syntax_tree`).
+ * */
+typedef struct compiler_context
+{
+    /* See `arena.h`. */
+    struct arena            *arena;
+
+    /* See `tokens.h`. `current_token` is the token the parser is looking at. */
+    struct token_stream     *token_list;
+    struct token            *current_token;
+
+    /* See `ast.h`, `symbols.h`, `variables.h`, `constants.h` and `bytecode.h`. */
+    struct ast_tree         *syntax_tree;
+    struct symbol_table     *symbol_names;
+    struct variable_table   *variables;
+    struct constant_pool    *constants;
+    struct bytecode         *bytecode;
+
+    /* What the `.mem` file(if any) says, see `mem_outline.h`. */
+    struct memory_info      *memory_info;
+
+    /* `memory_info` belongs to another compilation, it is left alone when this one is destroyed. */
+    bool                    memory_info_borrowed;
+
+    /* `.mem` files already parsed by other compilations of the same batch, NULL outside of one(see `batch.h`). */
+    struct dot_mem_store    *dot_mem_store;
+
+    /* Errors found so far. */
+    _diagnostics            diagnostics;
+
+    /* Files the source code pulled in(e.g. the `.mem` file of `#incmem`), see `cache.h`. */
+    nT8                     **dependencies;
+    uT32                    dependency_amount;
+
+    /* The cache file `tree` and `symbol_table` point into, if they were loaded from the cache. */
+    void                    *cache_mapping;
+    uSIZE                   cache_mapping_size;
+} _compiler_context;
+
+/* The compilation the thread is working on. */
+__thread _compiler_context *active_context = NULL;
+
+/* A new compilation, with an empty ast and the default memory info. It is left as the `active_context`. */
+_compiler_context *new_compiler_context();
+
+/* Release `context` and everything it owns. */
+void destroy_compiler_context(_compiler_context *context);
+
+/* Compile a file in a compilation of its own(see `sum.h`). */
+_compiler_context *compile(nT8 *filename, bool streaming, uT32 jobs, const nT8 *cache_directory, struct dot_mem_store *dot_mem_store);
+
+void use_compiler_context(_compiler_context *context)
+{
+    active_context = context;
+}
+
+/* Remember that the compilation read `path`. */
+void add_dependency(const nT8 *path)
+{
+    nT8 **dependencies = realloc(active_context->dependencies, (active_context->dependency_amount + 1) * sizeof(*dependencies));
+    nT8 *copy = malloc(strlen(path) + 1);
+    lang_assert(dependencies && copy,
+        "Error allocating memory for the dependencies of the compilation.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    active_context->dependencies = dependencies;
+    active_context->dependencies[active_context->dependency_amount++] = strcpy(copy, path);
+}
+
+void report_error(nT32 error_code, const nT8 *err_msg, ...)
+{
+    va_list args;
+
+    va_start(args, err_msg);
+    nT8 *message = format_diagnostic(err_msg, args);
+    va_end(args);
+
+    if(active_context && active_context->diagnostics.recovery && !(fatal_error(error_code)))
+    {
+        add_diagnostic(&active_context->diagnostics, error_code, active_context->diagnostics.offset, message);
+        longjmp(*active_context->diagnostics.recovery, 1);
+    }
+
+    print_diagnostic(message);
+    exit(error_code);
+}
+
+/* Send errors to `recovery` from now on, `setjmp` on it right after. Returns where errors went before,
+ * which has to be handed back to `stop_catching_errors` once done.
+ * */
+jmp_buf *catch_errors(jmp_buf *recovery)
+{
+    jmp_buf *outer = active_context->diagnostics.recovery;
+
+    active_context->diagnostics.recovery = recovery;
+    return outer;
+}
+
+void stop_catching_errors(jmp_buf *outer)
+{
+    active_context->diagnostics.recovery = outer;
+}
+
+/* Errors found from now on are at `offset`. */
+static inline void diagnose_at(uSIZE offset)
+{
+    active_context->diagnostics.offset = offset;
+}
+
+#endif
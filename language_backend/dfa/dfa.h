@@ -0,0 +1,50 @@
+#ifndef dfa
+#define dfa
+
+/* The tables both lexers run on, generated from `tokens.spec` by the Makefile. */
+#include "dfa_tables.h"
+
+/* Which scan kernel moves through a state that loops back to itself(see `run_kernel` in `gen_dfa.c`). */
+enum dfa_runs
+{
+    DFA_RUN_none            = 0x0,
+    DFA_RUN_string,
+    DFA_RUN_word_underscore,
+    DFA_RUN_word,
+    DFA_RUN_blank
+};
+
+/* Run the DFA from `state` over [`p`, `end`), and find the longest token that starts at `p`.
+ * Returns the `enum dfa_tokens` of that token(`DFA_none` if there is none) and sets `length` to its length.
+ * */
+static inline uT8 dfa_match(uT8 state, const uT8 *p, const uT8 *end, uSIZE *length)
+{
+    const uT8 *start = p;
+    uT8 matched = DFA_none;
+
+    *length = 0;
+
+    while(p < end && (state = dfa_next[state][dfa_class[*p]]))
+    {
+        p++;
+
+        switch(dfa_run[state])
+        {
+            case DFA_RUN_string: p = scan_kernels.scan_string(p, end);break;
+            case DFA_RUN_word_underscore: p = scan_kernels.scan_word(p, end, true);break;
+            case DFA_RUN_word: p = scan_kernels.scan_word(p, end, false);break;
+            case DFA_RUN_blank: p = scan_kernels.skip_blank(p, end);break;
+            default: break;
+        }
+
+        if(dfa_accept[state])
+        {
+            matched = dfa_accept[state];
+            *length = p - start;
+        }
+    }
+
+    return matched;
+}
+
+#endif
@@ -0,0 +1,461 @@
+/* Generates `dfa_tables.h` from `tokens.spec`.
+ *
+ * Usage: gen_dfa <tokens.spec> <dfa_tables.h>
+ *
+ * Every rule of the specification becomes a small NFA(Thompson's construction). The NFAs of each
+ * start condition are joined and turned into one DFA(subset construction). Bytes that no pattern
+ * tells apart share a character class, so the transition table is `states x classes` rather
+ * than `states x 256`.
+ *
+ * A state that loops back to itself on every blank, every letter or every string character is
+ * marked, so the lexers can move through it with one of the scan kernels(see `scan.h`) rather
+ * than a byte at a time.
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define max_rules           64
+#define max_names           64
+#define max_name_length     32
+#define max_nfa_states      2048
+#define max_dfa_states      255     // states are stored in a byte, 0 is the dead state
+#define set_words           (max_nfa_states / 64)
+
+typedef struct byte_set
+{
+    uint64_t    bits[4];
+} _byte_set;
+
+#define set_has(s, b)       (((s)->bits[(b) >> 6] >> ((b) & 63)) & 1)
+#define set_add(s, b)       ((s)->bits[(b) >> 6] |= 1ULL << ((b) & 63))
+
+typedef struct nfa_state
+{
+    /* Epsilon moves. */
+    int         *epsilon;
+    int         epsilon_amount;
+
+    /* Move to `target` on any byte in `on`(-1 if there is none). */
+    _byte_set   on;
+    int         target;
+
+    /* Token accepted here(0 if none) and the rule that accepts it(lower wins). */
+    int         token;
+    int         rule;
+} _nfa_state;
+
+typedef struct fragment
+{
+    int         start;
+    int         end;
+} _fragment;
+
+typedef struct nfa_set
+{
+    uint64_t    bits[set_words];
+} _nfa_set;
+
+static _nfa_state nfa[max_nfa_states];
+static int nfa_amount = 0;
+
+static char start_names[max_names][max_name_length];
+static int start_amount = 0;
+static int start_nfa[max_names];
+
+static char token_names[max_names][max_name_length];
+static int token_amount = 0;
+
+static _byte_set sets[max_nfa_states];
+static int set_amount = 0;
+
+static int byte_class[256];
+static int class_amount = 0;
+static int class_byte[256];     // one byte of each class
+
+static _nfa_set dfa[max_dfa_states + 1];
+static int dfa_amount = 1;      // 0 is the dead state
+static unsigned char dfa_next[max_dfa_states + 1][256];
+static int dfa_accept[max_dfa_states + 1];
+static int dfa_run[max_dfa_states + 1];
+static int dfa_start[max_names];
+
+static void fail(const char *message, const char *detail)
+{
+    fprintf(stderr, "gen_dfa: %s%s\n", message, detail);
+    exit(1);
+}
+
+static int new_nfa_state()
+{
+    if(nfa_amount == max_nfa_states) fail("too many NFA states.", "");
+
+    memset(&nfa[nfa_amount], 0, sizeof(nfa[nfa_amount]));
+    nfa[nfa_amount].target = -1;
+    return nfa_amount++;
+}
+
+static void add_epsilon(int from, int to)
+{
+    _nfa_state *s = &nfa[from];
+
+    s->epsilon = realloc(s->epsilon, (s->epsilon_amount + 1) * sizeof(*s->epsilon));
+    s->epsilon[s->epsilon_amount++] = to;
+}
+
+static int find_name(char names[][max_name_length], int *amount, const char *name)
+{
+    for(int i = 0; i < *amount; i++)
+        if(strcmp(names[i], name) == 0) return i;
+
+    if(*amount == max_names) fail("too many names, at `", name);
+    if(strlen(name) >= max_name_length) fail("name too long: ", name);
+
+    strcpy(names[*amount], name);
+    return (*amount)++;
+}
+
+/* Read one, possibly escaped, character of a pattern. */
+static int pattern_char(const char **p)
+{
+    int c = (unsigned char) *(*p)++;
+    if(c != '\\') return c;
+
+    c = (unsigned char) *(*p)++;
+    switch(c)
+    {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case 's': return ' ';
+        case '\0': fail("pattern ends in `\\`.", "");
+        default: return c;
+    }
+}
+
+/* `[...]`, with ranges and `^` for "anything but". `p` is past the `[`. */
+static _byte_set pattern_set(const char **p, const char *pattern)
+{
+    _byte_set set = { { 0 } };
+    int negate = 0;
+
+    if(**p == '^') { negate = 1; (*p)++; }
+
+    while(**p != ']')
+    {
+        if(**p == '\0') fail("unterminated `[` in ", pattern);
+
+        int low = pattern_char(p), high = low;
+        if(**p == '-' && (*p)[1] != ']')
+        {
+            (*p)++;
+            high = pattern_char(p);
+        }
+
+        for(int b = low; b <= high; b++) set_add(&set, b);
+    }
+    (*p)++;
+
+    if(negate)
+        for(int i = 0; i < 4; i++) set.bits[i] = ~set.bits[i];
+
+    return set;
+}
+
+/* Thompson's construction for a sequence of(optionally repeated) characters and sets. */
+static _fragment build_pattern(const char *pattern)
+{
+    _fragment whole = { new_nfa_state(), -1 };
+    whole.end = whole.start;
+
+    for(const char *p = pattern; *p;)
+    {
+        _byte_set set = { { 0 } };
+
+        if(*p == '[') { p++; set = pattern_set(&p, pattern); }
+        else
+        {
+            int c = pattern_char(&p);
+            set_add(&set, c);
+        }
+
+        _fragment atom = { new_nfa_state(), new_nfa_state() };
+        nfa[atom.start].on = set;
+        nfa[atom.start].target = atom.end;
+
+        switch(*p)
+        {
+            case '*': {
+                _fragment loop = { new_nfa_state(), new_nfa_state() };
+                add_epsilon(loop.start, atom.start);
+                add_epsilon(loop.start, loop.end);
+                add_epsilon(atom.end, atom.start);
+                add_epsilon(atom.end, loop.end);
+                atom = loop;
+                p++;
+                break;
+            }
+            case '+': {
+                int end = new_nfa_state();
+                add_epsilon(atom.end, atom.start);
+                add_epsilon(atom.end, end);
+                atom.end = end;
+                p++;
+                break;
+            }
+            case '?': {
+                _fragment maybe = { new_nfa_state(), new_nfa_state() };
+                add_epsilon(maybe.start, atom.start);
+                add_epsilon(maybe.start, maybe.end);
+                add_epsilon(atom.end, maybe.end);
+                atom = maybe;
+                p++;
+                break;
+            }
+            default: break;
+        }
+
+        add_epsilon(whole.end, atom.start);
+        whole.end = atom.end;
+    }
+
+    return whole;
+}
+
+static void read_specification(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if(!f) fail("cannot open ", path);
+
+    char line[256];
+    int rule = 0;
+
+    while(fgets(line, sizeof(line), f))
+    {
+        char start[max_name_length], token[max_name_length];
+        int pattern_offset = 0;
+
+        line[strcspn(line, "\n")] = '\0';
+        if(line[0] == '#' || line[0] == '\0') continue;
+
+        if(sscanf(line, "%31s %31s %n", start, token, &pattern_offset) != 2 || line[pattern_offset] == '\0')
+            fail("malformed line: ", line);
+
+        /* Patterns can hold spaces(in sets), so only trailing whitespace is dropped. */
+        char *pattern = &line[pattern_offset];
+        size_t length = strlen(pattern);
+        while(length > 0 && (pattern[length - 1] == ' ' || pattern[length - 1] == '\t')) pattern[--length] = '\0';
+
+        int amount_before = start_amount;
+        int s = find_name(start_names, &start_amount, start);
+        if(start_amount > amount_before) start_nfa[s] = new_nfa_state();
+
+        if(rule == max_rules) fail("too many rules, at ", line);
+
+        _fragment f = build_pattern(pattern);
+        nfa[f.end].token = find_name(token_names, &token_amount, token) + 1;
+        nfa[f.end].rule = rule++;
+        add_epsilon(start_nfa[s], f.start);
+    }
+
+    fclose(f);
+}
+
+/* Bytes that are in exactly the same sets behave the same everywhere, so they share a class. */
+static void build_classes()
+{
+    for(int i = 0; i < nfa_amount; i++)
+        if(nfa[i].target >= 0) sets[set_amount++] = nfa[i].on;
+
+    for(int b = 0; b < 256; b++)
+    {
+        byte_class[b] = -1;
+
+        for(int c = 0; c < class_amount && byte_class[b] < 0; c++)
+        {
+            int same = 1;
+
+            for(int s = 0; s < set_amount && same; s++)
+                same = set_has(&sets[s], b) == set_has(&sets[s], class_byte[c]);
+
+            if(same) byte_class[b] = c;
+        }
+
+        if(byte_class[b] < 0)
+        {
+            class_byte[class_amount] = b;
+            byte_class[b] = class_amount++;
+        }
+    }
+}
+
+static void closure(_nfa_set *set)
+{
+    int stack[max_nfa_states], top = 0;
+
+    for(int i = 0; i < nfa_amount; i++)
+        if((set->bits[i / 64] >> (i % 64)) & 1) stack[top++] = i;
+
+    while(top > 0)
+    {
+        _nfa_state *s = &nfa[stack[--top]];
+
+        for(int e = 0; e < s->epsilon_amount; e++)
+        {
+            int t = s->epsilon[e];
+            if((set->bits[t / 64] >> (t % 64)) & 1) continue;
+
+            set->bits[t / 64] |= 1ULL << (t % 64);
+            stack[top++] = t;
+        }
+    }
+}
+
+static int empty(const _nfa_set *set)
+{
+    for(int i = 0; i < set_words; i++)
+        if(set->bits[i]) return 0;
+
+    return 1;
+}
+
+/* Find the DFA state for `set`, adding it if it is new. */
+static int dfa_state(const _nfa_set *set)
+{
+    if(empty(set)) return 0;
+
+    for(int d = 1; d < dfa_amount; d++)
+        if(memcmp(&dfa[d], set, sizeof(*set)) == 0) return d;
+
+    if(dfa_amount > max_dfa_states) fail("too many DFA states.", "");
+
+    dfa[dfa_amount] = *set;
+    return dfa_amount++;
+}
+
+/* Subset construction. New states are appended to `dfa`, so walking it in order visits all of them. */
+static void build_dfa()
+{
+    for(int s = 0; s < start_amount; s++)
+    {
+        _nfa_set set = { { 0 } };
+
+        set.bits[start_nfa[s] / 64] |= 1ULL << (start_nfa[s] % 64);
+        closure(&set);
+        dfa_start[s] = dfa_state(&set);
+    }
+
+    for(int d = 1; d < dfa_amount; d++)
+    {
+        int best_rule = max_rules;
+
+        for(int i = 0; i < nfa_amount; i++)
+        {
+            if(!((dfa[d].bits[i / 64] >> (i % 64)) & 1)) continue;
+            if(nfa[i].token && nfa[i].rule < best_rule) { best_rule = nfa[i].rule; dfa_accept[d] = nfa[i].token; }
+        }
+
+        for(int c = 0; c < class_amount; c++)
+        {
+            _nfa_set moved = { { 0 } };
+
+            for(int i = 0; i < nfa_amount; i++)
+            {
+                if(!((dfa[d].bits[i / 64] >> (i % 64)) & 1)) continue;
+                if(nfa[i].target >= 0 && set_has(&nfa[i].on, class_byte[c]))
+                    moved.bits[nfa[i].target / 64] |= 1ULL << (nfa[i].target % 64);
+            }
+
+            closure(&moved);
+            dfa_next[d][c] = dfa_state(&moved);
+        }
+    }
+}
+
+/* Which scan kernel(if any) can move through state `d`? Only when `d` loops back to itself on
+ * exactly the bytes the kernel skips, so the kernel stops exactly where the DFA would leave `d`.
+ * The values are `enum dfa_runs` in `dfa.h`.
+ * */
+static int run_kernel(int d)
+{
+    for(int k = 1; k <= 4; k++)
+    {
+        int fits = 1;
+
+        for(int b = 0; b < 256 && fits; b++)
+        {
+            int letter = (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z');
+            int skipped = 0;
+
+            switch(k)
+            {
+                case 1: skipped = b != '\'' && b != '"' && b != '\n';break;    // `scan_string`
+                case 2: skipped = letter || b == '_';break;                     // `scan_word`, with underscores
+                case 3: skipped = letter;break;                                 // `scan_word`
+                case 4: skipped = b == ' ' || b == '\t' || b == '\r' || b == '\n';break;   // `skip_blank`
+            }
+
+            fits = skipped == (dfa_next[d][byte_class[b]] == d);
+        }
+
+        if(fits) return k;
+    }
+
+    return 0;
+}
+
+int main(int args, char *argv[])
+{
+    if(args != 3)
+    {
+        fprintf(stderr, "Usage: %s <tokens.spec> <dfa_tables.h>\n", argv[0]);
+        return 1;
+    }
+
+    read_specification(argv[1]);
+    build_classes();
+    build_dfa();
+
+    for(int d = 1; d < dfa_amount; d++) dfa_run[d] = run_kernel(d);
+
+    FILE *out = fopen(argv[2], "w");
+    if(!out) fail("cannot write ", argv[2]);
+
+    fprintf(out, "/* Generated by `gen_dfa` from `tokens.spec`. Do not edit. */\n");
+    fprintf(out, "#ifndef dfa_tables\n#define dfa_tables\n\n");
+
+    fprintf(out, "enum dfa_tokens\n{\n    DFA_none = 0,\n");
+    for(int t = 0; t < token_amount; t++) fprintf(out, "    DFA_%s,\n", token_names[t]);
+    fprintf(out, "};\n\n");
+
+    for(int s = 0; s < start_amount; s++)
+        fprintf(out, "#define dfa_start_%-16s%d\n", start_names[s], dfa_start[s]);
+    fprintf(out, "#define dfa_state_amount        %d\n", dfa_amount);
+    fprintf(out, "#define dfa_class_amount        %d\n\n", class_amount);
+
+    fprintf(out, "static const uT8 dfa_class[256] = {");
+    for(int b = 0; b < 256; b++) fprintf(out, "%s%d,", b % 16 ? " " : "\n    ", byte_class[b]);
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "static const uT8 dfa_next[dfa_state_amount][dfa_class_amount] = {\n");
+    for(int d = 0; d < dfa_amount; d++)
+    {
+        fprintf(out, "    {");
+        for(int c = 0; c < class_amount; c++) fprintf(out, "%s%d", c ? ", " : " ", dfa_next[d][c]);
+        fprintf(out, " },\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const uT8 dfa_accept[dfa_state_amount] = {");
+    for(int d = 0; d < dfa_amount; d++) fprintf(out, "%s%d,", d % 16 ? " " : "\n    ", dfa_accept[d]);
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "/* `enum dfa_runs`. */\n");
+    fprintf(out, "static const uT8 dfa_run[dfa_state_amount] = {");
+    for(int d = 0; d < dfa_amount; d++) fprintf(out, "%s%d,", d % 16 ? " " : "\n    ", dfa_run[d]);
+    fprintf(out, "\n};\n\n#endif\n");
+
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,42 @@
+# Token specification of both lexers. `gen_dfa` turns it into `dfa_tables.h`.
+#
+# Each line is `<start> <token> <pattern>`, where `<start>` is the start condition the rule belongs to:
+#   sum         - `.sum` source code
+#   sum_string  - the body of a `.sum` string(anything after an opening quotation)
+#   mem         - `.mem` source code
+#
+# A pattern is a sequence of characters and `[...]` sets, each optionally followed by `*`, `+` or `?`.
+# `\n`, `\t`, `\r`, `\s`(a space) and `\<any other character>` are escapes.
+# The longest match wins. When two rules match the same length, the one written first wins.
+#
+# Keywords are not listed here. Words are looked up in the table generated from `keywords.def` afterwards.
+
+sum         blank           [\s\t\r\n]+
+sum         word            [a-zA-Z]+
+sum         number          [0-9][0-9a-zA-Z_.]*
+sum         single_quote    '
+sum         double_quote    "
+sum         left_par        (
+sum         right_par       )
+sum         equals          =
+sum         hashtag         #
+sum         comma           ,
+
+sum_string  string_body     [^'"\n]+
+sum_string  single_quote    '
+sum_string  double_quote    "
+sum_string  newline         \n
+
+mem         blank           [\s\t\r\n]+
+mem         comment         //[^\n]*
+mem         slash           /
+mem         word            [a-zA-Z][a-zA-Z_]*
+mem         number          [0-9][0-9a-zA-Z]*
+mem         char            '[^\\]'
+mem         char            '\\0'
+mem         left_par        (
+mem         right_par       )
+mem         left_brack      {
+mem         right_brack     }
+mem         colon           :
+mem         comma           ,
@@ -0,0 +1,160 @@
+#ifndef diagnostics_engine
+#define diagnostics_engine
+#include <setjmp.h>
+#include <stdarg.h>
+
+/* An error found while compiling. */
+typedef struct diagnostic
+{
+    /* `enum custom_errors`. */
+    nT32        error_code;
+
+    /* Where in the source code the error is. Diagnostics are reported in this order. */
+    uSIZE       offset;
+
+    /* Order the error was found in, so errors at the same offset keep it. */
+    uT32        found;
+
+    nT8         *message;
+} _diagnostic;
+
+/* Every error of a compilation.
+ *
+ * As long as there is somewhere to recover to, `lang_error` does not end the program: it records the
+ * error and jumps to `recovery`. Whoever set `recovery`(the lexer, the parser, the `.mem` parser, ...)
+ * moves on past what failed(the rest of the line, usually) and carries on, so a single run finds every
+ * error. They are all reported at the end, in source order(see `report_diagnostics`).
+ * */
+typedef struct diagnostics
+{
+    _diagnostic *entries;
+    uT32        amount;
+    uT32        capacity;
+    uT32        found;
+
+    /* Where `lang_error` goes once the error is recorded. NULL when there is nowhere to go, then the
+     * error is printed and the program ends right away(like it does for errors that are `fatal_error`s).
+     * */
+    jmp_buf     *recovery;
+
+    /* Offset of what is being worked on. An error found now is at this offset. */
+    uSIZE       offset;
+} _diagnostics;
+
+/* Running out of memory, or not being able to read the source code, cannot be recovered from. */
+#define fatal_error(error_code)     ((error_code) >= OOC_allocation_error && (error_code) <= OOC_source_code_read_error)
+
+/* `err_msg` formatted, on the heap. */
+nT8 *format_diagnostic(const nT8 *err_msg, va_list args)
+{
+    va_list again;
+    va_copy(again, args);
+
+    nT32 length = vsnprintf(NULL, 0, err_msg, args);
+    nT8 *message = malloc(length + 1);
+    if(message) vsnprintf(message, length + 1, err_msg, again);
+
+    va_end(again);
+    return message;
+}
+
+/* Print an error the way it always has been: `[ERROR] message`. */
+void print_diagnostic(const nT8 *message)
+{
+    fprintf(stderr, "\n%s[ERROR]%s ", error_color, reset);
+    fputs(message ? message : "Error allocating memory for an error message.\n", stderr);
+    fprintf(stderr, "\n");
+}
+
+void add_diagnostic(_diagnostics *d, nT32 error_code, uSIZE offset, nT8 *message)
+{
+    if(d->amount == d->capacity)
+    {
+        d->capacity = d->capacity ? d->capacity * 2 : 0x10;
+        d->entries = realloc(d->entries, d->capacity * sizeof(*d->entries));
+
+        if(!(d->entries))
+        {
+            print_diagnostic("Error allocating memory for the diagnostics.\n\tTry rerunning the program.\n");
+            exit(OOC_allocation_error);
+        }
+    }
+
+    d->entries[d->amount++] = (_diagnostic) {
+        .error_code = error_code,
+        .offset = offset,
+        .found = d->found++,
+        .message = message
+    };
+
+    trace(TC_parser, TL_error, "Error %llu at offset %llu", error_code, offset);
+}
+
+/* Move every diagnostic of `from` into `d`. */
+void take_diagnostics(_diagnostics *d, _diagnostics *from)
+{
+    for(uT32 i = 0; i < from->amount; i++)
+        add_diagnostic(d, from->entries[i].error_code, from->entries[i].offset, from->entries[i].message);
+
+    free(from->entries);
+    from->entries = NULL;
+    from->amount = from->capacity = 0;
+}
+
+/* Forget the diagnostics in [`start`, `end`), and move the ones at or after `end` by `moved` bytes.
+ * `error_code` other than 0 only forgets the diagnostics in [`start`, `end`) with that code, and moves none.
+ * */
+void forget_diagnostics(_diagnostics *d, uSIZE start, uSIZE end, sSIZE moved, nT32 error_code)
+{
+    uT32 kept = 0;
+
+    for(uT32 i = 0; i < d->amount; i++)
+    {
+        _diagnostic *diagnostic = &d->entries[i];
+
+        if(diagnostic->offset >= start && diagnostic->offset < end && (!(error_code) || diagnostic->error_code == error_code))
+        {
+            free(diagnostic->message);
+            continue;
+        }
+
+        if(!(error_code) && diagnostic->offset >= end) diagnostic->offset += moved;
+        d->entries[kept++] = *diagnostic;
+    }
+
+    d->amount = kept;
+}
+
+static int compare_diagnostics(const void *a, const void *b)
+{
+    const _diagnostic *x = a, *y = b;
+
+    if(x->offset != y->offset) return x->offset < y->offset ? -1 : 1;
+    return x->found < y->found ? -1 : x->found > y->found;
+}
+
+/* Print every diagnostic, in source order.
+ * Returns the status the program should exit with: the code of the first error, or 0 if there were none.
+ * */
+nT32 report_diagnostics(_diagnostics *d)
+{
+    if(!(d->amount)) return 0;
+
+    qsort(d->entries, d->amount, sizeof(*d->entries), compare_diagnostics);
+
+    for(uT32 i = 0; i < d->amount; i++)
+        print_diagnostic(d->entries[i].message);
+
+    return d->entries[0].error_code;
+}
+
+void free_diagnostics(_diagnostics *d)
+{
+    for(uT32 i = 0; i < d->amount; i++)
+        free(d->entries[i].message);
+
+    free(d->entries);
+    *d = (_diagnostics) { 0 };
+}
+
+#endif
@@ -1,283 +1,139 @@
 #ifndef dot_mem_lexer
 #define dot_mem_lexer
+#include "dot_mem_token_list.h"
 
-enum dot_mem_tokens
-{
-    DM_DEF,
-    program_size_KW,
-    require_var_inits_KW,
-    stack_access_KW,
-    sections_KW,
-    variable_KW,
-    store_in_KW,
-    colon,
-    comma,
-    left_par,
-    right_par,
-    left_brack,
-    right_brack,
-    decimal,
-    hex,
-    boolean_true,
-    boolean_false,
-    DM_word,
-    DM_EOF,
-    t_bytes,
-    t_mb,
-    t_gb,
-    t_unknown,
-    data_KW = 0x20,
-    rodata_KW = 0x21,
-    stack_KW = 0x22,
-    type_KW,
-    preset_data_KW,
-    liked_size_KW,
-    byte_KW,
-    word_KW,
-    dword_KW,
-    none_KW,
-    emptyArray_builtin,
-    byteArray_builtin,
-    char_value,
-};
+/* Longest value a `.mem` token can have(including the `\0`). */
+#define dot_mem_token_value_size    50
 
 typedef struct DotMemToken
 {
     enum dot_mem_tokens     token_id;
-    uT8                     token_value[50];
+    uT8                     token_value[dot_mem_token_value_size];
 } _DotMemToken;
 
 typedef struct MemLexer
 {
     uT8             *src;
     uT8             *path;
-    uT32            index;
+    uSIZE           index;
     uT8             val;
-    sSIZE           src_size;
-    nT8             line;
+    uSIZE           src_size;
+    nTL32           line;
     _DotMemToken    token;
 } _MemLexer;
 
-_MemLexer *init_dot_mem_lexer(uT8 *source_code, uT8 *path)
+_MemLexer *init_dot_mem_lexer(_source_buffer *source_code, uT8 *path)
 {
-    _MemLexer *dot_mem_lex = calloc(1, sizeof(*dot_mem_lex));
+    _MemLexer *dot_mem_lex = front_end_alloc(sizeof(*dot_mem_lex));
 
-    dot_mem_lex->src = calloc(strlen(nT8_PCC source_code), sizeof(*dot_mem_lex->src));
-    memcpy(dot_mem_lex->src, source_code, strlen(nT8_PCC source_code));
+    /* Borrow the source code, the caller still owns `source_code`. */
+    dot_mem_lex->src = source_code->data;
 
     dot_mem_lex->path = path;
     dot_mem_lex->index = 0;
     dot_mem_lex->line = 1;
-    dot_mem_lex->src_size = strlen(nT8_PCC source_code);
+    dot_mem_lex->src_size = source_code->size;
     dot_mem_lex->val = dot_mem_lex->src[dot_mem_lex->index];
     dot_mem_lex->token = (_DotMemToken) {
         .token_id = DM_DEF,
         .token_value = {0}
     };
 
-    free(source_code);
-
     return dot_mem_lex;
 }
 
-void init_token(_MemLexer *l, uT8 *token_value, enum dot_mem_tokens tid)
+/* Make `l->token` a `tid` token, with the `length` bytes at `token_value` as its value. */
+void init_token(_MemLexer *l, const uT8 *token_value, uSIZE length, enum dot_mem_tokens tid)
 {
-    l->token = (_DotMemToken) {
-        .token_id = tid
-    };
-    
-    memcpy(l->token.token_value, token_value, strlen(nT8_PCC token_value));
+    l->token.token_id = tid;
 
-    /* Make sure the rest of `l->token.token_value` is null terminated. */
-    memset(&l->token.token_value[strlen(nT8_PCC token_value)], '\0', 50 - strlen(nT8_PCC token_value));
-}
+    lang_assert(length < dot_mem_token_value_size,
+        "Error on line %ld in %s.\n\tValue is too long(%llu characters, at most %d are allowed).\n",
+        lexing_tokenization_error, l->line, l->path, length, dot_mem_token_value_size - 1)
 
-void advance(_MemLexer *l)
-{
-    if((l->index + 1) <= l->src_size)
-    {
-        l->index++;
-        l->val = l->src[l->index];
+    memcpy(l->token.token_value, token_value, length);
 
-        if(l->val == '\n') l->line++;
-    }
+    /* Make sure the rest of `l->token.token_value` is null terminated. */
+    memset(&l->token.token_value[length], '\0', dot_mem_token_value_size - length);
 }
 
-bool peek(_MemLexer *l, uT8 against_char)
-{
-    if(l->src[l->index + 1] == against_char) return true;
-    return false;
-}
-uT8 peek_and_return(_MemLexer *l)
+/* Move past the `length` bytes the DFA matched, counting the lines they span. */
+static void skip_matched(_MemLexer *l, uSIZE length)
 {
-    if((l->index + 1 < l->src_size))
-        return l->src[l->index + 1];
-    
-    return '\0';
+    l->line += scan_kernels.count_newlines(&l->src[l->index], &l->src[l->index + length]);
+    l->index += length;
+    l->val = l->src[l->index];
 }
 
 _MemLexer *get_next_token(_MemLexer *lex)
 {
-    top:
-    if(lex->val == ' ' || lex->val == '\n')
-        while(lex->val == ' ' || lex->val == '\n') advance(lex);
-    
-    if(lex->val == '\t')
-        while(lex->val == '\t') advance(lex);
-    
-    if(is_ascii(lex->val))
-    {
-        if(peek(lex, '\n') || peek(lex, '\0') || peek(lex, ' ')) goto check_char;
+    const uT8 *here, *end = &lex->src[lex->src_size];
+    uSIZE length;
+    uT8 matched;
 
-        uT8 *word = calloc(1, sizeof(*word));
-        lang_assert(word,
-            "Error allocating memory to obtain word from %s.\n\tTry rerunning the program.\n",
-            OOC_allocation_error, lex->path)
-        uT8 index = 0;
+    do {
+        here = &lex->src[lex->index];
 
-        while(is_ascii_with_exception(lex->val, '_'))
+        if(lex->index >= lex->src_size || lex->val == '\0')
         {
-            word[index] = lex->val;
-            index++;
-
-            word = realloc(
-                word,
-                (index + 1) * sizeof(*word)
-            );
-
-            advance(lex);
-
-            if(lex->val == ' ') break;
+            init_token(lex, here, 0, DM_EOF);
+            return lex;
         }
 
-        memset(&word[index], '\0', 1);
-        if(strcmp(nT8_PCC word, "program_size") == 0) { init_token(lex, uT8_PC word, program_size_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "stack_access") == 0) { init_token(lex, uT8_PC word, stack_access_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "true") == 0) { init_token(lex, uT8_PC word, boolean_true); goto do_rest; }
-        if(strcmp(nT8_PCC word, "false") == 0) { init_token(lex, uT8_PC word, boolean_false); goto do_rest; }
-        if(strcmp(nT8_PCC word, "sections") == 0) { init_token(lex, uT8_PC word, sections_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "variable") == 0) { init_token(lex, uT8_PC word, variable_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "store_in") == 0) { init_token(lex, uT8_PC word, store_in_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "data") == 0) { init_token(lex, uT8_PC word, data_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "rodata") == 0) { init_token(lex, uT8_PC word, rodata_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "stack") == 0) { init_token(lex, uT8_PC word, stack_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "type") == 0) { init_token(lex, uT8_PC word, type_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "preset_data") == 0) { init_token(lex, uT8_PC word, preset_data_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "liked_size") == 0) { init_token(lex, uT8_PC word, liked_size_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "byte") == 0) { init_token(lex, uT8_PC word, byte_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "word") == 0) { init_token(lex, uT8_PC word, word_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "dword") == 0) { init_token(lex, uT8_PC word, dword_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "none") == 0) { init_token(lex, uT8_PC word, none_KW); goto do_rest; }
-        if(strcmp(nT8_PCC word, "emptyArray") == 0) { init_token(lex, uT8_PC word, emptyArray_builtin); goto do_rest; }
-        if(strcmp(nT8_PCC word, "byteArray") == 0) { init_token(lex, uT8_PC word, byteArray_builtin); goto do_rest; }
-        init_token(lex, uT8_PC word, DM_word);
-
-        do_rest:
-        free(word);
-        return lex;
-    }
+        matched = dfa_match(dfa_start_mem, here, end, &length);
+        if(matched == DFA_blank || matched == DFA_comment) skip_matched(lex, length);
+    } while(matched == DFA_blank || matched == DFA_comment);
 
-    if(is_number(lex->val))
+    switch(matched)
     {
-        uT8 *number = calloc(1, sizeof(*number));
-        lang_assert(number,
-            "Error allocating memory to obtain number from %s.\n\tTry rerunning the program.\n",
-            OOC_allocation_error, lex->path)
-        uT8 index = 0;
-        bool is_hex = false;
-
-        while(true)
-        {
-            number[index] = lex->val;
-            index++;
-
-            number = realloc(
-                number,
-                (index + 1) * sizeof(*number)
-            );
-            
-            if(peek(lex, ' ') || peek(lex, '\n') || peek(lex, ',')) { advance(lex); break; }
-            if(peek(lex, '\0')) goto end;
-            if(peek(lex, 'x')) is_hex = true;
-
-            advance(lex);
+        case DFA_word: {
+            /* A single `b`, `g` or `m` is a size(bytes, gigabytes, megabytes). */
+            if(length == 1)
+                switch(lex->val | 0x20)
+                {
+                    case 'b': init_token(lex, uT8_PCC "b", 1, t_bytes);skip_matched(lex, 1);return lex;
+                    case 'g': init_token(lex, uT8_PCC "g", 1, t_gb);skip_matched(lex, 1);return lex;
+                    case 'm': init_token(lex, uT8_PCC "m", 1, t_mb);skip_matched(lex, 1);return lex;
+                    default: break;
+                }
+
+            const _keyword *k = lookup_keyword(here, length);
+
+            if(k && k->mem_token != DM_DEF) init_token(lex, here, length, k->mem_token);
+            else init_token(lex, here, length, DM_word);
+            break;
         }
-
-        memset(&number[index], '\0', 1);
-        
-        if(is_hex) init_token(lex, uT8_PC number, hex);
-        else init_token(lex, uT8_PC number, decimal);
-
-        free(number);
-
-        return lex;
-    }
-
-    check_char:
-    switch(lex->val)
-    {
-        case '\'': {
-            advance(lex);
-
-            uT8 *byte_value;
-            if(lex->val == '\\')
-            {
-                if(peek(lex, '0')) 
-                { advance(lex); byte_value = uT8_PC make_uT8_ptr('\0'); }
-            }
-            else byte_value = uT8_PC make_uT8_ptr(lex->val);
-            lang_assert(peek(lex, '\''),
-                "Error on line %d in %s.\n\tExpected closing single-quote for byte value.\n",
-                grammar_mismatch_error, lex->line, lex->path)
-            advance(lex);
-            
-            init_token(lex, uT8_PC byte_value, char_value);
-            advance(lex);
-            free(byte_value);
-            return lex;
+        case DFA_number: {
+            if(memchr(here, 'x', length)) init_token(lex, here, length, hex);
+            else init_token(lex, here, length, decimal);
+            break;
         }
-        case '/': {
-            if(peek(lex, '/'))
-            {
-                advance(lex);
-                advance(lex);
-                while(lex->val != '\n' && !(lex->val == '\0')) advance(lex);
-
-                goto top;
-            }
-            lang_error("Error on line %d in %s.\n\tUnexpected `/`.\n",
+        case DFA_char: {
+            /* `'\0'` is the byte 0, `'a'` is the byte after the quote. */
+            if(length == 4) init_token(lex, here, 0, char_value);
+            else init_token(lex, &here[1], 1, char_value);
+            break;
+        }
+        case DFA_slash: {
+            lang_error("Error on line %ld in %s.\n\tUnexpected `/`.\n",
                 invalid_grammar_error, lex->line, lex->path)
-            
         }
-        case 'B':
-        case 'b': { init_token(lex, uT8_PC "b", t_bytes); advance(lex); return lex; }
-        case 'G':
-        case 'g': { init_token(lex, uT8_PC "g", t_gb); advance(lex); return lex; }
-        case 'M':
-        case 'm': { init_token(lex, uT8_PC "m", t_mb); advance(lex); return lex; }
-        case '(': { init_token(lex, uT8_PC "(", left_par); advance(lex); return lex; }
-        case ')': { init_token(lex, uT8_PC ")", right_par); advance(lex); return lex; }
-        case '{': { init_token(lex, uT8_PC "{", left_brack); advance(lex); return lex; }
-        case '}': { init_token(lex, uT8_PC "}", right_brack); advance(lex); return lex; }
-        case ':': { init_token(lex, uT8_PC ":", colon); advance(lex); return lex; }
-        case ',': { init_token(lex, uT8_PC ",", comma); advance(lex); return lex; }
+        case DFA_left_par: init_token(lex, here, 1, left_par);break;
+        case DFA_right_par: init_token(lex, here, 1, right_par);break;
+        case DFA_left_brack: init_token(lex, here, 1, left_brack);break;
+        case DFA_right_brack: init_token(lex, here, 1, right_brack);break;
+        case DFA_colon: init_token(lex, here, 1, colon);break;
+        case DFA_comma: init_token(lex, here, 1, comma);break;
         default: {
-            uT8 *char_value_as_string = uT8_PC make_uT8_ptr(lex->val);
-
-            if(is_ascii(lex->val)) { init_token(lex, char_value_as_string, t_unknown); advance(lex); free(char_value_as_string); return lex; }
-
-            if(lex->val == '\0') { init_token(lex, uT8_PC "\0", DM_EOF); free(char_value_as_string); return lex; }
-            init_token(lex, char_value_as_string, t_unknown);
-            advance(lex);
-            free(char_value_as_string);
-            return lex;
+            /* The parser reports unknown characters, with the line they are on. */
+            init_token(lex, here, 1, t_unknown);
+            length = 1;
             break;
         }
     }
-    
-    end:
-    init_token(lex, uT8_PC "\0", DM_EOF);
+
+    skip_matched(lex, length);
     return lex;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -8,18 +8,39 @@ void DM_parser_get_next_token(_DotMemParser *p)
     p->DM_lexer = get_next_token(p->DM_lexer);
 }
 
+/* After an error: drop the rest of the line it was found on and move on to the first token after it.
+ * With `keep_brace`, a `}` on a line of its own is kept, it ends whatever block is being parsed.
+ * */
+static void skip_failed_mem_line(_DotMemParser *p, bool keep_brace)
+{
+    _MemLexer *l = p->DM_lexer;
+
+    if(keep_brace && l->token.token_id == right_brack)
+    {
+        uSIZE line_start = l->index - 1;
+        while(line_start > 0 && (l->src[line_start - 1] == ' ' || l->src[line_start - 1] == '\t')) line_start--;
+
+        if(line_start == 0 || l->src[line_start - 1] == '\n') return;
+    }
+
+    while(l->index < l->src_size && l->src[l->index] != '\n') l->index++;
+    l->val = l->src[l->index];
+
+    DM_parser_get_next_token(p);
+}
+
 void parse_preset_data_for_byte(_DotMemParser *p)
 {
     DM_parser_get_next_token(p);
     lang_assert(p->DM_lexer->token.token_id == colon, 
-        "Error on line %d in %s.\n\tExpected `:` after \"preset_data\".\n", 
+        "Error on line %ld in %s.\n\tExpected `:` after \"preset_data\".\n", 
         invalid_grammar_error, p->DM_lexer->line, p->DM_lexer->path)
     
     DM_parser_get_next_token(p);
     lang_assert(p->DM_lexer->token.token_id == byteArray_builtin ||
                 p->DM_lexer->token.token_id == emptyArray_builtin ||
                 p->DM_lexer->token.token_id == none_KW,
-                "Error on line %d in %s.\n\tExpected `byteArray`, `emptyArray` or `none`.\n\tInstead got %s.\n",
+                "Error on line %ld in %s.\n\tExpected `byteArray`, `emptyArray` or `none`.\n\tInstead got %s.\n",
                 unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
     
     switch(p->DM_lexer->token.token_id)
@@ -27,40 +48,52 @@ void parse_preset_data_for_byte(_DotMemParser *p)
         case byteArray_builtin: {
             DM_parser_get_next_token(p);
             lang_assert(p->DM_lexer->token.token_id == left_par,
-                "Error on line %d in %s.\n\tExpected `(` for built-in function \"byteArray\".\n",
+                "Error on line %ld in %s.\n\tExpected `(` for built-in function \"byteArray\".\n",
                 grammar_mismatch_error, p->DM_lexer->line, p->DM_lexer->path)
             
             DM_parser_get_next_token(p);
+            lang_assert(p->DM_lexer->token.token_id == decimal,
+                "Error on line %ld in %s.\n\tExpected the size of the byte array.\n\tInstead got %s.\n",
+                unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
             assign_PD_var_size(strtol(nT8_PCC p->DM_lexer->token.token_value, NULL, 10) * byte_size);
 
             DM_parser_get_next_token(p);
             lang_assert(p->DM_lexer->token.token_id == comma,
-                "Error on line %d in %s.\n\tThe built-in function `byteArray` expects (size, values).\n",
+                "Error on line %ld in %s.\n\tThe built-in function `byteArray` expects (size, values).\n",
                 missing_parts_error, p->DM_lexer->line, p->DM_lexer->path)
             
             DM_parser_get_next_token(p);
             if(p->DM_lexer->token.token_id == left_brack)
             {
-                DM_parser_get_next_token(p);
-                lang_assert(p->DM_lexer->token.token_id == char_value,
-                    "Error on line %d in %s.\n\tExpected byte value.\n\tInstead got %s.\n",
-                    unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
-                
-                static uT16 index = 0;
-                assign_PD_var_value_byte(p->DM_lexer->token.token_value[0], index);
-                DM_parser_get_next_token(p);
-
-                while(p->DM_lexer->token.token_id == comma)
-                {
-                    index++;
+                uT16 index = 0;
 
+                do {
                     DM_parser_get_next_token(p);
-                    assign_PD_var_value_byte(p->DM_lexer->token.token_value[0], index);
+                    lang_assert(p->DM_lexer->token.token_id == char_value,
+                        "Error on line %ld in %s.\n\tExpected byte value.\n\tInstead got %s.\n",
+                        unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+
+                    /* The values have to fit in the size given to `byteArray`. */
+                    lang_assert(index < program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_size,
+                        "Error on line %ld in %s.\n\tMore values than the %u bytes given to `byteArray`.\n",
+                        unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path,
+                        program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_size)
+
+                    assign_PD_var_value_byte(p->DM_lexer->token.token_value[0], index++);
                     DM_parser_get_next_token(p);
-                }
-                printf("Done, %s", program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_data.ptr_byte_data);
+                } while(p->DM_lexer->token.token_id == comma);
+
+                lang_assert(p->DM_lexer->token.token_id == right_brack,
+                    "Error on line %ld in %s.\n\tExpected `}` after the values of `byteArray`.\n\tInstead got %s.\n",
+                    missing_parts_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+
+                trace(TC_dot_mem, TL_debug, "Done, %llu bytes of preset data", index);
+                DM_parser_get_next_token(p);
             }
 
+            lang_assert(p->DM_lexer->token.token_id == right_par,
+                "Error on line %ld in %s.\n\tExpected `)` to close built-in function \"byteArray\".\n\tInstead got %s.\n",
+                grammar_mismatch_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
             break;
         }
         case emptyArray_builtin: {
@@ -73,23 +106,229 @@ void parse_preset_data_for_byte(_DotMemParser *p)
         }
         default: break;
     }
-    exit(0);
 }
 
-void run_dot_mem_parser(uT8 *src_code, uT8 *DM_path)
+/* Parts every PD variable needs. */
+#define PD_has_store_in     0x01
+#define PD_has_type         0x02
+
+/* Parse one `key: value` of a PD variable. Leaves the last token of the value as the current token.
+ * `type` is the type given so far(`DM_DEF` if none).
+ * */
+static uT8 parse_PD_var_field(_DotMemParser *p, enum dot_mem_tokens *type)
+{
+    switch(p->DM_lexer->token.token_id)
+    {
+        case store_in_KW: {
+            DM_parser_get_next_token(p);
+            lang_assert(p->DM_lexer->token.token_id == colon, 
+                "Error on line %ld in %s.\n\tExpected `:` after \"store_in\".\n", 
+                invalid_grammar_error, p->DM_lexer->line, p->DM_lexer->path)
+            
+            DM_parser_get_next_token(p);
+            lang_assert(p->DM_lexer->token.token_id == data_KW ||
+                        p->DM_lexer->token.token_id == rodata_KW ||
+                        p->DM_lexer->token.token_id == stack_KW,
+                        "Error on line %ld in %s.\n\tExpected `data`, `rodata` or `stack`.\n\tInstead found %s.\n",
+                        unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+
+            switch(p->DM_lexer->token.token_id)
+            {
+                case data_KW: assign_PD_storage_place(T_data);break;
+                case rodata_KW: assign_PD_storage_place(T_rodata);break;
+                default: assign_PD_storage_place(T_stack_based);break;
+            }
+            return PD_has_store_in;
+        }
+        case type_KW: {
+            DM_parser_get_next_token(p);
+            lang_assert(p->DM_lexer->token.token_id == colon, 
+                "Error on line %ld in %s.\n\tExpected `:` after \"type\".\n", 
+                invalid_grammar_error, p->DM_lexer->line, p->DM_lexer->path)
+            
+            DM_parser_get_next_token(p);
+            lang_assert(p->DM_lexer->token.token_id == byte_KW ||
+                        p->DM_lexer->token.token_id == word_KW ||
+                        p->DM_lexer->token.token_id == dword_KW,
+                        "Error on line %ld in %s.\n\tExpected `byte`, `word` or `dword`.\n\tInstead found %s.\n",
+                        unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+
+            *type = p->DM_lexer->token.token_id;
+            return PD_has_type;
+        }
+        case preset_data_KW: {
+            /* Only byte PD variables can have preset data(for now). */
+            lang_assert(*type == byte_KW,
+                "Error on line %ld in %s.\n\t\"preset_data\" needs `type: byte` before it.\n",
+                grammar_mismatch_error, p->DM_lexer->line, p->DM_lexer->path)
+
+            parse_preset_data_for_byte(p);
+            return 0;
+        }
+        case liked_size_KW: {
+            DM_parser_get_next_token(p);
+            lang_assert(p->DM_lexer->token.token_id == colon, 
+                "Error on line %ld in %s.\n\tExpected `:` after \"liked_size\".\n", 
+                invalid_grammar_error, p->DM_lexer->line, p->DM_lexer->path)
+
+            DM_parser_get_next_token(p);
+            lang_assert(p->DM_lexer->token.token_id == decimal || p->DM_lexer->token.token_id == hex,
+                "Error on line %ld in %s.\n\tExpected the amount of memory for \"liked_size\".\n\tInstead got %s.\n",
+                unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+
+            /* Preset data already decides the size. */
+            if(!(program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_size))
+                assign_PD_var_size(strtol(nT8_PCC p->DM_lexer->token.token_value, NULL, 0));
+            return 0;
+        }
+        default: {
+            lang_error("Error on line %ld in %s.\n\tExpected `store_in`, `type`, `preset_data` or `liked_size`.\n\tInstead got %s.\n",
+                unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+        }
+    }
+}
+
+/* Parse the `key: value, ...` of a PD variable, up to(not past) its closing `}`.
+ * A field with an error is left out, parsing carries on with the next line.
+ * */
+static void parse_PD_var_fields(_DotMemParser *p)
 {
+    jmp_buf recovery;
+    volatile uT8 parts = 0;
+    volatile enum dot_mem_tokens type = DM_DEF;
+    volatile bool checked = false;
+
+    jmp_buf *outer = catch_errors(&recovery);
+    if(setjmp(recovery)) skip_failed_mem_line(p, true);
+
+    while(p->DM_lexer->token.token_id != right_brack && p->DM_lexer->token.token_id != DM_EOF)
+    {
+        enum dot_mem_tokens field_type = type;
+
+        parts |= parse_PD_var_field(p, &field_type);
+        type = field_type;
+
+        DM_parser_get_next_token(p);
+        if(p->DM_lexer->token.token_id == comma)
+        {
+            DM_parser_get_next_token(p);
+            continue;
+        }
+
+        lang_assert(p->DM_lexer->token.token_id == right_brack,
+            "Error on line %ld in %s.\n\tExpected `,` or `}` after a part of \"%s\".\n\tInstead got %s.\n",
+            missing_parts_error, p->DM_lexer->line, p->DM_lexer->path, get_curr_PD_var_name(), p->DM_lexer->token.token_value)
+    }
+
+    /* Checked once, an error here comes back to `recovery` with the `}` kept. */
+    if(p->DM_lexer->token.token_id == right_brack && !(checked))
+    {
+        checked = true;
+        lang_assert(parts == (PD_has_store_in | PD_has_type),
+            "Error on line %ld in %s.\n\tMissing: %s%s%s for \"%s\".\n",
+            missing_parts_error, p->DM_lexer->line, p->DM_lexer->path,
+            parts & PD_has_store_in ? "" : "store_in (data, rodata or stack)",
+            parts ? "" : ", ",
+            parts & PD_has_type ? "" : "type (byte, word or dword)", get_curr_PD_var_name())
+    }
+
+    stop_catching_errors(outer);
+
+    lang_assert(p->DM_lexer->token.token_id == right_brack,
+        "Error on line %ld in %s.\n\tExpected `}` at end of \"%s\".\n",
+        unexpected_EOF, p->DM_lexer->line, p->DM_lexer->path, get_curr_PD_var_name())
+}
+
+/* `sections: { variable name: { ... } ... }`. Leaves the closing `}` as the current token.
+ * A variable with an error in `variable name: {` is left out as a whole, up to the `}` ending it.
+ * */
+static void parse_sections(_DotMemParser *p)
+{
+    jmp_buf recovery;
+    volatile bool in_header = false;
+
+    DM_parser_get_next_token(p);
+    lang_assert(p->DM_lexer->token.token_id == colon, 
+        "Error on line %ld in %s.\n\tExpected `:` after \"sections\".\n", 
+        invalid_grammar_error, p->DM_lexer->line, p->DM_lexer->path)
+
+    DM_parser_get_next_token(p);
+    lang_assert(p->DM_lexer->token.token_id == left_brack, 
+        "Error on line %ld in %s.\n\tExpected `{` following `:`.\n\tInstead got %s.\n",
+        unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+
+    jmp_buf *outer = catch_errors(&recovery);
+    if(setjmp(recovery))
+    {
+        skip_failed_mem_line(p, true);
+
+        if(in_header)
+        {
+            in_header = false;
+            while(p->DM_lexer->token.token_id != right_brack && p->DM_lexer->token.token_id != DM_EOF)
+                skip_failed_mem_line(p, false);
+
+            DM_parser_get_next_token(p);
+        }
+    }
+    else DM_parser_get_next_token(p);
+
+    while(p->DM_lexer->token.token_id != right_brack && p->DM_lexer->token.token_id != DM_EOF)
+    {
+        lang_assert(p->DM_lexer->token.token_id == variable_KW,
+            "Error on line %ld in %s.\n\tExpected `variable` in \"sections\" block.\n\tInstead got %s.\n",
+            unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+
+        in_header = true;
+        DM_parser_get_next_token(p);
+
+        /* Make sure there is memory. */
+        if(!(program_memory_info->PD_vars)) try_init_PD_vars();
+        else create_next_PD_var_element();
+
+        /* Assign the new PD variable name. */
+        assign_PD_var_name(p->DM_lexer->token.token_value);
+
+        DM_parser_get_next_token(p);
+        lang_assert(p->DM_lexer->token.token_id == colon, 
+            "Error on line %ld in %s.\n\tExpected `:` after \"%s\".\n", 
+            invalid_grammar_error, p->DM_lexer->line, p->DM_lexer->path, get_curr_PD_var_name())
+        
+        DM_parser_get_next_token(p);
+        lang_assert(p->DM_lexer->token.token_id == left_brack,
+            "Error on line %ld in %s.\n\tExpected `{` after `:`.\n\tInstead got %s.\n",
+            invalid_grammar_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+
+        in_header = false;
+        DM_parser_get_next_token(p);
+        parse_PD_var_fields(p);
+        DM_parser_get_next_token(p);
+    }
+
+    stop_catching_errors(outer);
+
+    lang_assert(p->DM_lexer->token.token_id == right_brack, 
+        "Error on line %ld in %s.\n\tExpected `}` at end of \"sections\" block.\n\tInstead got %s.\n",
+        unexpect_value_error, p->DM_lexer->line, p->DM_lexer->path, p->DM_lexer->token.token_value)
+}
+
+/* Parse a `.mem` file into `program_memory_info`.
+ * Errors are recorded at the `#incmem` that included the file, after each one parsing carries on with
+ * the next line(see `diagnostics.h`).
+ * */
+void run_dot_mem_parser(_compiler_context *context, _source_buffer *src_code, uT8 *DM_path)
+{
+    jmp_buf recovery;
+
+    use_compiler_context(context);
+
+    /* Both are allocated from `front_end_arena`, and go with it. */
     _MemLexer *mem_lexer = init_dot_mem_lexer(src_code, DM_path);
     _DotMemParser *mem_parser = init_dot_mem_parser(mem_lexer);
 
-    /* Make sure the lexer and parser got allocated accordingly. */
-    lang_assert(mem_lexer,
-        "Error allocating memory for Dot Mem lexer.\n\tTry rerunning the program.\n",
-        OOC_allocation_error)
-    lang_assert(mem_parser,
-        "Error allocating memory for Dot Mem parser.\n\tTry rerunning the program.\n",
-        OOC_allocation_error)
-    
-    DM_parser_get_next_token(mem_parser);
+    jmp_buf *outer = catch_errors(&recovery);
+    if(setjmp(recovery)) skip_failed_mem_line(mem_parser, false);
+    else DM_parser_get_next_token(mem_parser);
 
     while(mem_parser->DM_lexer->token.token_id != DM_EOF)
     {
@@ -98,7 +337,7 @@ void run_dot_mem_parser(uT8 *src_code, uT8 *DM_path)
             case program_size_KW: {
                 DM_parser_get_next_token(mem_parser);
                 lang_assert(mem_parser->DM_lexer->token.token_id == colon, 
-                    "Error on line %d in %s.\n\tExpected `:` after \"program_size\".\n", 
+                    "Error on line %ld in %s.\n\tExpected `:` after \"program_size\".\n", 
                     invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
                 DM_parser_get_next_token(mem_parser);
 
@@ -107,7 +346,7 @@ void run_dot_mem_parser(uT8 *src_code, uT8 *DM_path)
 
                 /* If we get `t_unknown` that means there was a value, but it is not valud. */
                 lang_assert(mem_parser->DM_lexer->token.token_id != t_unknown, 
-                    "Error on line %d in %s.\n\tExpected `B` (bytes), `M` (MB) or `G` (GB) after specifying program size.\n\tInstead got: %s\n\n\tMax Byte Size (Per Program): 0x100000 (1,048,576)\n\tMax  MB  Size (Per Program): 0x400 (1024)\n\tMax  GB  Size (Per Program): 0x1 (1024MB, 1,048,576 Bytes)\n",
+                    "Error on line %ld in %s.\n\tExpected `B` (bytes), `M` (MB) or `G` (GB) after specifying program size.\n\tInstead got: %s\n\n\tMax Byte Size (Per Program): 0x100000 (1,048,576)\n\tMax  MB  Size (Per Program): 0x400 (1024)\n\tMax  GB  Size (Per Program): 0x1 (1024MB, 1,048,576 Bytes)\n",
                     missing_mem_size_type_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path, mem_parser->DM_lexer->token.token_value)
                 
                 /* TODO: Witht he above assertion, do we need the following assertion?
@@ -116,7 +355,7 @@ void run_dot_mem_parser(uT8 *src_code, uT8 *DM_path)
                 lang_assert(mem_parser->DM_lexer->token.token_id == t_bytes ||
                             mem_parser->DM_lexer->token.token_id == t_mb ||
                             mem_parser->DM_lexer->token.token_id == t_gb,
-                            "Error on line %d in %s.\n\tExpected `B` (bytes), `M` (MB) or `G` (GB) after specifying program size.\n\n\tMax Byte Size (Per Program): 0x100000 (1,048,576)\n\tMax  MB  Size (Per Program): 0x400 (1024)\n\tMax  GB  Size (Per Program): 0x1 (1024MB, 1,048,576 Bytes)\n", missing_mem_size_type_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
+                            "Error on line %ld in %s.\n\tExpected `B` (bytes), `M` (MB) or `G` (GB) after specifying program size.\n\n\tMax Byte Size (Per Program): 0x100000 (1,048,576)\n\tMax  MB  Size (Per Program): 0x400 (1024)\n\tMax  GB  Size (Per Program): 0x1 (1024MB, 1,048,576 Bytes)\n", missing_mem_size_type_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
 
                 
                 switch(mem_parser->DM_lexer->token.token_id)
@@ -160,7 +399,7 @@ void run_dot_mem_parser(uT8 *src_code, uT8 *DM_path)
                     default: break;
                 }
                 
-                /*lang_assert(mem_parser->DM_lexer->token.token_id == colon, "Expected `:` after \"program_size\" on line %d in %s.\n", invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
+                /*lang_assert(mem_parser->DM_lexer->token.token_id == colon, "Expected `:` after \"program_size\" on line %ld in %s.\n", invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
 
                 DM_parser_get_next_token(mem_parser);
                 DM_parser_get_next_token(mem_parser);
@@ -170,7 +409,7 @@ void run_dot_mem_parser(uT8 *src_code, uT8 *DM_path)
             case stack_access_KW: {
                 DM_parser_get_next_token(mem_parser);
                 lang_assert(mem_parser->DM_lexer->token.token_id == colon, 
-                    "Error on line %d in %s.\n\tExpected `:` after \"stack_access\".\n", 
+                    "Error on line %ld in %s.\n\tExpected `:` after \"stack_access\".\n", 
                     invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
 
                 DM_parser_get_next_token(mem_parser);
@@ -178,138 +417,23 @@ void run_dot_mem_parser(uT8 *src_code, uT8 *DM_path)
                 /* Make sure we got `true` or `false`. */
                 lang_assert(mem_parser->DM_lexer->token.token_id == boolean_true ||
                             mem_parser->DM_lexer->token.token_id == boolean_false,
-                            "Error on line %d in %s.\n\tExpected `true` or `false` for \"stack_access\".\n\tInstead got %s.\n", unexpect_value_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path, mem_parser->DM_lexer->token.token_value)
+                            "Error on line %ld in %s.\n\tExpected `true` or `false` for \"stack_access\".\n\tInstead got %s.\n", unexpect_value_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path, mem_parser->DM_lexer->token.token_value)
                 
                 if(mem_parser->DM_lexer->token.token_id == boolean_true) program_memory_info->stack_access = true;
                 else program_memory_info->stack_access = false;
 
                 break;
             }
-            case sections_KW: {
-                DM_parser_get_next_token(mem_parser);
-                lang_assert(mem_parser->DM_lexer->token.token_id == colon, 
-                    "Error on line %d in %s.\n\tExpected `:` after \"sections\".\n", 
-                    invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
-
-                DM_parser_get_next_token(mem_parser);
-                lang_assert(mem_parser->DM_lexer->token.token_id == left_brack, 
-                    "Error on line %d in %s.\n\tExpected `{` following `:`.\n\tInstead got %s.\n",
-                    unexpect_value_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path, mem_parser->DM_lexer->token.token_value)
-                
-                DM_parser_get_next_token(mem_parser);
-                switch(mem_parser->DM_lexer->token.token_id)
-                {
-                    case variable_KW: {
-                        DM_parser_get_next_token(mem_parser);
-
-                        /* Make sure there is memory. */
-                        try_init_PD_vars();
-
-                        /* Assign the new PD variable name. */
-                        assign_PD_var_name(mem_parser->DM_lexer->token.token_value);
-
-                        DM_parser_get_next_token(mem_parser);
-                        lang_assert(mem_parser->DM_lexer->token.token_id == colon, 
-                            "Error on line %d in %s.\n\tExpected `:` after \"%s\".\n", 
-                            invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path, get_curr_PD_var_name())
-                        
-                        DM_parser_get_next_token(mem_parser);
-                        lang_assert(mem_parser->DM_lexer->token.token_id == left_brack,
-                            "Error on line %d in %s.\n\tExpected `{` after `:`.\n\tInstead got %s.\n",
-                            invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path, mem_parser->DM_lexer->token.token_value)
-
-                        DM_parser_get_next_token(mem_parser);
-                        
-                        redo:
-                        switch(mem_parser->DM_lexer->token.token_id)
-                        {
-                            case store_in_KW: {
-                                DM_parser_get_next_token(mem_parser);
-                                lang_assert(mem_parser->DM_lexer->token.token_id == colon, 
-                                    "Error on line %d in %s.\n\tExpected `:` after \"store_in\".\n", 
-                                    invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
-                                
-                                DM_parser_get_next_token(mem_parser);
-                                assign_PD_storage_place(mem_parser->DM_lexer->token.token_id);
-                                DM_parser_get_next_token(mem_parser);
-                                lang_assert(mem_parser->DM_lexer->token.token_id == comma,
-                                    "Error on line %d in %s.\n\tMissing: type(byte, word or dword), preset_data (can be \"none\"), liked_size (amount of memory you'd like the PD Variable to take up).\n",
-                                    missing_parts_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
-                                
-                                DM_parser_get_next_token(mem_parser);
-                                lang_assert(mem_parser->DM_lexer->token.token_id != right_brack,
-                                    "Error on line %d in %s.\n\tMissing: type (byte, word or dword), preset_data (can be \"none\"), liked_size (amount of memory you'd like the PD Variable to take up).\n",
-                                    missing_parts_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
-                                
-                                goto redo;
-                                break;
-                            }
-                            case type_KW: {
-                                DM_parser_get_next_token(mem_parser);
-                                lang_assert(mem_parser->DM_lexer->token.token_id == colon, 
-                                    "Error on line %d in %s.\n\tExpected `:` after \"type\".\n", 
-                                    invalid_grammar_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
-                                
-                                DM_parser_get_next_token(mem_parser);
-                                lang_assert(mem_parser->DM_lexer->token.token_id == byte_KW ||
-                                            mem_parser->DM_lexer->token.token_id == word_KW ||
-                                            mem_parser->DM_lexer->token.token_id == dword_KW,
-                                            "Error on line %d in %s.\n\tExpected `byte`, `word` or `dword`.\n\tInstead found %s.\n",
-                                            unexpect_value_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path, mem_parser->DM_lexer->token.token_value)
-                                
-                                
-                                switch(mem_parser->DM_lexer->token.token_id)
-                                {
-                                    case byte_KW: {
-                                        /* The PD variable will access memory a byte at a time. */
-                                        DM_parser_get_next_token(mem_parser);
-                                        lang_assert(mem_parser->DM_lexer->token.token_id == comma,
-                                            "Error on line %d in %s.\n\tMissing: preset_data (can be \"none\"), liked_size (amount of memory you'd like the PD Variable to take up).\n",
-                                            missing_parts_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path)
-                                        
-                                        DM_parser_get_next_token(mem_parser);
-
-                                        if(mem_parser->DM_lexer->token.token_id == preset_data_KW)
-                                            parse_preset_data_for_byte(mem_parser);
-                                        break;
-                                    }
-                                    case word_KW: {
-
-                                        break;
-                                    }
-                                    case dword_KW: {
-                                        
-                                        break;
-                                    }
-                                    default: break;
-                                }
-
-                                break;
-                            }
-                            default: break;
-                        }
-
-                        exit(0);
-                        break;
-                    }
-                    default: break;
-                }
-                exit(0);
-                
-                DM_parser_get_next_token(mem_parser);
-                lang_assert(mem_parser->DM_lexer->token.token_id == right_brack, 
-                    "Error on line %d in %s.\n\tExpected `}` at end of \"sections\" block.\n\tInstead got %s.\n",
+            case sections_KW: parse_sections(mem_parser);break;
+            default: {
+                lang_error("Error on line %ld in %s.\n\tExpected `program_size`, `stack_access` or `sections`.\n\tInstead got %s.\n",
                     unexpect_value_error, mem_parser->DM_lexer->line, mem_parser->DM_lexer->path, mem_parser->DM_lexer->token.token_value)
-            
-                exit(0);
             }
-            default: exit(0); break;
         }
         DM_parser_get_next_token(mem_parser);
     }
 
-    free(mem_lexer);
-    free(mem_parser);
+    stop_catching_errors(outer);
 }
 
 #endif
\ No newline at end of file
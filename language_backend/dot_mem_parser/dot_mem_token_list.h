@@ -0,0 +1,47 @@
+#ifndef dot_mem_token_list
+#define dot_mem_token_list
+
+/* Tokens of the `.mem` lexer.
+ * Kept apart from the lexer so the keyword table(see `keywords/keywords.def`) can refer to them.
+ * */
+enum dot_mem_tokens
+{
+    DM_DEF,
+    program_size_KW,
+    require_var_inits_KW,
+    stack_access_KW,
+    sections_KW,
+    variable_KW,
+    store_in_KW,
+    colon,
+    comma,
+    left_par,
+    right_par,
+    left_brack,
+    right_brack,
+    decimal,
+    hex,
+    boolean_true,
+    boolean_false,
+    DM_word,
+    DM_EOF,
+    t_bytes,
+    t_mb,
+    t_gb,
+    t_unknown,
+    data_KW = 0x20,
+    rodata_KW = 0x21,
+    stack_KW = 0x22,
+    type_KW,
+    preset_data_KW,
+    liked_size_KW,
+    byte_KW,
+    word_KW,
+    dword_KW,
+    none_KW,
+    emptyArray_builtin,
+    byteArray_builtin,
+    char_value,
+};
+
+#endif
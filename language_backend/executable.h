@@ -0,0 +1,560 @@
+#ifndef executable_emission
+#define executable_emission
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <elf.h>
+
+/* Where the executable is loaded(it is not position independent), and the page size its segments are laid out for. */
+#define executable_base     0x400000
+#define executable_page     0x1000
+
+/* Sections of the executable, in the order of its section headers. */
+enum executable_sections
+{
+    section_none = 0x0,
+    section_text,
+    section_rodata,
+    section_data,
+    section_bss,
+    section_symtab,
+    section_strtab,
+    section_shstrtab,
+
+    section_amount
+};
+
+/* Size of the buffer the output is collected in(in `.bss`), it is written to `stdout` when it fills up and when the program ends. */
+#define executable_output_size  0x10000
+
+/* The routines the code of the program calls, at the start of `.text`. They keep the output collected so far in
+ * `[r14, r12)`, `r13` is the end of the buffer. Each clobbers `rax`, `rcx`, `rdx`, `rsi`, `rdi`, `r8` and `r11`.
+ * */
+static const uT8 executable_routines[] = {
+    /* flush: write the buffer, then empty it. */
+    0x4C, 0x89, 0xF6,                       // mov rsi, r14
+    0x4C, 0x89, 0xE2,                       // mov rdx, r12
+    0x4C, 0x29, 0xF2,                       // sub rdx, r14
+    0x4D, 0x89, 0xF4,                       // mov r12, r14
+    /* write_all: write the `rdx` bytes at `rsi`(`write` may take less than all of them at once). */
+    0x48, 0x85, 0xD2,                       // test rdx, rdx
+    0x74, 0x1F,                             // jz done
+    0xBF, 0x01, 0x00, 0x00, 0x00,           // mov edi, 1(stdout)
+    0xB8, 0x01, 0x00, 0x00, 0x00,           // mov eax, 1(write)
+    0x0F, 0x05,                             // syscall
+    0x48, 0x83, 0xF8, 0xFC,                 // cmp rax, -EINTR
+    0x74, 0xE9,                             // je write_all
+    0x48, 0x85, 0xC0,                       // test rax, rax
+    0x7E, 0x08,                             // jle done(nothing more can be written)
+    0x48, 0x01, 0xC6,                       // add rsi, rax
+    0x48, 0x29, 0xC2,                       // sub rdx, rax
+    0xEB, 0xDC,                             // jmp write_all
+    0xC3,                                   // done: ret
+
+    /* print_line: print the `rdx` bytes at `rsi`, and a newline. Too many for the buffer are written as they are. */
+    0x49, 0x8D, 0x04, 0x14,                 // lea rax, [r12 + rdx]
+    0x4C, 0x39, 0xE8,                       // cmp rax, r13
+    0x72, 0x19,                             // jb copy
+    0x56, 0x52,                             // push rsi, push rdx
+    0xE8, 0xBF, 0xFF, 0xFF, 0xFF,           // call flush
+    0x5A, 0x5E,                             // pop rdx, pop rsi
+    0x49, 0x8D, 0x04, 0x14,                 // lea rax, [r12 + rdx]
+    0x4C, 0x39, 0xE8,                       // cmp rax, r13
+    0x72, 0x07,                             // jb copy
+    0xE8, 0xBB, 0xFF, 0xFF, 0xFF,           // call write_all
+    0xEB, 0x0B,                             // jmp newline
+    0x4C, 0x89, 0xE7,                       // copy: mov rdi, r12
+    0x48, 0x89, 0xD1,                       // mov rcx, rdx
+    0xF3, 0xA4,                             // rep movsb
+    0x49, 0x89, 0xFC,                       // mov r12, rdi
+    0x41, 0xC6, 0x04, 0x24, 0x0A,           // newline: mov byte [r12], '\n'
+    0x49, 0xFF, 0xC4,                       // inc r12
+    0xC3,                                   // ret
+
+    /* print_string: print the string at `rdx`(the empty string if it is 0), and a newline. */
+    0x31, 0xC0,                             // xor eax, eax
+    0x48, 0x85, 0xD2,                       // test rdx, rdx
+    0x74, 0x1A,                             // jz empty
+    0x48, 0x89, 0xD6,                       // mov rsi, rdx
+    0x48, 0x89, 0xD7,                       // mov rdi, rdx
+    0x48, 0xC7, 0xC1, 0xFF, 0xFF, 0xFF, 0xFF,   // mov rcx, -1
+    0xF2, 0xAE,                             // repne scasb
+    0x48, 0x89, 0xFA,                       // mov rdx, rdi
+    0x48, 0x29, 0xF2,                       // sub rdx, rsi
+    0x48, 0xFF, 0xCA,                       // dec rdx
+    0xEB, 0xA9,                             // jmp print_line
+    0x48, 0x89, 0xD6,                       // empty: mov rsi, rdx
+    0xEB, 0xA4,                             // jmp print_line
+
+    /* print_hex, print_integer: print `rdx` like `format_number` does, and a newline. */
+    0x41, 0xB8, 0x10, 0x00, 0x00, 0x00,     // print_hex: mov r8d, 16
+    0xEB, 0x06,                             // jmp print_number
+    0x41, 0xB8, 0x0A, 0x00, 0x00, 0x00,     // print_integer: mov r8d, 10
+    0x48, 0x89, 0xD0,                       // print_number: mov rax, rdx
+    0x48, 0x83, 0xEC, 0x18,                 // sub rsp, 24
+    0x48, 0x8D, 0x74, 0x24, 0x18,           // lea rsi, [rsp + 24]
+    0x31, 0xD2,                             // digit: xor edx, edx
+    0x49, 0xF7, 0xF0,                       // div r8
+    0x80, 0xC2, 0x30,                       // add dl, '0'
+    0x80, 0xFA, 0x39,                       // cmp dl, '9'
+    0x76, 0x03,                             // jbe put
+    0x80, 0xC2, 0x07,                       // add dl, 'A' - '9' - 1
+    0x48, 0xFF, 0xCE,                       // put: dec rsi
+    0x88, 0x16,                             // mov [rsi], dl
+    0x48, 0x85, 0xC0,                       // test rax, rax
+    0x75, 0xE6,                             // jnz digit
+    0x41, 0x83, 0xF8, 0x10,                 // cmp r8d, 16
+    0x75, 0x09,                             // jne formatted
+    0x48, 0x83, 0xEE, 0x02,                 // sub rsi, 2
+    0x66, 0xC7, 0x06, 0x30, 0x78,           // mov word [rsi], "0x"
+    0x48, 0x8D, 0x54, 0x24, 0x18,           // formatted: lea rdx, [rsp + 24]
+    0x48, 0x29, 0xF2,                       // sub rdx, rsi
+    0xE8, 0x54, 0xFF, 0xFF, 0xFF,           // call print_line
+    0x48, 0x83, 0xC4, 0x18,                 // add rsp, 24
+    0xC3                                    // ret
+};
+
+/* Where each of `executable_routines` starts. */
+enum executable_routine_offsets
+{
+    routine_flush = 0x00,
+    routine_print_line = 0x31,
+    routine_print_string = 0x67,
+    routine_print_hex = 0x8D,
+    routine_print_integer = 0x95
+};
+
+/* An absolute address in the code, of `offset` in `section`. Filled in once the sections are laid out. */
+typedef struct executable_fixup
+{
+    uSIZE       at;
+    uSIZE       offset;
+    uT16        section;
+} _executable_fixup;
+
+/* A section of the executable while it is put together, or the file itself. */
+typedef struct executable_part
+{
+    uT8         *data;
+    uSIZE       size;
+    uSIZE       capacity;
+} _executable_part;
+
+/* Append `size` bytes to `part`(zeros if `data` is NULL), on a multiple of `alignment`. Returns their offset. */
+static uSIZE executable_put(_executable_part *part, const void *data, uSIZE size, uSIZE alignment)
+{
+    uSIZE offset = (part->size + alignment - 1) & ~(alignment - 1);
+
+    if(offset + size > part->capacity)
+    {
+        while(offset + size > part->capacity) part->capacity = part->capacity ? part->capacity * 2 : 0x1000;
+
+        part->data = realloc(part->data, part->capacity);
+        lang_assert(part->data,
+            "Error allocating memory for the executable.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    memset(&part->data[part->size], 0, offset - part->size);
+    if(data) memcpy(&part->data[offset], data, size);
+    else memset(&part->data[offset], 0, size);
+    part->size = offset + size;
+
+    return offset;
+}
+
+/* Add a symbol named `name` to `symtab`(the name goes to `strtab`). */
+static void add_executable_symbol(_executable_part *symtab, _executable_part *strtab, const nT8 *name,
+    uT16 section, uSIZE address, uSIZE size, uT8 info)
+{
+    Elf64_Sym symbol = {
+        .st_name = executable_put(strtab, name, strlen(name) + 1, 1),
+        .st_info = info,
+        .st_shndx = section,
+        .st_value = address,
+        .st_size = size
+    };
+
+    executable_put(symtab, &symbol, sizeof(symbol), 1);
+}
+
+/* Append machine code to `part`. */
+#define executable_code(part, ...)  executable_put(part, (const uT8[]) { __VA_ARGS__ }, sizeof((const uT8[]) { __VA_ARGS__ }), 1)
+
+/* Append `value` to the code in `text`. */
+static void executable_u32(_executable_part *text, uT32 value)
+{
+    executable_put(text, &value, sizeof(value), 1);
+}
+
+/* Append the address of `offset` in `section` to the code in `text`(see `_executable_fixup`). */
+static void executable_address(_executable_part *text, _executable_part *fixups, uT16 section, uSIZE offset)
+{
+    _executable_fixup fixup = { .at = executable_put(text, NULL, sizeof(uT32), 1), .offset = offset, .section = section };
+
+    executable_put(fixups, &fixup, sizeof(fixup), 1);
+}
+
+/* `call` the routine at `routine`(see `executable_routines`). */
+static void executable_call(_executable_part *text, uSIZE routine)
+{
+    executable_code(text, 0xE8);
+    executable_u32(text, routine - (text->size + sizeof(uT32)));
+}
+
+/* Print the `length` bytes at `offset` in `.rodata`, and a newline. */
+static void executable_print_rodata(_executable_part *text, _executable_part *fixups, uSIZE offset, uT32 length)
+{
+    executable_code(text, 0xBE);                                // mov esi, address
+    executable_address(text, fixups, section_rodata, offset);
+    executable_code(text, 0xBA);                                // mov edx, length
+    executable_u32(text, length);
+    executable_call(text, routine_print_line);
+}
+
+/* Print the double at `offset` in `constants`, as `run_bytecode` does. There is no `printf` to format it with when the program
+ * runs, so its text is made now and put in `rodata`.
+ * */
+static void executable_print_float(_executable_part *text, _executable_part *fixups, _executable_part *rodata,
+    _constant_pool *constants, uT32 offset)
+{
+    nT8 number[32];
+    double value;
+
+    memcpy(&value, &constants->rodata[offset], sizeof(value));
+    uT32 length = snprintf(number, sizeof(number), "%.15g", value);
+    executable_print_rodata(text, fixups, executable_put(rodata, number, length, 1), length);
+}
+
+/* End the program with `status`: write what is left of the output, then `exit_group`. */
+static void executable_exit(_executable_part *text, uT32 status)
+{
+    executable_call(text, routine_flush);
+    executable_code(text, 0xBF);                                // mov edi, status
+    executable_u32(text, status);
+    executable_code(text, 0xB8, 0xE7, 0x00, 0x00, 0x00);        // mov eax, 231(exit_group)
+    executable_code(text, 0x0F, 0x05);                          // syscall
+}
+
+/* Write `program`, with the constants `constants` and the memory layout `memory`, as a static x86-64 Linux
+ * executable at `path`. No assembler, linker or C library is involved, and the executable needs none to run.
+ *
+ * `program` is compiled to machine code much like `compile_jit` does: variables are `[rbx + slot * 8]`, in `.bss`,
+ * the value the bytecode keeps in its accumulator is kept in `r15`, and the output is collected in a buffer in `.bss`
+ * (see `executable_routines`). Numbers and strings are read from the literals of the program(see `constants.h`) in
+ * `.rodata`, a string variable holds the address of its literal there. Only doubles are formatted here(see
+ * `executable_print_float`), their texts go in `.rodata` too.
+ *
+ * The sections follow the `.mem` file(see `mem_outline.h`): `.rodata` has the literals, the `T_rodata` PD variables
+ * and the texts, `.data` the `T_data` PD variables with preset data and `.bss` the variables of the program, the
+ * output buffer and the `T_data` PD variables without. `T_stack_based` PD variables take no room in the file.
+ * Every PD variable that does has a symbol, as do the literals, the variables, the output buffer, the routines and `_start`.
+ * */
+void write_executable(_bytecode *program, _constant_pool *constants, _memory_info *memory, const nT8 *path)
+{
+    /* The sections, and where in them each PD variable went. */
+    _executable_part text = { 0 }, rodata = { 0 }, data = { 0 }, fixups = { 0 };
+
+    uT32 PD_vars = memory && memory->PD_vars ? memory->PD_vars_size + 1 : 0;
+    uSIZE *PD_offsets = calloc(PD_vars + 1, sizeof(*PD_offsets));
+    lang_assert(PD_offsets,
+        "Error allocating memory for the executable.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    /* `.bss` starts with the variables, then the output buffer. */
+    uSIZE slots_at = 0;
+    uSIZE buffer_at = ((uSIZE) program->slots * sizeof(uSIZE) + 0x0F) & ~0x0FULL;
+    uSIZE bss = buffer_at + executable_output_size;
+
+    uSIZE literals = executable_put(&rodata, constants->rodata, constants->rodata_size, 0x10);
+    for(uT32 i = 0; i < PD_vars; i++)
+    {
+        _predefined_variables *var = memory->PD_vars[i];
+
+        switch(var->PD_var_type)
+        {
+            case T_rodata: PD_offsets[i] = executable_put(&rodata, PD_var_bytes(var), var->PD_var_size, 0x08);break;
+            case T_data: {
+                if(PD_var_bytes(var))
+                {
+                    PD_offsets[i] = executable_put(&data, PD_var_bytes(var), var->PD_var_size, 0x08);
+                    break;
+                }
+
+                /* Placed after `.data` once its size is known, see below. */
+                bss = (bss + 0x07) & ~0x07ULL;
+                PD_offsets[i] = bss;
+                bss += var->PD_var_size;
+                break;
+            }
+            default: break;
+        }
+    }
+    uSIZE texts = rodata.size;
+
+    /* `.text`: the routines, then `_start`. */
+    executable_put(&text, executable_routines, sizeof(executable_routines), 1);
+    uSIZE start = executable_put(&text, NULL, 0, 0x10);
+
+    executable_code(&text, 0xBB);                                       // mov ebx, slots
+    executable_address(&text, &fixups, section_bss, slots_at);
+    executable_code(&text, 0x41, 0xBE);                                 // mov r14d, buffer
+    executable_address(&text, &fixups, section_bss, buffer_at);
+    executable_code(&text, 0x4D, 0x89, 0xF4);                           // mov r12, r14
+    executable_code(&text, 0x4D, 0x8D, 0xAE);                           // lea r13, [r14 + size]
+    executable_u32(&text, executable_output_size);
+    executable_code(&text, 0x45, 0x31, 0xFF);                           // xor r15d, r15d
+
+    for(uT32 at = 0; at < program->size; at += instruction_size(program->code[at]))
+    {
+        const uT8 *instruction = &program->code[at];
+        uT32 first = opcode_operands[*instruction] ? instruction_operand(instruction, 0) : 0;
+        uT32 second = opcode_operands[*instruction] > 1 ? instruction_operand(instruction, 1) : 0;
+
+        switch(*instruction)
+        {
+            /* Prints of constants. */
+            case op_print_string_constant: executable_print_rodata(&text, &fixups, literals + first, second);break;
+            case op_print_integer_constant:
+            case op_print_hex_constant: {
+                executable_code(&text, 0x48, 0x8B, 0x14, 0x25);         // mov rdx, [number]
+                executable_address(&text, &fixups, section_rodata, literals + first);
+                executable_call(&text, *instruction == op_print_hex_constant ? routine_print_hex : routine_print_integer);
+                break;
+            }
+            case op_print_float_constant: executable_print_float(&text, &fixups, &rodata, constants, first);break;
+
+            /* Declarations. */
+            case op_store_number: {
+                executable_code(&text, 0x48, 0x8B, 0x04, 0x25);         // mov rax, [number]
+                executable_address(&text, &fixups, section_rodata, literals + second);
+                executable_code(&text, 0x48, 0x89, 0x83);               // mov [rbx + slot * 8], rax
+                executable_u32(&text, first * sizeof(uSIZE));
+                break;
+            }
+            case op_store_string: {
+                executable_code(&text, 0xB8);                           // mov eax, string
+                executable_address(&text, &fixups, section_rodata, literals + second);
+                executable_code(&text, 0x48, 0x89, 0x83);               // mov [rbx + slot * 8], rax
+                executable_u32(&text, first * sizeof(uSIZE));
+                break;
+            }
+            case op_store_zero: {
+                executable_code(&text, 0x48, 0xC7, 0x83);               // mov qword [rbx + slot * 8], 0
+                executable_u32(&text, first * sizeof(uSIZE));
+                executable_u32(&text, 0);
+                break;
+            }
+
+            /* Prints of variables. */
+            case op_print_slot_string:
+            case op_print_slot_integer:
+            case op_print_slot_hex: {
+                executable_code(&text, 0x48, 0x8B, 0x93);               // mov rdx, [rbx + slot * 8]
+                executable_u32(&text, first * sizeof(uSIZE));
+                executable_call(&text, *instruction == op_print_slot_string ? routine_print_string :
+                                       *instruction == op_print_slot_hex ? routine_print_hex : routine_print_integer);
+                break;
+            }
+
+            /* The accumulator(bytecode that was not optimized). */
+            case op_load_number: {
+                executable_code(&text, 0x4C, 0x8B, 0x3C, 0x25);         // mov r15, [number]
+                executable_address(&text, &fixups, section_rodata, literals + first);
+                break;
+            }
+            case op_load_string: {
+                executable_code(&text, 0x41, 0xBF);                     // mov r15d, string
+                executable_address(&text, &fixups, section_rodata, literals + first);
+                break;
+            }
+            case op_load_zero: executable_code(&text, 0x45, 0x31, 0xFF);break;  // xor r15d, r15d
+            case op_load_slot: {
+                executable_code(&text, 0x4C, 0x8B, 0xBB);               // mov r15, [rbx + slot * 8]
+                executable_u32(&text, first * sizeof(uSIZE));
+                break;
+            }
+            case op_store_slot: {
+                executable_code(&text, 0x4C, 0x89, 0xBB);               // mov [rbx + slot * 8], r15
+                executable_u32(&text, first * sizeof(uSIZE));
+                break;
+            }
+            case op_print_string:
+            case op_print_integer:
+            case op_print_hex: {
+                executable_code(&text, 0x4C, 0x89, 0xFA);               // mov rdx, r15
+                executable_call(&text, *instruction == op_print_string ? routine_print_string :
+                                       *instruction == op_print_hex ? routine_print_hex : routine_print_integer);
+                break;
+            }
+            case op_print_float: executable_print_float(&text, &fixups, &rodata, constants, first);break;
+
+            case op_exit: executable_exit(&text, first);break;
+            default: executable_exit(&text, 0);break;                   // `op_halt`
+        }
+    }
+
+    /* Every segment starts on a page of its own, at an address that is its offset in the file plus a page for each segment before it. */
+    uT16 segments = 2 + (rodata.size > 0) + (data.size + bss > 0);
+    _executable_part file = { 0 };
+
+    executable_put(&file, NULL, sizeof(Elf64_Ehdr) + segments * sizeof(Elf64_Phdr), 1);
+    uSIZE text_offset = executable_put(&file, text.data, text.size, 0x10);
+    uSIZE rodata_offset = executable_put(&file, rodata.data, rodata.size, 0x10);
+    uSIZE data_offset = executable_put(&file, data.data, data.size, 0x10);
+
+    uSIZE text_address = executable_base + text_offset;
+    uSIZE rodata_address = executable_base + executable_page + rodata_offset;
+    uSIZE data_address = executable_base + executable_page * 2 + data_offset;
+    uSIZE bss_address = data_address + ((data.size + 0x0F) & ~0x0FULL);
+
+    /* Everything is below 2GB, so the addresses fit the 32 bit immediates they are written to. */
+    for(_executable_fixup *fixup = (_executable_fixup *) fixups.data; fixup < (_executable_fixup *) &fixups.data[fixups.size]; fixup++)
+    {
+        uT32 address = (fixup->section == section_bss ? bss_address : rodata_address) + fixup->offset;
+        memcpy(&file.data[text_offset + fixup->at], &address, sizeof(address));
+    }
+
+    /* Symbols: local ones first, then `_start`. */
+    _executable_part symtab = { 0 }, strtab = { 0 }, shstrtab = { 0 };
+    executable_put(&symtab, NULL, sizeof(Elf64_Sym), 1);
+    executable_put(&strtab, NULL, 1, 1);
+    executable_put(&shstrtab, NULL, 1, 1);
+
+    add_executable_symbol(&symtab, &strtab, "flush", section_text, text_address + routine_flush, routine_print_line - routine_flush, ELF64_ST_INFO(STB_LOCAL, STT_FUNC));
+    add_executable_symbol(&symtab, &strtab, "print_line", section_text, text_address + routine_print_line, routine_print_string - routine_print_line, ELF64_ST_INFO(STB_LOCAL, STT_FUNC));
+    add_executable_symbol(&symtab, &strtab, "print_string", section_text, text_address + routine_print_string, routine_print_hex - routine_print_string, ELF64_ST_INFO(STB_LOCAL, STT_FUNC));
+    add_executable_symbol(&symtab, &strtab, "print_hex", section_text, text_address + routine_print_hex, routine_print_integer - routine_print_hex, ELF64_ST_INFO(STB_LOCAL, STT_FUNC));
+    add_executable_symbol(&symtab, &strtab, "print_integer", section_text, text_address + routine_print_integer, sizeof(executable_routines) - routine_print_integer, ELF64_ST_INFO(STB_LOCAL, STT_FUNC));
+    add_executable_symbol(&symtab, &strtab, "literals", section_rodata, rodata_address + literals, constants->rodata_size, ELF64_ST_INFO(STB_LOCAL, STT_OBJECT));
+    add_executable_symbol(&symtab, &strtab, "texts", section_rodata, rodata_address + texts, rodata.size - texts, ELF64_ST_INFO(STB_LOCAL, STT_OBJECT));
+    add_executable_symbol(&symtab, &strtab, "variables", section_bss, bss_address + slots_at, (uSIZE) program->slots * sizeof(uSIZE), ELF64_ST_INFO(STB_LOCAL, STT_OBJECT));
+    add_executable_symbol(&symtab, &strtab, "output", section_bss, bss_address + buffer_at, executable_output_size, ELF64_ST_INFO(STB_LOCAL, STT_OBJECT));
+    for(uT32 i = 0; i < PD_vars; i++)
+    {
+        _predefined_variables *var = memory->PD_vars[i];
+        const nT8 *name = var->PD_var_name ? nT8_PCC var->PD_var_name : "";
+
+        switch(var->PD_var_type)
+        {
+            case T_rodata: add_executable_symbol(&symtab, &strtab, name, section_rodata, rodata_address + PD_offsets[i], var->PD_var_size, ELF64_ST_INFO(STB_LOCAL, STT_OBJECT));break;
+            case T_data: {
+                if(PD_var_bytes(var)) add_executable_symbol(&symtab, &strtab, name, section_data, data_address + PD_offsets[i], var->PD_var_size, ELF64_ST_INFO(STB_LOCAL, STT_OBJECT));
+                else add_executable_symbol(&symtab, &strtab, name, section_bss, bss_address + PD_offsets[i], var->PD_var_size, ELF64_ST_INFO(STB_LOCAL, STT_OBJECT));
+                break;
+            }
+            default: break;
+        }
+    }
+    uT32 first_global = symtab.size / sizeof(Elf64_Sym);
+    add_executable_symbol(&symtab, &strtab, "_start", section_text, text_address + start, text.size - start, ELF64_ST_INFO(STB_GLOBAL, STT_FUNC));
+
+    uSIZE symbols_offset = executable_put(&file, symtab.data, symtab.size, 0x08);
+    uSIZE names_offset = executable_put(&file, strtab.data, strtab.size, 1);
+
+    Elf64_Shdr sections[section_amount] = {
+        [section_text] = {
+            .sh_name = executable_put(&shstrtab, ".text", 6, 1), .sh_type = SHT_PROGBITS, .sh_flags = SHF_ALLOC | SHF_EXECINSTR,
+            .sh_addr = text_address, .sh_offset = text_offset, .sh_size = text.size, .sh_addralign = 0x10
+        },
+        [section_rodata] = {
+            .sh_name = executable_put(&shstrtab, ".rodata", 8, 1), .sh_type = SHT_PROGBITS, .sh_flags = SHF_ALLOC,
+            .sh_addr = rodata_address, .sh_offset = rodata_offset, .sh_size = rodata.size, .sh_addralign = 0x10
+        },
+        [section_data] = {
+            .sh_name = executable_put(&shstrtab, ".data", 6, 1), .sh_type = SHT_PROGBITS, .sh_flags = SHF_ALLOC | SHF_WRITE,
+            .sh_addr = data_address, .sh_offset = data_offset, .sh_size = data.size, .sh_addralign = 0x10
+        },
+        [section_bss] = {
+            .sh_name = executable_put(&shstrtab, ".bss", 5, 1), .sh_type = SHT_NOBITS, .sh_flags = SHF_ALLOC | SHF_WRITE,
+            .sh_addr = bss_address, .sh_offset = data_offset + (bss_address - data_address), .sh_size = bss, .sh_addralign = 0x10
+        },
+        [section_symtab] = {
+            .sh_name = executable_put(&shstrtab, ".symtab", 8, 1), .sh_type = SHT_SYMTAB,
+            .sh_offset = symbols_offset, .sh_size = symtab.size, .sh_link = section_strtab, .sh_info = first_global,
+            .sh_addralign = 0x08, .sh_entsize = sizeof(Elf64_Sym)
+        },
+        [section_strtab] = {
+            .sh_name = executable_put(&shstrtab, ".strtab", 8, 1), .sh_type = SHT_STRTAB,
+            .sh_offset = names_offset, .sh_size = strtab.size, .sh_addralign = 1
+        },
+        [section_shstrtab] = {
+            .sh_name = executable_put(&shstrtab, ".shstrtab", 10, 1), .sh_type = SHT_STRTAB, .sh_addralign = 1
+        }
+    };
+    sections[section_shstrtab].sh_offset = executable_put(&file, shstrtab.data, shstrtab.size, 1);
+    sections[section_shstrtab].sh_size = shstrtab.size;
+    uSIZE sections_offset = executable_put(&file, sections, sizeof(sections), 0x08);
+
+    /* The segments: the headers and `.text`, then `.rodata`, then `.data` and `.bss`, and a stack that is not executable. */
+    Elf64_Phdr *segment = (Elf64_Phdr *) &file.data[sizeof(Elf64_Ehdr)];
+    *segment++ = (Elf64_Phdr) {
+        .p_type = PT_LOAD, .p_flags = PF_R | PF_X, .p_offset = 0, .p_vaddr = executable_base, .p_paddr = executable_base,
+        .p_filesz = text_offset + text.size, .p_memsz = text_offset + text.size, .p_align = executable_page
+    };
+    if(rodata.size) *segment++ = (Elf64_Phdr) {
+        .p_type = PT_LOAD, .p_flags = PF_R, .p_offset = rodata_offset, .p_vaddr = rodata_address, .p_paddr = rodata_address,
+        .p_filesz = rodata.size, .p_memsz = rodata.size, .p_align = executable_page
+    };
+    if(data.size + bss) *segment++ = (Elf64_Phdr) {
+        .p_type = PT_LOAD, .p_flags = PF_R | PF_W, .p_offset = data_offset, .p_vaddr = data_address, .p_paddr = data_address,
+        .p_filesz = data.size, .p_memsz = bss ? (bss_address - data_address) + bss : data.size, .p_align = executable_page
+    };
+    *segment = (Elf64_Phdr) { .p_type = PT_GNU_STACK, .p_flags = PF_R | PF_W, .p_align = 0x10 };
+
+    Elf64_Ehdr header = {
+        .e_ident = { ELFMAG0, ELFMAG1, ELFMAG2, ELFMAG3, ELFCLASS64, ELFDATA2LSB, EV_CURRENT, ELFOSABI_SYSV },
+        .e_type = ET_EXEC,
+        .e_machine = EM_X86_64,
+        .e_version = EV_CURRENT,
+        .e_entry = text_address + start,
+        .e_phoff = sizeof(Elf64_Ehdr),
+        .e_shoff = sections_offset,
+        .e_ehsize = sizeof(Elf64_Ehdr),
+        .e_phentsize = sizeof(Elf64_Phdr),
+        .e_phnum = segments,
+        .e_shentsize = sizeof(Elf64_Shdr),
+        .e_shnum = section_amount,
+        .e_shstrndx = section_shstrtab
+    };
+    memcpy(file.data, &header, sizeof(header));
+
+    /* `rwxr-xr-x`, less what the `umask` takes away. */
+    nT32 fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0755);
+    uSIZE written = 0;
+
+    while(fd >= 0 && written < file.size)
+    {
+        sSIZE amount = write(fd, &file.data[written], file.size - written);
+
+        if(amount < 0 && errno == EINTR) continue;
+        if(amount <= 0) break;
+        written += amount;
+    }
+    if(fd >= 0) close(fd);
+
+    trace(TC_ast, TL_info, "Wrote a %llu byte executable, %llu bytes of it code", file.size, text.size);
+
+    free(text.data);
+    free(rodata.data);
+    free(data.data);
+    free(fixups.data);
+    free(PD_offsets);
+    free(symtab.data);
+    free(strtab.data);
+    free(shstrtab.data);
+    free(file.data);
+
+    lang_assert(fd >= 0 && written == file.size,
+        "Could not write the executable `%s`.\n",
+        executable_write_error, path)
+}
+#undef executable_code
+#else
+/* The code in the executable is x86-64, and it only talks to Linux. */
+void write_executable(_bytecode *program, _constant_pool *constants, _memory_info *memory, const nT8 *path)
+{
+    lang_error("Could not write the executable `%s`.\n\tExecutables are only written on x86-64 Linux.\n", executable_write_error, path)
+}
+#endif
+
+#endif
@@ -0,0 +1,473 @@
+#ifndef file_inclusion
+#define file_inclusion
+#include <pthread.h>
+
+/* Module an include refers to, while linking, when its file does not exist. */
+#define no_module       0xFFFFFFFF
+
+/* A file that is part of the program: the file being compiled(always the first module), or a file
+ * pulled in by `#include`.
+ * */
+typedef struct source_module
+{
+    /* Canonical path, and hash of the source code(0 for a streamed file being compiled). */
+    nT8             *path;
+    uSIZE           hash;
+    _source_buffer  *source;
+
+    /* The module is parsed as a compilation of its own, like the chunks of `parallel.h`.
+     * It keeps the ast, symbols and errors of the module until it is linked.
+     * The file being compiled has no context of its own, its ast is `nodes`.
+     * */
+    _compiler_context   *context;
+    _ast_tree       *nodes;
+
+    /* Has it been linked into `tree` yet? Only the first include of a module adds its nodes. */
+    bool            included;
+} _source_module;
+
+/* Every module of the program. */
+typedef struct module_set
+{
+    _source_module  *modules;
+    uT32            amount;
+    uT32            capacity;
+
+    /* Next module to be parsed, taken by the threads of `parse_modules`. */
+    uT32            next;
+
+    /* The compilation the modules are part of, and its line index. */
+    _compiler_context   *whole;
+    _line_index     *lines;
+
+    const nT8       *cache_directory;
+} _module_set;
+
+/* Does `tree` have an include that needs linking? Either one that never was, or one that was left out
+ * because its file was included earlier(an edit may have taken the earlier one away, see `incremental.h`).
+ * */
+static bool includes_need_linking()
+{
+    const uT8 *kind = tree.kind, *end = tree.kind + tree.amount;
+
+    while(kind < end && (kind = memchr(kind, include_statement, end - kind)))
+    {
+        uT32 node = kind - tree.kind;
+        if(tree.b[node] == include_pending || tree.b[node] == include_repeated) return true;
+        kind++;
+    }
+
+    return false;
+}
+
+/* Move `tree` to `main_tree`, leaving out whatever earlier links added, so every include is pending again. */
+static void detach_main_tree(_ast_tree *main_tree)
+{
+    unmap_ast_tree();
+    *main_tree = tree;
+    tree = (_ast_tree) { .state = ready };
+
+    uT32 *node_map = malloc(main_tree->amount * sizeof(*node_map) + 1);
+    lang_assert(node_map,
+        "Error allocating memory for linking the included files.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    /* Nodes only ever move back, so this is done in place. */
+    uT32 kept = 0;
+    for(uT32 node = 0; node < main_tree->amount; node++)
+    {
+        node_map[node] = kept;
+
+        main_tree->kind[kept] = main_tree->kind[node];
+        main_tree->a[kept] = main_tree->a[node];
+        main_tree->b[kept] = main_tree->b[node];
+        main_tree->span_start[kept] = main_tree->span_start[node];
+        main_tree->span_length[kept] = main_tree->span_length[node];
+
+        switch(main_tree->kind[kept])
+        {
+            case print_statement: main_tree->a[kept] = node_map[main_tree->a[kept]];break;
+            case variable_decl: main_tree->b[kept] = node_map[main_tree->b[kept]];break;
+            case include_statement: {
+                if(main_tree->b[node] != include_pending && main_tree->b[node] != include_repeated)
+                    node += main_tree->b[node];
+
+                /* The errors of the included file are found again too(see `link_module`). */
+                forget_diagnostics(&active_context->diagnostics, main_tree->span_start[kept], main_tree->span_start[kept] + 1, 0, 0);
+                main_tree->b[kept] = include_pending;
+                break;
+            }
+            default: break;
+        }
+
+        kept++;
+    }
+
+    main_tree->amount = kept;
+    free(node_map);
+}
+
+/* Canonical path of `written`(the path of an include in `from`), NULL if there is no such file. */
+static nT8 *resolve_include_path(const nT8 *from, const nT8 *written)
+{
+    if(written[0] == '/') return realpath(written, NULL);
+
+    const nT8 *slash = strrchr(from, '/');
+    uSIZE directory_length = slash ? (uSIZE) (slash - from) + 1 : 0;
+
+    nT8 *joined = malloc(directory_length + strlen(written) + 1);
+    lang_assert(joined,
+        "Error allocating memory for the path of an included file.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    memcpy(joined, from, directory_length);
+    strcpy(&joined[directory_length], written);
+
+    nT8 *path = realpath(joined, NULL);
+    free(joined);
+
+    return path;
+}
+
+static uT32 add_module(_module_set *set, _source_module module)
+{
+    if(set->amount == set->capacity)
+    {
+        set->capacity = set->capacity ? set->capacity * 2 : 0x10;
+        set->modules = realloc(set->modules, set->capacity * sizeof(*set->modules));
+        lang_assert(set->modules,
+            "Error allocating memory for linking the included files.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    set->modules[set->amount] = module;
+    return set->amount++;
+}
+
+/* The module of the file at `path`(canonical, owned by the set from here on), added if it is new.
+ * A file is the same module as another when it has the same path, or the same source code.
+ * */
+static uT32 find_module(_module_set *set, nT8 *path)
+{
+    for(uT32 i = 0; i < set->amount; i++)
+        if(strcmp(set->modules[i].path, path) == 0)
+        {
+            free(path);
+            return i;
+        }
+
+    _source_buffer *source = init_source_buffer(path);
+    if(!(source))
+    {
+        free(path);
+        return no_module;
+    }
+
+    /* A new path is a file the program depends on, even if its source code is a module already(see `cache.h`). */
+    add_dependency(path);
+
+    uSIZE hash = hash_bytes(source->data, source->size, 0);
+    for(uT32 i = 0; i < set->amount; i++)
+    {
+        _source_module *module = &set->modules[i];
+
+        if(module->source && module->hash == hash && module->source->size == source->size &&
+           memcmp(module->source->data, source->data, source->size) == 0)
+        {
+            destroy_source_buffer(source);
+            free(path);
+            return i;
+        }
+    }
+
+    return add_module(set, (_source_module) { .path = path, .hash = hash, .source = source });
+}
+
+/* Find the module of every include of module `index`. It goes in the `b` of the include until it is linked. */
+static void find_included_modules(_module_set *set, uT32 index)
+{
+    _ast_tree *nodes = set->modules[index].nodes;
+
+    for(uT32 node = 0; node < nodes->amount; node++)
+    {
+        if(nodes->kind[node] != include_statement) continue;
+
+        nT8 *path = resolve_include_path(set->modules[index].path, nT8_PCC &nodes->strings[nodes->a[node]]);
+        nodes->b[node] = path ? find_module(set, path) : no_module;
+    }
+}
+
+/* Lex and parse a module in a compilation of its own, or load it from the cache. */
+static void parse_module(_module_set *set, _source_module *module)
+{
+    _compiler_context *context = new_compiler_context();
+    context->memory_info = set->whole->memory_info;
+    module->context = context;
+    module->nodes = context->syntax_tree;
+
+    if(set->cache_directory && load_cached_program(module->source, set->cache_directory, true)) return;
+
+    _lexer *l = init_lexer_region(context, module->source, 0, module->source->size, 1);
+    _parser *p = init_parser(l);
+    p->included = true;
+
+    tokenize(l);
+    parse_tokens(p);
+    if(!(ast_has_been_comitted())) commit_ast();
+
+    destroy_line_index(&l->lines);
+
+    if(set->cache_directory) store_cached_program(module->source, set->cache_directory, true);
+}
+
+/* Parse modules until there are none left, on as many threads as run this. */
+static void *parse_modules(void *argument)
+{
+    _module_set *set = argument;
+
+    while(true)
+    {
+        uT32 index = __atomic_fetch_add(&set->next, 1, __ATOMIC_RELAXED);
+        if(index >= set->amount) break;
+
+        parse_module(set, &set->modules[index]);
+    }
+
+    return NULL;
+}
+
+/* Parse modules [`set->next`, `set->amount`) on up to `jobs` threads. */
+static void parse_module_wave(_module_set *set, uT32 jobs)
+{
+    uT32 amount = set->amount - set->next;
+    if(jobs > amount) jobs = amount;
+
+    trace(TC_parser, TL_info, "Parsing %llu included files on %llu threads", amount, jobs);
+
+    if(jobs < 2)
+    {
+        parse_modules(set);
+        use_compiler_context(set->whole);
+        return;
+    }
+
+    pthread_t *threads = malloc(jobs * sizeof(*threads));
+    lang_assert(threads,
+        "Error allocating memory for linking the included files.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    for(uT32 i = 0; i < jobs; i++)
+    {
+        nT32 failed = pthread_create(&threads[i], NULL, parse_modules, set);
+        lang_assert(failed == 0,
+            "Error starting a thread for parsing the included files.\n\tTry rerunning without `--jobs`.\n",
+            OOC_allocation_error)
+    }
+
+    for(uT32 i = 0; i < jobs; i++)
+        pthread_join(threads[i], NULL);
+
+    free(threads);
+}
+
+/* An error of a module, reported where the module is(first) included. */
+static void add_module_diagnostic(_module_set *set, nT32 error_code, uSIZE offset, const nT8 *err_msg, ...)
+{
+    va_list args;
+
+    va_start(args, err_msg);
+    add_diagnostic(&set->whole->diagnostics, error_code, offset, format_diagnostic(err_msg, args));
+    va_end(args);
+}
+
+/* Line `offset` is on, in module `index`. */
+static nTL32 module_line(_module_set *set, uT32 index, uSIZE offset)
+{
+    if(index == 0) return line_of_offset(set->lines, offset);
+
+    const uT8 *data = set->modules[index].source->data;
+    return scan_kernels.count_newlines(data, data + offset) + 1;
+}
+
+/* Append the nodes of module `index` to `tree`, with the modules it includes in place of their includes.
+ * Nodes of an included module take the span of the include in the file being compiled(`span_start`,
+ * `span_length`), so an edit of that line takes them with it(see `incremental.h`). Module 0 keeps its own.
+ * */
+static void link_module(_module_set *set, uT32 index, uSIZE span_start, uT32 span_length)
+{
+    _source_module *module = &set->modules[index];
+    _ast_tree *from = module->nodes;
+    _symbol_table *names = module->context ? module->context->symbol_names : NULL;
+
+    module->included = true;
+
+    if(module->context)
+    {
+        _diagnostics *errors = &module->context->diagnostics;
+
+        for(uT32 i = 0; i < errors->amount; i++)
+            add_module_diagnostic(set, errors->entries[i].error_code, span_start, "In `%s`: %s", module->path, errors->entries[i].message);
+        free_diagnostics(errors);
+    }
+
+    /* Symbols are interned again in the order they are met, like the chunks of `parallel.h`. */
+    uT32 *symbol_map = NULL;
+    if(names)
+    {
+        symbol_map = malloc(names->amount * sizeof(*symbol_map) + 1);
+        lang_assert(symbol_map,
+            "Error allocating memory for linking the included files.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+
+        for(uT32 id = 0; id < names->amount; id++)
+            symbol_map[id] = intern(uT8_PCC &names->arena[names->names[id]], names->lengths[id]);
+    }
+
+    uT32 *node_map = malloc(from->amount * sizeof(*node_map) + 1);
+    lang_assert(node_map,
+        "Error allocating memory for linking the included files.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    for(uT32 node = 0; node < from->amount; node++)
+    {
+        reserve_ast_nodes((uSIZE) tree.amount + 1);
+
+        uT32 to = tree.amount++;
+        node_map[node] = to;
+
+        tree.kind[to] = from->kind[node];
+        tree.a[to] = from->a[node];
+        tree.b[to] = from->b[node];
+        tree.span_start[to] = index ? span_start : from->span_start[node];
+        tree.span_length[to] = index ? span_length : from->span_length[node];
+
+        switch(tree.kind[to])
+        {
+            case print_statement: tree.a[to] = node_map[tree.a[to]];break;
+            case variable_decl: {
+                if(symbol_map) tree.a[to] = symbol_map[tree.a[to]];
+                tree.b[to] = node_map[tree.b[to]];
+                break;
+            }
+            case variable_operand: if(symbol_map) tree.a[to] = symbol_map[tree.a[to]];break;
+            /* Strings are copied one node at a time, so they stay in the order of the nodes(see `apply_edit`). */
+            case string_operand:
+            case char_operand: tree.a[to] = add_ast_bytes(&from->strings[from->a[node]], from->b[node]);break;
+            case include_statement: {
+                uT32 included = from->b[node];
+                tree.a[to] = add_ast_bytes(&from->strings[from->a[node]], strlen(nT8_PCC &from->strings[from->a[node]]));
+
+                if(included == no_module)
+                {
+                    /* Left pending, so the next link looks for the file again. */
+                    tree.b[to] = include_pending;
+                    add_module_diagnostic(set, file_not_exist_error, tree.span_start[to],
+                        "%s%s%sThe file \"%s\" passed to `include` on line %ld doesn't exist, or the path is wrong.\n",
+                        index ? "In `" : "", index ? module->path : "", index ? "`: " : "",
+                        &tree.strings[tree.a[to]], module_line(set, index, from->span_start[node]));
+                    break;
+                }
+
+                if(set->modules[included].included)
+                {
+                    tree.b[to] = include_repeated;
+                    break;
+                }
+
+                link_module(set, included, tree.span_start[to], tree.span_length[to]);
+                tree.b[to] = tree.amount - to - 1;
+                break;
+            }
+            default: break;
+        }
+    }
+
+    free(node_map);
+    free(symbol_map);
+
+    trace(TC_ast, TL_debug, "Linked %llu nodes of module %llu", from->amount, index);
+}
+
+/* Parse the files `tree` includes(and the files they include, and so on) and put their nodes in
+ * place of the includes, in the order the includes are met.
+ *
+ * A file is parsed at most once however many times it is included, and only its first include adds
+ * its nodes; a file is recognized by its canonical path, or by its source code(a copy of a file is
+ * the same file). The files are parsed breadth first, each level of includes on up to `jobs` threads,
+ * every file in a compilation of its own(like the chunks of `parallel.h`); with a `cache_directory`
+ * a file that was parsed before(in any program) is loaded from the cache instead(see `cache.h`).
+ *
+ * `filename` is the file being compiled, paths of includes are relative to the file they are in.
+ * Errors of an included file are reported on the line of the `#include` that first brought it in.
+ * */
+void link_includes(nT8 *filename, _lexer *l, uT32 jobs, const nT8 *cache_directory)
+{
+    use_compiler_context(l->context);
+    if(!(includes_need_linking())) return;
+
+    _module_set set = {
+        .whole = l->context,
+        .lines = &l->lines,
+        .cache_directory = cache_directory
+    };
+
+    _ast_tree main_tree;
+    detach_main_tree(&main_tree);
+
+    nT8 *main_path = realpath(filename, NULL);
+    if(!(main_path)) main_path = strdup(filename);
+    lang_assert(main_path,
+        "Error allocating memory for the path of `%s`.\n\tTry rerunning the program.\n",
+        OOC_allocation_error, filename)
+
+    /* The file being compiled is only recognized by its source code when all of it is there. */
+    _source_buffer *main_source = l->source->streaming ? NULL : l->source;
+    add_module(&set, (_source_module) {
+        .path = main_path,
+        .hash = main_source ? hash_bytes(main_source->data, main_source->size, 0) : 0,
+        .source = main_source,
+        .nodes = &main_tree
+    });
+
+    find_included_modules(&set, 0);
+
+    /* A level of includes at a time: the files of one level are only known once the level before is parsed. */
+    for(set.next = 1; set.next < set.amount;)
+    {
+        uT32 level_start = set.next, level_end = set.amount;
+
+        parse_module_wave(&set, jobs);
+        set.next = level_end;
+
+        for(uT32 i = level_start; i < level_end; i++)
+            find_included_modules(&set, i);
+    }
+
+    link_module(&set, 0, 0, 0);
+    tree.state = main_tree.state;
+
+    trace(TC_ast, TL_info, "Linked %llu files, %llu nodes", set.amount, tree.amount);
+
+    free_ast_tree(&main_tree);
+    free(set.modules[0].path);
+
+    for(uT32 i = 1; i < set.amount; i++)
+    {
+        _source_module *module = &set.modules[i];
+
+        /* The memory info is only borrowed. */
+        if(module->context)
+        {
+            module->context->memory_info = NULL;
+            destroy_compiler_context(module->context);
+        }
+
+        destroy_source_buffer(module->source);
+        free(module->path);
+    }
+
+    free(set.modules);
+    use_compiler_context(l->context);
+}
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef incremental
+#define incremental
+
+/* An edit to the source code: the bytes [`start`, `end`) are replaced by `replacement`.
+ * Inserting is `start == end`, deleting is `replacement_length == 0`.
+ * */
+typedef struct source_edit
+{
+    uSIZE       start;
+    uSIZE       end;
+    const uT8   *replacement;
+    uSIZE       replacement_length;
+} _source_edit;
+
+/* A source file that is kept in memory between edits(e.g. while it is open in an editor).
+ * An edit only relexes and reparses the lines it touched, every other node of `tree` is kept.
+ * `context->diagnostics` always has the errors of the source code as it is after the last edit.
+ * */
+typedef struct incremental_session
+{
+    _compiler_context   *context;
+    _lexer              *lang_lexer;
+    _parser             *lang_parser;
+
+    /* The file being edited, the files it includes are relative to it. */
+    nT8                 *filename;
+} _incremental_session;
+
+/* Parse all of `filename` once, the starting point for `apply_edit`. */
+_incremental_session *init_incremental(nT8 *filename)
+{
+    _incremental_session *session = calloc(1, sizeof(*session));
+    lang_assert(session,
+        "Error allocating memory for the incremental session.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    /* Edits move bytes around, so the source code cannot stay mapped read-only. */
+    session->context = new_compiler_context();
+    session->lang_lexer = init_lexer(session->context, filename, false);
+    make_source_buffer_editable(session->lang_lexer->source);
+    session->lang_lexer->file_source_code = session->lang_lexer->source->data;
+    session->lang_lexer->val = session->lang_lexer->file_source_code[0];
+
+    session->lang_parser = init_parser(session->lang_lexer);
+    session->filename = strdup(filename);
+    lang_assert(session->filename,
+        "Error allocating memory for the incremental session.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    run_parser(session->lang_parser);
+    link_includes(session->filename, session->lang_lexer, 1, NULL);
+    resolve_variables(&session->lang_lexer->lines);
+    build_constant_pool();
+
+    return session;
+}
+
+/* Does a node of kind `kind` have bytes in `tree.strings`? */
+static bool has_ast_string(uT8 kind)
+{
+    return kind == string_operand || kind == char_operand || kind == include_statement;
+}
+
+/* Offset in `tree.strings` of the first node from `node` on that has bytes there, the end of the strings if none does. */
+static uT32 first_ast_string(uT32 node)
+{
+    for(; node < tree.amount; node++)
+        if(has_ast_string(tree.kind[node])) return tree.a[node];
+
+    return tree.strings_size;
+}
+
+/* Apply `edit` to the source code of `session`, then bring `tree` up to date.
+ *
+ * Statements never span lines, so only the lines `edit` touches need relexing and reparsing.
+ * Nodes before those lines are kept as they are, nodes after them are kept and have their
+ * spans moved by however many bytes `edit` added or removed(and their operands and strings renumbered).
+ * Variables and constants are only resolved again from the first reparsed node on, and the included
+ * files are only linked again when an `#include` was reparsed.
+ * */
+void apply_edit(_incremental_session *session, _source_edit edit)
+{
+    use_compiler_context(session->context);
+
+    _lexer *l = session->lang_lexer;
+    _source_buffer *source = l->source;
+
+    lang_assert(edit.start <= edit.end && edit.end <= source->size,
+        "The edit [%llu, %llu) is outside of the source code(%llu bytes).\n",
+        invalid_edit_error, edit.start, edit.end, source->size)
+
+    /* From the start of the line `edit.start` is on, up to and including the end of the line `edit.end` is on. */
+    uSIZE removed = edit.end - edit.start;
+    uSIZE region_start = line_start_offset(&l->lines, line_of_offset(&l->lines, edit.start), 0);
+    uSIZE old_region_end = line_start_offset(&l->lines, line_of_offset(&l->lines, edit.end) + 1, source->size);
+
+    /* Errors say what line they are on. If the edit adds or removes lines, the errors after it are
+     * found again(their lines get reparsed too) so they say the right line.
+     * */
+    _diagnostics *diagnostics = &session->context->diagnostics;
+    if(scan_kernels.count_newlines(&source->data[edit.start], &source->data[edit.end]) !=
+       scan_kernels.count_newlines(edit.replacement, &edit.replacement[edit.replacement_length]))
+    {
+        uSIZE last_error = 0;
+        bool error_after = false;
+
+        for(uT32 i = 0; i < diagnostics->amount; i++)
+            if(diagnostics->entries[i].offset >= old_region_end)
+            {
+                error_after = true;
+                if(diagnostics->entries[i].offset > last_error) last_error = diagnostics->entries[i].offset;
+            }
+
+        if(error_after)
+            old_region_end = line_start_offset(&l->lines, line_of_offset(&l->lines, last_error) + 1, source->size);
+    }
+
+    /* The error of a statement can depend on the token after it(e.g. `Unexpected EOF` when there is none), and
+     * that can be lines later. So the errors since the last statement before the edited lines are found again,
+     * and if no statement comes after them, so is everything up to the end.
+     * */
+    uSIZE last_before = 0, first_error = region_start;
+    bool statement_after = false;
+
+    for(uT32 node = 0; node < tree.amount; node++)
+    {
+        if(tree.span_start[node] < region_start && tree.span_start[node] > last_before) last_before = tree.span_start[node];
+        if(tree.span_start[node] >= old_region_end) statement_after = true;
+    }
+
+    for(uT32 i = 0; i < diagnostics->amount; i++)
+        if(diagnostics->entries[i].offset >= last_before && diagnostics->entries[i].offset < first_error)
+            first_error = diagnostics->entries[i].offset;
+
+    region_start = line_start_offset(&l->lines, line_of_offset(&l->lines, first_error), 0);
+    if(!(statement_after)) old_region_end = source->size;
+
+    uSIZE new_region_end = old_region_end - removed + edit.replacement_length;
+    uSIZE new_size = source->size - removed + edit.replacement_length;
+
+    /* Splice `edit.replacement` into the source code. */
+    if(new_size > source->size)
+    {
+        source->data = realloc(source->data, new_size + 1);
+        lang_assert(source->data,
+            "Error allocating memory for the edited source code(%llu bytes).\n",
+            OOC_allocation_error, new_size)
+    }
+
+    memmove(&source->data[edit.start + edit.replacement_length], &source->data[edit.end], source->size - edit.end);
+    memcpy(&source->data[edit.start], edit.replacement, edit.replacement_length);
+    source->size = new_size;
+    source->data[new_size] = '\0';
+
+    build_line_index(&l->lines, source->data, source->size, 0, 1);
+
+    /* The errors of the edited lines are found again when they are reparsed. */
+    forget_diagnostics(diagnostics, region_start, old_region_end, (sSIZE) edit.replacement_length - (sSIZE) removed, 0);
+
+    /* Nodes are in source order: [0, before) come before the edited lines, [after, tree.amount) after them. */
+    uT32 before = 0, after = tree.amount;
+    while(before < tree.amount && tree.span_start[before] < region_start) before++;
+    while(after > before && tree.span_start[after - 1] >= old_region_end) after--;
+
+    bool includes_changed = false;
+    for(uT32 node = before; node < after; node++)
+        if(tree.kind[node] == include_statement) includes_changed = true;
+
+    uT32 kept_after = tree.amount - after;
+    _ast_tree following = { 0 };
+    following.kind = malloc(kept_after * sizeof(*following.kind) + 1);
+    following.a = malloc(kept_after * sizeof(*following.a) + 1);
+    following.b = malloc(kept_after * sizeof(*following.b) + 1);
+    following.span_start = malloc(kept_after * sizeof(*following.span_start) + 1);
+    following.span_length = malloc(kept_after * sizeof(*following.span_length) + 1);
+    lang_assert(following.kind && following.a && following.b && following.span_start && following.span_length,
+        "Error allocating memory for the AST tree.\n",
+        OOC_allocation_error)
+
+    memcpy(following.kind, &tree.kind[after], kept_after * sizeof(*following.kind));
+    memcpy(following.a, &tree.a[after], kept_after * sizeof(*following.a));
+    memcpy(following.b, &tree.b[after], kept_after * sizeof(*following.b));
+    memcpy(following.span_start, &tree.span_start[after], kept_after * sizeof(*following.span_start));
+    memcpy(following.span_length, &tree.span_length[after], kept_after * sizeof(*following.span_length));
+
+    /* Strings are in the order of their nodes: those of the dropped nodes are between the kept ones. */
+    uT32 strings_kept = first_ast_string(before), strings_following = first_ast_string(after);
+    following.strings_size = tree.strings_size - strings_following;
+    following.strings = malloc(following.strings_size + 1);
+    lang_assert(following.strings,
+        "Error allocating memory for the AST strings.\n",
+        OOC_allocation_error)
+
+    memcpy(following.strings, &tree.strings[strings_following], following.strings_size);
+
+    trace(TC_parser, TL_info, "Edit reparses bytes [%llu, %llu), keeping %llu nodes", region_start, new_region_end, before + kept_after);
+
+    /* Reparse the edited lines, their nodes(and strings) are appended after `before - 1`. */
+    tree.amount = before;
+    tree.strings_size = strings_kept;
+    tree.state = ready;
+
+    set_lexer_region(l, region_start, new_region_end - region_start);
+    tokenize(l);
+    parse_tokens(session->lang_parser);
+
+    uT32 moved_to = tree.amount;
+    for(uT32 node = before; node < moved_to; node++)
+        if(tree.kind[node] == include_statement) includes_changed = true;
+
+    /* Put the nodes that followed the edited lines back. Their operands were counted from `after`,
+     * their strings from `strings_following`.
+     * */
+    uT32 strings_moved_to = tree.strings_size;
+    reserve_ast_nodes((uSIZE) moved_to + kept_after);
+    reserve_ast_strings((uSIZE) strings_moved_to + following.strings_size);
+
+    memcpy(&tree.strings[strings_moved_to], following.strings, following.strings_size);
+    tree.strings_size += following.strings_size;
+
+    for(uT32 i = 0; i < kept_after; i++)
+    {
+        uT32 node = moved_to + i;
+
+        tree.kind[node] = following.kind[i];
+        tree.a[node] = following.a[i];
+        tree.b[node] = following.b[i];
+        tree.span_start[node] = following.span_start[i] - removed + edit.replacement_length;
+        tree.span_length[node] = following.span_length[i];
+
+        switch(tree.kind[node])
+        {
+            case print_statement: tree.a[node] = tree.a[node] - after + moved_to;break;
+            case variable_decl: tree.b[node] = tree.b[node] - after + moved_to;break;
+            case string_operand:
+            case char_operand:
+            case include_statement: tree.a[node] = tree.a[node] - strings_following + strings_moved_to;break;
+            default: break;
+        }
+    }
+    tree.amount += kept_after;
+
+    free(following.kind);
+    free(following.a);
+    free(following.b);
+    free(following.span_start);
+    free(following.span_length);
+    free(following.strings);
+
+    set_lexer_region(l, 0, source->size);
+    if(!(ast_has_been_comitted())) commit_ast();
+
+    /* An edited `#include` brings its file in again(or takes it away), which renumbers every node. */
+    uT32 first = before;
+    if(includes_changed)
+    {
+        link_includes(session->filename, l, 1, NULL);
+        first = 0;
+    }
+
+    /* A declaration that moved, or went, changes the slots of everything after it. */
+    resolve_variables_from(&l->lines, first);
+    build_constant_pool_from(first);
+}
+
+void destroy_incremental(_incremental_session *session)
+{
+    if(!(session)) return;
+
+    destroy_lexer(session->lang_lexer);
+    destroy_parser(session->lang_parser);
+    destroy_compiler_context(session->context);
+
+    free(session->filename);
+    free(session);
+}
+
+/* Run `filename` as if `edits` had been applied to it in order, without saving them(see `apply_edit`).
+ * Every error of the edited program is reported at once, a program without errors is then run like `run` does.
+ * Returns the status the program should exit with: that of the first error, or the one the program exited with.
+ * */
+nT32 run_edited(nT8 *filename, _source_edit *edits, uT32 amount, bool jit)
+{
+    _incremental_session *session = init_incremental(filename);
+
+    for(uT32 i = 0; i < amount; i++)
+        apply_edit(session, edits[i]);
+
+    nT32 status = report_diagnostics(&session->context->diagnostics);
+    if(!(session->context->diagnostics.amount))
+    {
+        use_compiler_context(session->context);
+        compile_bytecode();
+        optimize_bytecode();
+
+        status = jit ? run_jit(active_context->bytecode, program_constants.rodata) : run_bytecode(active_context->bytecode, program_constants.rodata, stdout);
+    }
+
+    destroy_incremental(session);
+    return status;
+}
+
+#endif
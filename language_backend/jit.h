@@ -0,0 +1,591 @@
+#ifndef jit_compilation
+#define jit_compilation
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <errno.h>
+#include <stddef.h>
+#include <sys/mman.h>
+
+/* Bytes of output the compiled code collects before it `write`s them. */
+#define jit_output_size     0x10000
+
+/* Texts up to this long are copied into the output by the compiled code itself, longer ones go through `jit_print_bytes`.
+ * Texts up to `jit_immediate_text` long are in the code itself.
+ * */
+#define jit_inline_text     0x1000
+#define jit_immediate_text  0x10
+
+/* Most machine code one instruction of bytecode is compiled to. */
+#define jit_instruction_room    0x100
+
+/* Where the output of compiled code goes: `[buffer, end)` is collected, then written to `fd` in one go.
+ * `buffer` has `jit_immediate_text` more bytes after `end`, compiled code stores short texts 8 bytes at a time.
+ * */
+typedef struct jit_output
+{
+    uT8         *buffer;
+    uT8         *end;
+    nT32        fd;
+
+    /* A `write` failed(e.g. the reader of a pipe went away), the rest of the output is dropped. */
+    bool        failed;
+} _jit_output;
+
+/* Write the `length` bytes at `bytes` to `out->fd`, all of them. */
+static void jit_write(_jit_output *out, const uT8 *bytes, uSIZE length)
+{
+    while(length && !(out->failed))
+    {
+        sSIZE written = write(out->fd, bytes, length);
+
+        if(written < 0 && errno == EINTR) continue;
+        if(written <= 0) { out->failed = true; break; }
+
+        bytes += written;
+        length -= written;
+    }
+}
+
+/* The functions compiled code calls. Each is handed where the output collected so far ends(`cursor`), and returns where it ends after. */
+
+/* Write what was collected, start collecting again. */
+static uT8 *jit_flush(_jit_output *out, uT8 *cursor)
+{
+    jit_write(out, out->buffer, cursor - out->buffer);
+    return out->buffer;
+}
+
+static uT8 *jit_print_bytes(_jit_output *out, uT8 *cursor, const uT8 *bytes, uSIZE length)
+{
+    if(cursor + length > out->end)
+    {
+        cursor = jit_flush(out, cursor);
+
+        /* Too large to collect at all. */
+        if(length > jit_output_size)
+        {
+            jit_write(out, bytes, length);
+            return cursor;
+        }
+    }
+
+    memcpy(cursor, bytes, length);
+    return cursor + length;
+}
+
+/* A string and a newline. `string` is NULL for a string variable that was not given a value. */
+static uT8 *jit_print_string(_jit_output *out, uT8 *cursor, const nT8 *string)
+{
+    if(string) cursor = jit_print_bytes(out, cursor, uT8_PCC string, strlen(string));
+    return jit_print_bytes(out, cursor, uT8_PCC "\n", 1);
+}
+
+/* A number in base `base`(see `format_number`) and a newline. */
+static inline uT8 *jit_print_number(_jit_output *out, uT8 *cursor, uSIZE value, uT8 base)
+{
+    if(cursor + 0x18 > out->end) cursor = jit_flush(out, cursor);
+
+    cursor += format_number(nT8_PC cursor, value, base);
+    *cursor++ = '\n';
+    return cursor;
+}
+
+/* One for each base, so the divisions are by constants. */
+static uT8 *jit_print_integer(_jit_output *out, uT8 *cursor, uSIZE value) { return jit_print_number(out, cursor, value, 10); }
+static uT8 *jit_print_hex(_jit_output *out, uT8 *cursor, uSIZE value) { return jit_print_number(out, cursor, value, 16); }
+
+/* The double with the bits `bits`, and a newline. */
+static uT8 *jit_print_float(_jit_output *out, uT8 *cursor, uSIZE bits)
+{
+    nT8 text[32];
+    double value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return jit_print_bytes(out, cursor, uT8_PCC text, snprintf(text, sizeof(text), "%.15g\n", value));
+}
+
+/* The functions compiled code calls, their addresses are at the start of the code(see `compile_jit`). */
+enum jit_helpers
+{
+    jit_helper_flush = 0x0,
+    jit_helper_bytes,
+    jit_helper_string,
+    jit_helper_integer,
+    jit_helper_hex,
+    jit_helper_float,
+
+    jit_helper_amount
+};
+
+/* A program compiled to machine code, and the texts its code copies into the output. */
+typedef struct jit_program
+{
+    uT8         *code;
+    uSIZE       size;
+
+    /* Where in `code` the function starts. */
+    uSIZE       entry;
+
+    uT8         *texts;
+} _jit_program;
+
+/* Code that is being compiled, see `compile_jit`. */
+typedef struct jit_code
+{
+    /* Mapped, so it can be made executable where it is. */
+    uT8         *bytes;
+    uSIZE       size;
+    uSIZE       capacity;
+
+    /* Texts of the prints of constants. */
+    uT8         *texts;
+    uSIZE       texts_size;
+    uSIZE       texts_capacity;
+
+    /* Texts still to be printed, from `pending` to `texts_size`(see `emit_pending_text`). */
+    uSIZE       pending;
+
+    /* Where in `bytes` the address of a text goes, once `texts` stopped moving(pairs of code offset, text offset). */
+    uSIZE       *text_fixups;
+    uT32        fixup_amount;
+    uT32        fixup_capacity;
+
+    /* Where in `bytes` the `rel32` of a jump to the end of the program is. */
+    uSIZE       *exits;
+    uT32        exit_amount;
+    uT32        exit_capacity;
+} _jit_code;
+
+/* Make sure there is room for `room` more bytes of machine code(`jit_instruction_room` for one more instruction). */
+static void reserve_jit_code(_jit_code *code, uSIZE room)
+{
+    if(code->size + room <= code->capacity) return;
+
+    uSIZE capacity = code->capacity ? code->capacity : 0x10000;
+    while(capacity < code->size + room) capacity *= 2;
+    uT8 *bytes = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    lang_assert(bytes != MAP_FAILED,
+        "Error allocating memory for the machine code(%llu bytes).\n\tTry rerunning the program.\n",
+        OOC_allocation_error, capacity)
+
+    if(code->bytes)
+    {
+        memcpy(bytes, code->bytes, code->size);
+        munmap(code->bytes, code->capacity);
+    }
+
+    code->bytes = bytes;
+    code->capacity = capacity;
+}
+
+/* Make sure the texts of `code` have room for `size` bytes. */
+static void reserve_jit_texts(_jit_code *code, uSIZE size)
+{
+    if(size <= code->texts_capacity) return;
+
+    uSIZE capacity = code->texts_capacity ? code->texts_capacity : 0x1000;
+    while(capacity < size) capacity *= 2;
+
+    code->texts = realloc(code->texts, capacity);
+    lang_assert(code->texts,
+        "Error allocating memory for the machine code.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+    code->texts_capacity = capacity;
+}
+
+/* Room was made by `reserve_jit_code`. */
+static inline void emit_code_bytes(_jit_code *code, const uT8 *bytes, uSIZE length)
+{
+    memcpy(&code->bytes[code->size], bytes, length);
+    code->size += length;
+}
+
+/* Emit the bytes given(e.g. `emit_code(code, 0xC3)` for a `ret`). */
+#define emit_code(code, ...)    emit_code_bytes(code, (const uT8[]) { __VA_ARGS__ }, sizeof((const uT8[]) { __VA_ARGS__ }))
+
+static inline void emit_code_u32(_jit_code *code, uT32 value)
+{
+    emit_code_bytes(code, (const uT8 *) &value, sizeof(value));
+}
+
+static inline void emit_code_u64(_jit_code *code, uSIZE value)
+{
+    emit_code_bytes(code, (const uT8 *) &value, sizeof(value));
+}
+
+/* Remember to jump to the end of the program from the `rel32` about to be emitted. */
+static void add_jit_exit(_jit_code *code)
+{
+    if(code->exit_amount == code->exit_capacity)
+    {
+        code->exit_capacity = code->exit_capacity ? code->exit_capacity * 2 : 0x40;
+        code->exits = realloc(code->exits, code->exit_capacity * sizeof(*code->exits));
+        lang_assert(code->exits,
+            "Error allocating memory for the machine code.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    code->exits[code->exit_amount++] = code->size;
+}
+
+/* Bytes `emit_jit_call` emits. */
+#define jit_call_size   15
+
+/* Call `helper`(through its address at the start of the code), then `mov r12, rax`(the call returns the new cursor).
+ * `rdi` and `rsi` are set to the output and the cursor first, the other arguments have to be in place already.
+ * */
+static void emit_jit_call(_jit_code *code, enum jit_helpers helper)
+{
+    emit_code(code, 0x4C, 0x89, 0xF7);              // mov rdi, r14
+    emit_code(code, 0x4C, 0x89, 0xE6);              // mov rsi, r12
+    emit_code(code, 0xFF, 0x15);                    // call [rip + helper]
+    emit_code_u32(code, helper * sizeof(void *) - (code->size + sizeof(uT32)));
+    emit_code(code, 0x49, 0x89, 0xC4);              // mov r12, rax
+}
+
+/* `mov reg, text`(`reg_code` is the `0xB8 + reg` of the register), with the address filled in once `texts` stopped moving. */
+static void emit_text_address(_jit_code *code, uT8 reg_code, uSIZE text)
+{
+    if(code->fixup_amount == code->fixup_capacity)
+    {
+        code->fixup_capacity = code->fixup_capacity ? code->fixup_capacity * 2 : 0x200;
+        code->text_fixups = realloc(code->text_fixups, code->fixup_capacity * 2 * sizeof(*code->text_fixups));
+        lang_assert(code->text_fixups,
+            "Error allocating memory for the machine code.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    emit_code(code, 0x48, reg_code);                // mov reg, imm64
+    code->text_fixups[code->fixup_amount * 2] = code->size;
+    code->text_fixups[code->fixup_amount * 2 + 1] = text;
+    code->fixup_amount++;
+    emit_code_u64(code, 0);
+}
+
+/* Add the `length` bytes at `text`, and a newline, to the texts still to be printed. */
+static void add_jit_text(_jit_code *code, const uT8 *text, uSIZE length)
+{
+    reserve_jit_texts(code, code->texts_size + length + 1);
+    memcpy(&code->texts[code->texts_size], text, length);
+    code->texts[code->texts_size + length] = '\n';
+    code->texts_size += length + 1;
+}
+
+/* Print the texts still to be printed, with one copy. */
+static void emit_pending_text(_jit_code *code)
+{
+    uSIZE length = code->texts_size - code->pending;
+    if(!(length)) return;
+
+    if(length > jit_inline_text)
+    {
+        emit_text_address(code, 0xBA, code->pending);                   // mov rdx, text
+        emit_code(code, 0x48, 0xB9);                                    // mov rcx, length
+        emit_code_u64(code, length);
+        emit_jit_call(code, jit_helper_bytes);
+        code->pending = code->texts_size;
+        return;
+    }
+
+    /* Flush first if the text does not fit. */
+    emit_code(code, 0x49, 0x8D, 0x84, 0x24);                            // lea rax, [r12 + length]
+    emit_code_u32(code, length);
+    emit_code(code, 0x4C, 0x39, 0xE8);                                  // cmp rax, r13
+    emit_code(code, 0x76, jit_call_size);                               // jbe past the flush
+    emit_jit_call(code, jit_helper_flush);
+
+    if(length <= jit_immediate_text)
+    {
+        /* The text is in the code, stored 8 bytes at a time(whatever is stored past it is overwritten later). */
+        uSIZE words[2] = { 0 };
+        memcpy(words, &code->texts[code->pending], length);
+
+        emit_code(code, 0x48, 0xB8);                                    // mov rax, first 8 bytes
+        emit_code_u64(code, words[0]);
+        emit_code(code, 0x49, 0x89, 0x04, 0x24);                        // mov [r12], rax
+        if(length > sizeof(uSIZE))
+        {
+            emit_code(code, 0x48, 0xB8);                                // mov rax, next 8 bytes
+            emit_code_u64(code, words[1]);
+            emit_code(code, 0x49, 0x89, 0x44, 0x24, 0x08);              // mov [r12 + 8], rax
+        }
+        emit_code(code, 0x49, 0x83, 0xC4, length);                      // add r12, length
+    }
+    else
+    {
+        emit_text_address(code, 0xBE, code->pending);                   // mov rsi, text
+        emit_code(code, 0x4C, 0x89, 0xE7);                              // mov rdi, r12
+        emit_code(code, 0xB9);                                          // mov ecx, length
+        emit_code_u32(code, length);
+        emit_code(code, 0xF3, 0xA4);                                    // rep movsb
+        emit_code(code, 0x49, 0x89, 0xFC);                              // mov r12, rdi
+    }
+
+    code->pending = code->texts_size;
+}
+
+/* `mov rdx, [rbx + slot * 8]`. */
+static void emit_load_slot_rdx(_jit_code *code, uT32 slot)
+{
+    emit_code(code, 0x48, 0x8B, 0x93);
+    emit_code_u32(code, slot * sizeof(uSIZE));
+}
+
+/* `mov [rbx + slot * 8], rax`. */
+static void emit_store_rax(_jit_code *code, uT32 slot)
+{
+    emit_code(code, 0x48, 0x89, 0x83);
+    emit_code_u32(code, slot * sizeof(uSIZE));
+}
+
+/* Print `rdx` as `how` prints it(`op_print_string`, `op_print_integer` ...). */
+static void emit_print_rdx(_jit_code *code, enum opcodes how)
+{
+    switch(how)
+    {
+        case op_print_string: emit_jit_call(code, jit_helper_string);break;
+        case op_print_float: emit_jit_call(code, jit_helper_float);break;
+        case op_print_hex: emit_jit_call(code, jit_helper_hex);break;
+        default: emit_jit_call(code, jit_helper_integer);break;
+    }
+}
+
+/* Compile `program`(with its numbers and strings in `rodata`) to x86-64 machine code.
+ *
+ * The code is a function `nT32 (uSIZE *slots, _jit_output *out)` returning the status the program exited with.
+ * Variables are `[rbx + slot * 8]`. The output collected so far is `[out->buffer, r12)`, and `r13` is `out->end`;
+ * it is written when it fills up, and when the program ends. The value the bytecode keeps in its accumulator
+ * is kept in `r15`.
+ *
+ * What a print of a literal prints is known now, so its text is made now. Those texts are copied into the
+ * output in runs: every text until the next print of a variable(or the end of the program) is copied at once,
+ * declarations in between print nothing.
+ * */
+_jit_program *compile_jit(_bytecode *program, const uT8 *rodata)
+{
+    _jit_code code = { 0 };
+    nT8 number[32];
+
+    /* The addresses of the helpers(in the order of `enum jit_helpers`), the function starts after them. */
+    const void *helpers[jit_helper_amount] = {
+        [jit_helper_flush] = jit_flush,
+        [jit_helper_bytes] = jit_print_bytes,
+        [jit_helper_string] = jit_print_string,
+        [jit_helper_integer] = jit_print_integer,
+        [jit_helper_hex] = jit_print_hex,
+        [jit_helper_float] = jit_print_float
+    };
+    uSIZE entry = (sizeof(helpers) + 0xF) & ~0xF;
+
+    /* Most instructions compile to less than 4 times their size, the rest grows the code. */
+    reserve_jit_code(&code, entry + program->size * 4);
+    memcpy(code.bytes, helpers, sizeof(helpers));
+    memset(&code.bytes[sizeof(helpers)], 0xCC, entry - sizeof(helpers));   // int3
+    code.size = entry;
+
+    /* push rbp, rbx, r12, r13, r14, r15, then keep the stack 16 byte aligned for the calls. */
+    emit_code(&code, 0x55, 0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57);
+    emit_code(&code, 0x48, 0x83, 0xEC, 0x08);                           // sub rsp, 8
+    emit_code(&code, 0x48, 0x89, 0xFB);                                 // mov rbx, rdi
+    emit_code(&code, 0x49, 0x89, 0xF6);                                 // mov r14, rsi
+    emit_code(&code, 0x4D, 0x8B, 0x66, offsetof(_jit_output, buffer));  // mov r12, [r14 + buffer]
+    emit_code(&code, 0x4D, 0x8B, 0x6E, offsetof(_jit_output, end));     // mov r13, [r14 + end]
+    emit_code(&code, 0x31, 0xED);                                       // xor ebp, ebp(the status)
+    emit_code(&code, 0x45, 0x31, 0xFF);                                 // xor r15d, r15d
+
+    for(uT32 at = 0; at < program->size; at += instruction_size(program->code[at]))
+    {
+        const uT8 *instruction = &program->code[at];
+        uT32 first = opcode_operands[*instruction] ? instruction_operand(instruction, 0) : 0;
+        uT32 second = opcode_operands[*instruction] > 1 ? instruction_operand(instruction, 1) : 0;
+        uSIZE value;
+
+        reserve_jit_code(&code, jit_instruction_room);
+        switch(*instruction)
+        {
+            /* Prints of constants only add to the texts. */
+            case op_print_string_constant: add_jit_text(&code, &rodata[first], second);break;
+            case op_print_integer_constant:
+            case op_print_hex_constant: {
+                memcpy(&value, &rodata[first], sizeof(value));
+                add_jit_text(&code, uT8_PCC number, format_number(number, value, *instruction == op_print_hex_constant ? 16 : 10));
+                break;
+            }
+            case op_print_float_constant: {
+                double decimal;
+
+                memcpy(&decimal, &rodata[first], sizeof(decimal));
+                add_jit_text(&code, uT8_PCC number, snprintf(number, sizeof(number), "%.15g", decimal));
+                break;
+            }
+
+            /* Declarations. */
+            case op_store_number: {
+                memcpy(&value, &rodata[second], sizeof(value));
+                emit_code(&code, 0x48, 0xB8);                           // mov rax, value
+                emit_code_u64(&code, value);
+                emit_store_rax(&code, first);
+                break;
+            }
+            case op_store_string: {
+                emit_code(&code, 0x48, 0xB8);                           // mov rax, &rodata[second]
+                emit_code_u64(&code, (uSIZE) &rodata[second]);
+                emit_store_rax(&code, first);
+                break;
+            }
+            case op_store_zero: {
+                emit_code(&code, 0x48, 0xC7, 0x83);                     // mov qword [rbx + slot * 8], 0
+                emit_code_u32(&code, first * sizeof(uSIZE));
+                emit_code_u32(&code, 0);
+                break;
+            }
+
+            /* Prints of variables. */
+            case op_print_slot_string:
+            case op_print_slot_integer:
+            case op_print_slot_hex: {
+                emit_pending_text(&code);
+                emit_load_slot_rdx(&code, first);
+                emit_print_rdx(&code, *instruction == op_print_slot_string ? op_print_string :
+                                      *instruction == op_print_slot_hex ? op_print_hex : op_print_integer);
+                break;
+            }
+
+            /* The accumulator(bytecode that was not optimized). */
+            case op_load_number: {
+                memcpy(&value, &rodata[first], sizeof(value));
+                emit_code(&code, 0x49, 0xBF);                           // mov r15, value
+                emit_code_u64(&code, value);
+                break;
+            }
+            case op_load_string: {
+                emit_code(&code, 0x49, 0xBF);                           // mov r15, &rodata[first]
+                emit_code_u64(&code, (uSIZE) &rodata[first]);
+                break;
+            }
+            case op_load_zero: emit_code(&code, 0x45, 0x31, 0xFF);break;    // xor r15d, r15d
+            case op_load_slot: {
+                emit_code(&code, 0x4C, 0x8B, 0xBB);                     // mov r15, [rbx + slot * 8]
+                emit_code_u32(&code, first * sizeof(uSIZE));
+                break;
+            }
+            case op_store_slot: {
+                emit_code(&code, 0x4C, 0x89, 0xBB);                     // mov [rbx + slot * 8], r15
+                emit_code_u32(&code, first * sizeof(uSIZE));
+                break;
+            }
+            case op_print_string:
+            case op_print_integer:
+            case op_print_hex:
+            case op_print_float: {
+                emit_pending_text(&code);
+                emit_code(&code, 0x4C, 0x89, 0xFA);                     // mov rdx, r15
+                emit_print_rdx(&code, *instruction);
+                break;
+            }
+
+            case op_exit: {
+                emit_pending_text(&code);
+                emit_code(&code, 0xBD);                                 // mov ebp, status
+                emit_code_u32(&code, first);
+                emit_code(&code, 0xE9);                                 // jmp the end
+                add_jit_exit(&code);
+                emit_code_u32(&code, 0);
+                break;
+            }
+            default: emit_pending_text(&code);break;                    // `op_halt`
+        }
+    }
+
+    reserve_jit_code(&code, jit_instruction_room);
+    emit_pending_text(&code);
+
+    /* The end: write what is left, return the status. */
+    for(uT32 i = 0; i < code.exit_amount; i++)
+    {
+        uT32 rel32 = code.size - (code.exits[i] + sizeof(uT32));
+        memcpy(&code.bytes[code.exits[i]], &rel32, sizeof(rel32));
+    }
+
+    reserve_jit_code(&code, jit_instruction_room);
+    emit_jit_call(&code, jit_helper_flush);
+    emit_code(&code, 0x89, 0xE8);                                       // mov eax, ebp
+    emit_code(&code, 0x48, 0x83, 0xC4, 0x08);                           // add rsp, 8
+    emit_code(&code, 0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0x5D, 0xC3);   // pop r15 ... rbp, ret
+
+    for(uT32 i = 0; i < code.fixup_amount; i++)
+    {
+        uSIZE address = (uSIZE) &code.texts[code.text_fixups[i * 2 + 1]];
+        memcpy(&code.bytes[code.text_fixups[i * 2]], &address, sizeof(address));
+    }
+
+    /* Written while it is writable, run once it is executable(never both). */
+    _jit_program *jit = calloc(1, sizeof(*jit));
+    lang_assert(jit,
+        "Error allocating memory for the machine code.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+    lang_assert(mprotect(code.bytes, code.capacity, PROT_READ | PROT_EXEC) == 0,
+        "Error making the machine code executable.\n",
+        OOC_allocation_error)
+
+    jit->code = code.bytes;
+    jit->size = code.capacity;
+    jit->entry = entry;
+    jit->texts = code.texts;
+
+    free(code.text_fixups);
+    free(code.exits);
+
+    trace(TC_ast, TL_info, "Compiled %llu bytes of bytecode to %llu bytes of machine code, %llu bytes of text", program->size, code.size, code.texts_size);
+    return jit;
+}
+
+/* Run `jit`, a program with `slots` variables. Its output goes to `stdout`. */
+nT32 run_jit_program(_jit_program *jit, uT32 slots)
+{
+    uSIZE *variables = calloc(slots + 1, sizeof(*variables));
+    _jit_output out = { .buffer = malloc(jit_output_size + jit_immediate_text), .fd = STDOUT_FILENO };
+    lang_assert(variables && out.buffer,
+        "Error allocating memory for the variables of the program.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+    out.end = out.buffer + jit_output_size;
+
+    /* Whatever was printed through `stdout` comes first. */
+    fflush(stdout);
+
+    nT32 status = ((nT32 (*)(uSIZE *, _jit_output *)) &jit->code[jit->entry])(variables, &out);
+
+    free(out.buffer);
+    free(variables);
+    return status;
+}
+
+void destroy_jit(_jit_program *jit)
+{
+    if(!(jit)) return;
+
+    munmap(jit->code, jit->size);
+    free(jit->texts);
+    free(jit);
+}
+
+/* Compile `program` to machine code(see `compile_jit`) and run it. Returns the status the program exited with. */
+nT32 run_jit(_bytecode *program, const uT8 *rodata)
+{
+    _jit_program *jit = compile_jit(program, rodata);
+    nT32 status = run_jit_program(jit, program->slots);
+
+    destroy_jit(jit);
+    return status;
+}
+
+#undef emit_code
+#else
+/* There is only a JIT for x86-64 Linux, everywhere else the program is interpreted. */
+nT32 run_jit(_bytecode *program, const uT8 *rodata)
+{
+    return run_bytecode(program, rodata, stdout);
+}
+#endif
+
+#endif
@@ -0,0 +1,161 @@
+/* Generates `keyword_table.h` from `keywords.def`.
+ *
+ * Usage: gen_keywords <keywords.def> <keyword_table.h>
+ *
+ * The table is a perfect hash: every keyword lands in its own slot, so looking a word up
+ * is one hash and one compare. The hash only looks at the length and at the first, middle
+ * and last character of a word, so it costs the same no matter how long an identifier is.
+ * */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define max_keywords        64
+#define max_field_length    32
+
+/* The table has `1 << table_bits` slots. */
+#define table_bits          7
+#define table_size          (1 << table_bits)
+
+typedef struct keyword_entry
+{
+    char    word[max_field_length];
+    char    sum_type[max_field_length];
+    char    sum_token[max_field_length];
+    char    mem_token[max_field_length];
+} _keyword_entry;
+
+static _keyword_entry keywords[max_keywords];
+static int keyword_amount = 0;
+
+/* Must be identical to `keyword_hash` in `keywords.h`. */
+static uint32_t hash(const char *word, uint32_t length, const uint32_t seeds[4])
+{
+    uint32_t h = (uint8_t) word[0] * seeds[0] +
+                 (uint8_t) word[length / 2] * seeds[1] +
+                 (uint8_t) word[length - 1] * seeds[2] +
+                 length * seeds[3];
+
+    return h >> (32 - table_bits);
+}
+
+/* Tiny xorshift so the search for seeds is reproducible. */
+static uint32_t next_random(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static int read_definitions(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if(!f) { fprintf(stderr, "gen_keywords: cannot open `%s`.\n", path); return 0; }
+
+    char line[256];
+    while(fgets(line, sizeof(line), f))
+    {
+        if(line[0] == '#' || line[0] == '\n') continue;
+
+        if(keyword_amount == max_keywords)
+        {
+            fprintf(stderr, "gen_keywords: more than %d keywords.\n", max_keywords);
+            fclose(f);
+            return 0;
+        }
+
+        _keyword_entry *k = &keywords[keyword_amount];
+        if(sscanf(line, "%31s %31s %31s %31s", k->word, k->sum_type, k->sum_token, k->mem_token) != 4)
+        {
+            fprintf(stderr, "gen_keywords: malformed line `%s`.\n", line);
+            fclose(f);
+            return 0;
+        }
+
+        keyword_amount++;
+    }
+
+    fclose(f);
+    return 1;
+}
+
+/* Look for seeds that give every keyword its own slot. */
+static int find_seeds(uint32_t seeds[4], int slots[max_keywords])
+{
+    uint32_t state = 0x2545F491;
+
+    for(uint32_t attempt = 0; attempt < 1000000; attempt++)
+    {
+        int used[table_size];
+        int collided = 0;
+        memset(used, 0, sizeof(used));
+
+        for(int i = 0; i < 4; i++) seeds[i] = next_random(&state) | 1;
+
+        for(int i = 0; i < keyword_amount; i++)
+        {
+            slots[i] = hash(keywords[i].word, strlen(keywords[i].word), seeds);
+            if(used[slots[i]]) { collided = 1; break; }
+            used[slots[i]] = 1;
+        }
+
+        if(!collided) return 1;
+    }
+
+    return 0;
+}
+
+int main(int args, char *argv[])
+{
+    if(args != 3)
+    {
+        fprintf(stderr, "Usage: %s <keywords.def> <keyword_table.h>\n", argv[0]);
+        return 1;
+    }
+
+    if(!read_definitions(argv[1])) return 1;
+
+    uint32_t seeds[4];
+    int slots[max_keywords];
+    if(!find_seeds(seeds, slots))
+    {
+        fprintf(stderr, "gen_keywords: no perfect hash found, two keywords share length and first/middle/last characters.\n");
+        return 1;
+    }
+
+    size_t min_length = (size_t) -1, max_length = 0;
+    for(int i = 0; i < keyword_amount; i++)
+    {
+        size_t length = strlen(keywords[i].word);
+        if(length < min_length) min_length = length;
+        if(length > max_length) max_length = length;
+    }
+
+    FILE *out = fopen(argv[2], "w");
+    if(!out) { fprintf(stderr, "gen_keywords: cannot write `%s`.\n", argv[2]); return 1; }
+
+    fprintf(out, "/* Generated by `gen_keywords` from `keywords.def`. Do not edit. */\n");
+    fprintf(out, "#ifndef keyword_table\n#define keyword_table\n\n");
+    fprintf(out, "#define keyword_table_bits      %d\n", table_bits);
+    fprintf(out, "#define keyword_min_length      %zu\n", min_length);
+    fprintf(out, "#define keyword_max_length      %zu\n", max_length);
+    for(int i = 0; i < 4; i++)
+        fprintf(out, "#define keyword_seed_%d          0x%08XU\n", i, seeds[i]);
+
+    fprintf(out, "\nstatic const _keyword keyword_slots[%d] = {\n", table_size);
+    for(int i = 0; i < keyword_amount; i++)
+    {
+        _keyword_entry *k = &keywords[i];
+        fprintf(out, "    [%3d] = { \"%s\", %zu, %s, %s, %s },\n",
+            slots[i], k->word, strlen(k->word),
+            strcmp(k->sum_type, "-") == 0 ? "NONE" : k->sum_type,
+            strcmp(k->sum_token, "-") == 0 ? "0" : k->sum_token,
+            strcmp(k->mem_token, "-") == 0 ? "DM_DEF" : k->mem_token);
+    }
+    fprintf(out, "};\n\n#endif\n");
+
+    fclose(out);
+    return 0;
+}
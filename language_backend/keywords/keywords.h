@@ -0,0 +1,48 @@
+#ifndef keyword_lookup
+#define keyword_lookup
+
+/* A reserved word of `.sum` and/or `.mem`.
+ * `sum_type` is `NONE` when the word means nothing to the `.sum` lexer,
+ * `mem_token` is `DM_DEF` when the word means nothing to the `.mem` lexer.
+ * */
+typedef struct keyword
+{
+    const nT8           *word;
+    uT8                 length;
+
+    /* `enum token_type` and `enum keyword_tokens`/`enum DT_tokens` for `.sum`. */
+    uT8                 sum_type;
+    uT8                 sum_token;
+
+    /* `enum dot_mem_tokens` for `.mem`. */
+    uT8                 mem_token;
+} _keyword;
+
+/* Generated from `keywords.def` by the Makefile. */
+#include "keyword_table.h"
+
+/* Must be identical to `hash` in `gen_keywords.c`. */
+static inline uT32 keyword_hash(const uT8 *word, uSIZE length)
+{
+    uT32 h = word[0] * keyword_seed_0 +
+             word[length / 2] * keyword_seed_1 +
+             word[length - 1] * keyword_seed_2 +
+             (uT32) length * keyword_seed_3;
+
+    return h >> (32 - keyword_table_bits);
+}
+
+/* Find the keyword `word` is, if any.
+ * `word` does not need to be `\0` terminated. NULL means `word` is an identifier.
+ * */
+const _keyword *lookup_keyword(const uT8 *word, uSIZE length)
+{
+    if(length < keyword_min_length || length > keyword_max_length) return NULL;
+
+    const _keyword *k = &keyword_slots[keyword_hash(word, length)];
+    if(k->length == length && memcmp(k->word, word, length) == 0) return k;
+
+    return NULL;
+}
+
+#endif
@@ -1,21 +1,43 @@
 #ifndef lexer
 #define lexer
+#include "context.h"
+#include "source_buffer.h"
+#include "arena.h"
+#include "scan.h"
+#include "dfa/dfa.h"
+#include "line_index.h"
+#include <math.h>
 
 typedef struct lexer
 {
+    /* The compilation the lexer is part of. */
+    _compiler_context   *context;
+
+    /* Where `file_source_code` comes from. */
+    _source_buffer  *source;
+
+    /* Borrowed from `source`. */
     uT8         *file_source_code;
 
-    /* We shouldn't need more then 4 bytes for the index. */
-    uT32        source_code_index;
+    /* 8 bytes, so sources bigger than 4GiB can be lexed. */
+    uSIZE       source_code_index;
 
     /* Current value. */
     uT8         val;
 
     /* The size of the source code. */
-    sSIZE       source_code_size; 
+    uSIZE       source_code_size; 
+
+    /* Where `file_source_code` starts in the file.
+     * Always 0, unless streaming(then `file_source_code` is a window over the file).
+     * */
+    uSIZE       source_code_base;
 
-    /* What line are we on? */
-    nTL32       line;
+    /* Is there more source code after `file_source_code`? Only ever true when streaming. */
+    bool        more_input;
+
+    /* Where the lines of `file_source_code` start(see `lexer_line`). */
+    _line_index lines;
 } _lexer;
 
 /* Used in `get_GTV`. */
@@ -23,43 +45,118 @@ uT8 *make_uT8_ptr(uT8 val);
 
 #include "tokens.h"
 
-_lexer *init_lexer(nT8 *filename)
+bool next_lexer_window(_lexer *l);
+
+/* `streaming` - lex `filename` through a fixed size window(see `next_source_window`) instead
+ * of loading all of it. That bounds the source code held in memory, and the tokens(each window's are
+ * dropped before the next is lexed). The line index and the tree still grow with the size of `filename`:
+ * every later stage, and every error, needs all of them.
+ * */
+_lexer *init_lexer(_compiler_context *context, nT8 *filename, bool streaming)
 {
-    _lexer *language_lexer = calloc(1, sizeof(*language_lexer));
+    use_compiler_context(context);
 
-    language_lexer->file_source_code = NULL;
+    _lexer *language_lexer = front_end_alloc(sizeof(*language_lexer));
+
+    language_lexer->context = context;
     language_lexer->source_code_index = 0;
-    language_lexer->line = 1;
 
-    /* Get file content. */
-    FILE *source_code = fopen(filename, "r");
+    init_scan_kernels();
 
-    /* Check the size of the file. */
-    fseek(source_code, 0, SEEK_END);
-    language_lexer->source_code_size = ftell(source_code);
-    lang_assert(language_lexer->source_code_size > 1, "The file `%s` is empty.\n\tTry putting some code in the file.\n", file_has_no_data_error, filename)
-    fseek(source_code, 0, SEEK_SET);
+    /* Get file content. The lexer borrows the buffer, it does not copy it. */
+    if(streaming) language_lexer->source = init_source_stream(filename, source_window_size);
+    else language_lexer->source = init_source_buffer(filename);
+    lang_assert(language_lexer->source,
+        "The file `%s` doesn't exist, or the path is wrong.\n",
+        file_not_exist_error, filename)
 
-    /* Allocate the required memory and make sure it is valid. */
-    language_lexer->file_source_code = calloc(language_lexer->source_code_size, sizeof(*language_lexer->file_source_code));
-    lang_assert(language_lexer->file_source_code, 
-        "Error allocating memory to lex the source code for `%s`.\n\tTry running the program again.\n", 
-        OOC_allocation_error, filename)
+    if(streaming) next_lexer_window(language_lexer);
+    else
+    {
+        language_lexer->file_source_code = language_lexer->source->data;
+        language_lexer->source_code_size = language_lexer->source->size;
+        build_line_index(&language_lexer->lines, language_lexer->file_source_code, language_lexer->source_code_size, 0, 1);
+    }
 
-    nTL32 read_size = fread(language_lexer->file_source_code, sizeof(nT8), language_lexer->source_code_size, source_code);
-    lang_assert(read_size == language_lexer->source_code_size, 
-        "Error reading in all of the source code for `%s`.\n", 
-        OOC_source_code_read_error, filename)
+    /* Nothing refers to the lexer once the error is reported, so the source code goes with it. */
+    if(language_lexer->source_code_size <= 1)
+    {
+        destroy_line_index(&language_lexer->lines);
+        destroy_source_buffer(language_lexer->source);
+        language_lexer->source = NULL;
 
-    fclose(source_code);
+        lang_error("The file `%s` is empty.\n\tTry putting some code in the file.\n", file_has_no_data_error, filename)
+    }
 
     language_lexer->val = language_lexer->file_source_code[language_lexer->source_code_index];
     return language_lexer;
 }
 
+/* Move the lexer on to the next window of the source code(streaming only).
+ * Returns false once there is no source code left.
+ * */
+bool next_lexer_window(_lexer *l)
+{
+    if(!(next_source_window(l->source))) return false;
+
+    l->file_source_code = l->source->data;
+    l->source_code_size = l->source->size;
+    l->source_code_base = l->source->base;
+    l->source_code_index = 0;
+    l->val = l->file_source_code[0];
+    l->more_input = !(l->source->end_of_input && l->source->size == l->source->filled);
+    extend_line_index(&l->lines, l->file_source_code, l->source_code_size, l->source_code_base);
+
+    return true;
+}
+
+/* Point the lexer at `size` bytes of the source code, starting at `base`. */
+void set_lexer_region(_lexer *l, uSIZE base, uSIZE size)
+{
+    l->file_source_code = &l->source->data[base];
+    l->source_code_base = base;
+    l->source_code_size = size;
+    l->source_code_index = 0;
+    l->val = l->file_source_code[0];
+    l->more_input = base + size < l->source->size;
+}
+
+/* A lexer over `size` bytes of `source`, starting at `base`(which is on line `first_line`).
+ * `source` stays owned by the caller, so the lexer is released with `destroy_line_index(&l->lines)`
+ * rather than `destroy_lexer`.
+ * */
+_lexer *init_lexer_region(_compiler_context *context, _source_buffer *source, uSIZE base, uSIZE size, nTL32 first_line)
+{
+    use_compiler_context(context);
+
+    _lexer *l = front_end_alloc(sizeof(*l));
+
+    l->context = context;
+    l->source = source;
+    set_lexer_region(l, base, size);
+    build_line_index(&l->lines, l->file_source_code, size, base, first_line);
+
+    return l;
+}
+
+/* Line the lexer is on, for diagnostics. */
+nTL32 lexer_line(_lexer *l)
+{
+    return line_of_offset(&l->lines, l->source_code_base + l->source_code_index);
+}
+
+/* Column the lexer is on, for diagnostics. */
+nTL32 lexer_column(_lexer *l)
+{
+    return column_of_offset(&l->lines, l->source_code_base + l->source_code_index);
+}
+
+/* Move to the next character.
+ * Moving past the last character leaves the lexer on the `\0` that follows the source code.
+ * */
 void move_forward(_lexer *l)
 {
-    if(l->source_code_index + 1 < l->source_code_size)
+    if(l->source_code_index < l->source_code_size)
     {
         l->source_code_index++;
         l->val = l->file_source_code[l->source_code_index];
@@ -68,26 +165,25 @@ void move_forward(_lexer *l)
 
 void move_backward(_lexer *l)
 {
-    if(l->source_code_index - 1 > 0)
+    if(l->source_code_index > 0)
     {
         l->source_code_index--;
         l->val = l->file_source_code[l->source_code_index];
     }
 }
 
-bool lexer_peek(_lexer *l, uT8 against_char)
+/* Jump straight to `to`(obtained from one of the scan kernels). */
+void move_to(_lexer *l, const uT8 *to)
 {
-    if(l->file_source_code[l->source_code_index + 1] == against_char) { move_forward(l); return true; }
-    return false;
+    l->source_code_index = to - l->file_source_code;
+    l->val = l->file_source_code[l->source_code_index];
 }
 
-uT8 lexer_peek_and_return(_lexer *l)
-{
-    if(l->source_code_index != l->source_code_size - 1) return l->file_source_code[l->source_code_index + 1];
-    return l->val;
-}
+/* End of the source code, for the scan kernels. */
+#define source_end(l)   (&(l)->file_source_code[(l)->source_code_size])
+#define source_here(l)  (&(l)->file_source_code[(l)->source_code_index])
 
-uT8 *reallocate_uT8_ptr(uT8 *src, uT8 index)
+uT8 *reallocate_uT8_ptr(uT8 *src, uSIZE index)
 {
     src = realloc(
         src,
@@ -106,265 +202,280 @@ uT8 *make_uT8_ptr(uT8 val)
     return word;
 }
 
-uT8 *obtain_ascii(_lexer *l, bool getting_string, uT8 opening_quote)
+/* Value of a hexadecimal digit. */
+#define hex_digit_value(c)  ((c) <= '9' ? (c) - '0' : ((c) | 0x20) - 'a' + 10)
+
+/* Powers of ten a double holds exactly(see `obtain_number`). */
+static const double exact_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Decode the number the DFA found(`length` bytes at the lexer), and move past it.
+ * Nothing after the lexer ever looks at the digits of a number again.
+ * `123` is a `DT_integer`, `0x1F` and `1Fh` are `DT_hex`(both 64-bit), `1.5` is a `DT_float`(a double).
+ * The value is stored in `number`, the type of number is returned.
+ * */
+enum DT_tokens obtain_number(_lexer *l, uSIZE length, _token_number *number)
 {
-    uT8 *word = calloc(1, sizeof(*word));
-    uT8 index = 0;
+    const uT8 *start = source_here(l), *p = start, *end = start + length;
+    uSIZE decimal = 0, hex = 0;
+    bool decimal_overflow = false, hex_overflow = false, hex_letters = false;
+    bool prefixed = length > 1 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X');
+    enum DT_tokens type = DT_integer;
 
-    cont:
-    while(is_ascii(l->val))
+    if(prefixed)
     {
-        if(getting_string && l->val == '\n')
-            lang_error("Unexpected newline on line %ld.\n", 
-                unexpected_new_line_error, l->line)
-
-        /* If we're getting a string make sure the beginning quotation grammar matches the end.
-         * We can't have, for example, "a string'.
-         * */
-        if(getting_string && ((lexer_peek_and_return(l) == '\'' && opening_quote == '"') ||
-           (lexer_peek_and_return(l) == '"' && opening_quote == '\'')))
-           lang_error("Mismatch of grammar on line %ld.\n\tExpecting `%c` (G_double_quote), got `%c` (%s).\n",
-            grammar_mismatch_error, l->line, opening_quote, lexer_peek_and_return(l), token_name(0, uT8_PC make_uT8_ptr(lexer_peek_and_return(l)), GR))
-
-        word[index] = l->val;
-        index++;
-        word = reallocate_uT8_ptr(word, index);
-        move_forward(l);
-
-        /* If we are getting a string and run into a value that is not >= 'a' <= 'z' / >= 'A' <= 'Z', still append it to `word`. */
-        if(getting_string && !(is_ascii(l->val)))
-        {
-            while(!(is_ascii(l->val)))
-            {
-                /* If we run into a quotation mark and are obtaining a string, break. */
-                if(l->val == '\'' || l->val == '"') break;
-
-                word[index] = l->val;
-                index++;
-                word = reallocate_uT8_ptr(word, index);
-                move_forward(l);
-            }
-            
-            if(l->val == '\'' || l->val == '"')
-            {
-                /* Make sure the end quotation matches the beginning quotation. */
-                lang_assert(l->val == opening_quote, 
-                    "Mismatch of quotes on line %ld.\n", 
-                    grammar_mismatch_error, l->line)
-
-                goto end;
-            }
-
-            goto cont;
-        }
+        p += 2;
+        lang_assert(p < end && (is_hex_valid_ascii(*p)),
+            "Unexpected end of hexadecimal number on line %ld.\n",
+            unexpected_end_of_hex_error, lexer_line(l))
     }
 
-    end:
-    memset(&word[index], '\0', 1);
-    return word;
-}
+    /* Until a `.` or `h` shows up, the digits could be decimal or hexadecimal, so both values are kept. */
+    for(; p < end && (is_hex_valid_ascii(*p)); p++)
+    {
+        if(is_number(*p))
+            decimal_overflow |= __builtin_mul_overflow(decimal, 10, &decimal) ||
+                                __builtin_add_overflow(decimal, *p - '0', &decimal);
+        else hex_letters = true;
 
-uT8 *obtain_number(_lexer *l)
-{
-    uT8 *number = calloc(1, sizeof(*number));
-    uT8 index = 0;
+        hex_overflow |= hex >> 60 != 0;
+        hex = (hex << 4) | hex_digit_value(*p);
+    }
 
-    cont:
-    while(is_number(l->val) || is_hex_valid_ascii(l->val))
+    if(prefixed || (p < end && *p == 'h'))
     {
-        number[index] = l->val;
-        index++;
+        if(!(prefixed)) p++;
 
-        number = realloc(
-            number,
-            (index + 1) * sizeof(*number)
-        );
-        move_forward(l);
+        lang_assert(!(hex_overflow),
+            "The hexadecimal number on line %ld is too large.\n\tHexadecimal numbers are 64-bit, at most 16 digits.\n",
+            lexing_too_large_number_error, lexer_line(l))
 
-        switch(l->val)
+        number->integer = hex;
+        type = DT_hex;
+    }
+    else if(p < end && *p == '.')
+    {
+        lang_assert(!(hex_letters),
+            "Hexadecimal digits in a decimal number on line %ld.\n\tHexadecimal numbers start with `0x` or end with `h`.\n",
+            lexing_invalid_hex_value_error, lexer_line(l))
+
+        p++;
+        lang_assert(p < end && (is_number(*p)),
+            "Unexpected end of decimal number on line %ld.\n",
+            unexpected_end_of_decimal_error, lexer_line(l))
+
+        /* The digits either side of the `.` as one integer, and how many of them are after the `.`. */
+        uSIZE fraction_digits = 0;
+        for(; p < end && (is_number(*p)); p++, fraction_digits++)
+            decimal_overflow |= __builtin_mul_overflow(decimal, 10, &decimal) ||
+                                __builtin_add_overflow(decimal, *p - '0', &decimal);
+
+        /* When the digits fit in the 53 bits of a double and the power of ten is exact, one division
+         * is correctly rounded. Anything else(very long decimals) goes through `strtod`.
+         * */
+        if(!(decimal_overflow) && decimal <= (1ULL << 53) && fraction_digits <= 22)
+            number->decimal = (double) decimal / exact_powers_of_ten[fraction_digits];
+        else
         {
-            case '.': {
-                number[index] = l->val;
-                index++;
-
-                number = realloc(
-                    number,
-                    (index + 1) * sizeof(*number)
-                );
-
-                lang_assert(is_number(lexer_peek_and_return(l)), 
-                    "Unexpected end of hexadecimal number on line %ld.\n",
-                    unexpected_end_of_decimal_error, l->line)
-
-                move_forward(l);
-                goto cont;
-                break;
-            }
-            case 'x': {
-                number[index] = l->val;
-                index++;
-
-                number = realloc(
-                    number,
-                    (index + 1) * sizeof(*number)
-                );
-
-                lang_assert(is_number(lexer_peek_and_return(l)) || is_hex_valid_ascii(lexer_peek_and_return(l)),
-                    "Unexpected end of hexadecimal number on line %ld.\n",
-                    unexpected_end_of_hex_error, l->line)
-
-                move_forward(l);
-                goto cont;
-                break;
-            }
-            case 'h': {
-                number[index] = l->val;
-                index++;
-
-                number = realloc(
-                    number,
-                    (index + 1) * sizeof(*number)
-                );
-
-                lang_assert(!(is_number(lexer_peek_and_return(l)) || is_hex_valid_ascii(l->val)),
-                    "Trailing numbers after hexadecimal number ended on line %ld.\n",
-                    trailing_numbers_after_eoh_error, l->line)
-
-                if(!(lexer_peek(l, '\0'))) move_forward(l);
-                goto end;
-            }
-            default: break;
+            nT8 *digits = strndup(nT8_PCC start, p - start);
+            lang_assert(digits,
+                "Error allocating memory for a decimal number.\n\tTry rerunning the program.\n",
+                OOC_allocation_error)
+
+            number->decimal = strtod(digits, NULL);
+            free(digits);
+
+            lang_assert(!(isinf(number->decimal)),
+                "The decimal number on line %ld is too large.\n",
+                lexing_too_large_number_error, lexer_line(l))
         }
+
+        type = DT_float;
     }
+    else
+    {
+        lang_assert(!(hex_letters),
+            "Hexadecimal digits in a decimal number on line %ld.\n\tHexadecimal numbers start with `0x` or end with `h`.\n",
+            lexing_invalid_hex_value_error, lexer_line(l))
+        lang_assert(!(decimal_overflow),
+            "The number on line %ld is too large.\n\tIntegers are 64-bit, the largest is %llu.\n",
+            lexing_too_large_number_error, lexer_line(l), ~0ULL)
+
+        number->integer = decimal;
+    }
+
+    /* A number has to end where it ends. `0xABT`, for example, is not a number. */
+    lang_assert(p == end,
+        "Invalid character `%c` at the end of a number on line %ld.\n",
+        lexing_invalid_hex_value_error, *p, lexer_line(l))
 
-    end:
-    memset(&number[index], '\0', 1);
-    return number;
+    move_to(l, end);
+    return type;
 }
 
-bool is_decimal(uT8 *number)
+/* Make a single character grammar token and move past it. */
+static void make_grammar_token(_lexer *l, enum grammar_tokens GTT)
 {
-    uT8 index = 0;
-    while(number[index] != '\0')
-        if(number[index++] == '.') return true;
-    
-    return false;
+    make_new_token(l, GR, GTT, l->source_code_index, 1);
+    move_forward(l);
 }
 
-bool is_hex(uT8 *number)
+/* Lex the next token into `token_stream`.
+ * `opening_quote` is the quotation the string being lexed was opened with, or 0 when not inside of a string.
+ * Inside of a string the DFA starts in `dfa_start_sum_string`, where blanks are part of the string.
+ * */
+_lexer *get_next_state(_lexer *lang_lexer, uT8 opening_quote)
 {
-    uT8 index = 0;
-    while(number[index] != '\0')
+    uSIZE start, length;
+    uT8 matched;
+
+    do {
+        start = lang_lexer->source_code_index;
+
+        if(start == lang_lexer->source_code_size)
+        {
+            make_new_token(lang_lexer, END, G_end_of_file, start, 0);
+            return lang_lexer;
+        }
+
+        matched = dfa_match(opening_quote ? dfa_start_sum_string : dfa_start_sum, source_here(lang_lexer), source_end(lang_lexer), &length);
+        if(matched == DFA_blank) move_to(lang_lexer, source_here(lang_lexer) + length);
+    } while(matched == DFA_blank);
+
+    /* An error lexing the token is where the token starts, not where the blanks before it do. */
+    diagnose_at(lang_lexer->source_code_base + start);
+
+    switch(matched)
     {
-        if(number[index] == 'h' || number[index] == 'x')
-            return true;
-        
-        index++;
+        case DFA_word: {
+            /* A single letter is a character, anything longer is a keyword or a variable name. */
+            if(length == 1) make_new_token(lang_lexer, DT, DT_char, start, 1);
+            else make_new_token_alone(lang_lexer, start, length);
+
+            move_to(lang_lexer, source_here(lang_lexer) + length);
+            break;
+        }
+        case DFA_number: {
+            _token_number number;
+            enum DT_tokens number_type = obtain_number(lang_lexer, length, &number);
+
+            make_new_token(lang_lexer, DT, number_type, start, length)->number = number;
+            break;
+        }
+        case DFA_string_body: {
+            /* Anything up until the closing quotation is part of the string. The body is not copied,
+             * the token refers to it in the source code.
+             * */
+            make_new_token(lang_lexer, DT, DT_string, start, length);
+            move_to(lang_lexer, source_here(lang_lexer) + length);
+
+            if(lang_lexer->source_code_index == lang_lexer->source_code_size)
+                lang_error("Unexpected EOF in string on line %ld.\n",
+                    unexpected_EOF, lexer_line(lang_lexer))
+            break;
+        }
+        case DFA_newline: {
+            lang_error("Unexpected newline on line %ld, column %ld.\n", 
+                unexpected_new_line_error, lexer_line(lang_lexer), lexer_column(lang_lexer))
+        }
+        case DFA_single_quote:
+        case DFA_double_quote: {
+            /* Make sure the end quotation matches the beginning quotation.
+             * We can't have, for example, "a string'.
+             * */
+            if(opening_quote && lang_lexer->val != opening_quote)
+                lang_error("Mismatch of grammar on line %ld.\n\tExpecting `%c` (%s), got `%c` (%s).\n",
+                    grammar_mismatch_error, lexer_line(lang_lexer), opening_quote, token_name(decipher_GTT(opening_quote), NULL, NONE), lang_lexer->val, token_name(decipher_GTT(lang_lexer->val), NULL, NONE))
+
+            make_grammar_token(lang_lexer, matched == DFA_single_quote ? G_single_quote : G_double_quote);
+            break;
+        }
+        case DFA_left_par: make_grammar_token(lang_lexer, G_left_par);break;
+        case DFA_right_par: make_grammar_token(lang_lexer, G_right_par);break;
+        case DFA_equals: make_grammar_token(lang_lexer, G_equals);break;
+        case DFA_hashtag: make_grammar_token(lang_lexer, G_hashtag);break;
+        case DFA_comma: make_grammar_token(lang_lexer, G_comma);break;
+        default: {
+            /* A `\0` in the middle of the source code ends it. Anything else is an unknown character(see `tokenize`). */
+            if(lang_lexer->val == '\0')
+                make_new_token(lang_lexer, END, G_end_of_file, start, 0);
+            break;
+        }
     }
 
-    return false;
+    return lang_lexer;
 }
 
-uT8 *validate_hex(uT8 *hex)
+/* After an error: drop the tokens of the line the lexer is on, and move on to the start of the next line.
+ * The parser never sees the line, so it does not report errors of its own for it.
+ * */
+static void skip_failed_line(_lexer *l)
 {
-    uT8 index = 0;
+    uSIZE here = l->source_code_base + l->source_code_index;
+    uSIZE line_start = line_start_offset(&l->lines, line_of_offset(&l->lines, here), here);
 
-    while(hex[index] != 'x' && hex[index] != 'h')
-        index++;
+    while(token_stream->amount && token_stream->entries[token_stream->amount - 1].offset >= line_start)
+        token_stream->amount--;
 
-    return hex;
+    const uT8 *newline = memchr(source_here(l), '\n', l->source_code_size - l->source_code_index);
+    move_to(l, newline ? newline + 1 : source_end(l));
 }
 
-_lexer *get_next_state(_lexer *lang_lexer, bool expect_string, uT8 opening_quote)
+/* Lex the entire source code into `token_stream`.
+ * The lexer keeps track of whether it is inside of a string itself, so the parser
+ * never has to tell it.
+ *
+ * An error(see `diagnostics.h`) costs the line it is on, lexing carries on with the next one.
+ * */
+void tokenize(_lexer *l)
 {
-    if(lang_lexer->source_code_index == lang_lexer->source_code_size - 1)
-        { make_new_token(END, uT8_PC "\0", G_end_of_file); goto end; }
+    uT8 opening_quote = 0;
+    jmp_buf recovery;
 
-    if(lang_lexer->val == ' ')
-    {
-        while(lang_lexer->val == ' ' && 
-             !(lang_lexer->file_source_code[lang_lexer->source_code_index] == '\0') &&
-             !(lang_lexer->source_code_index == lang_lexer->source_code_size - 1))
-            move_forward(lang_lexer);
-    }
-    if(lang_lexer->val == '\n')
-    {
-        lang_lexer->line++;
-        while(lang_lexer->val == '\n' && 
-             !(lang_lexer->file_source_code[lang_lexer->source_code_index] == '\0') &&
-             !(lang_lexer->source_code_index == lang_lexer->source_code_size - 1))
-            move_forward(lang_lexer);
-    }
+    use_compiler_context(l->context);
+    if(!(token_stream)) init_token_stream(l);
+    else reset_token_stream(l);
 
-    if(is_ascii(lang_lexer->val))
+    jmp_buf *outer = catch_errors(&recovery);
+    if(setjmp(recovery))
     {
-        if(!(is_ascii(lexer_peek_and_return(lang_lexer))))
-        {
-            uT8 *val = make_uT8_ptr(lang_lexer->val);
-            make_new_token(DT, uT8_PC val, DT_char);
-
-            free(val);
-            val = NULL;
-
-            goto ret1; 
-        }
-        
-        uT8 *word = obtain_ascii(lang_lexer, expect_string, opening_quote);
-        make_new_token_alone(word, lang_lexer);
-
-        free(word);
-        word = NULL;
-
-        ret1:
-        return lang_lexer;
+        opening_quote = 0;
+        skip_failed_line(l);
     }
 
-    if(is_number(lang_lexer->val))
+    while(true)
     {
-        uT8 *number = obtain_number(lang_lexer);
+        uT32 amount_before = token_stream->amount;
+        get_next_state(l, opening_quote);
 
-        if(is_decimal(number)) { make_new_token(DT, uT8_PC number, DT_float); goto ret2; }
-        if(is_hex(number)) { validate_hex(number); make_new_token(DT, uT8_PC number, DT_hex); goto ret2; }
-        
-        make_new_token(DT, uT8_PC number, DT_integer);
+        lang_assert(token_stream->amount > amount_before,
+            "Unknown character `%c` on line %ld, column %ld.\n",
+            lexing_tokenization_error, l->val, lexer_line(l), lexer_column(l))
 
-        ret2:
-        free(number);
-        number = NULL;
+        _token *t = &token_stream->entries[token_stream->amount - 1];
+        if(t->type_of_token == END) break;
 
-        return lang_lexer;
+        /* An opening quotation starts a string, the next quotation ends it. */
+        if(t->type_of_token == GR && (t->token_id == G_single_quote || t->token_id == G_double_quote))
+            opening_quote = opening_quote ? 0 : l->file_source_code[t->offset - l->source_code_base];
     }
 
-    switch(lang_lexer->val)
-    {
-        case '\'': { make_new_token(GR, uT8_PC "'", G_single_quote); move_forward(lang_lexer); return lang_lexer; break; }
-        case '(': { make_new_token(GR, uT8_PC "(", G_left_par); move_forward(lang_lexer); return lang_lexer; break; }
-        case ')': { make_new_token(GR, uT8_PC ")", G_right_par); move_forward(lang_lexer); return lang_lexer; break; }
-        case '=': { make_new_token(GR, uT8_PC "=", G_equals); move_forward(lang_lexer); return lang_lexer; break; }
-        case '#': { make_new_token(GR, uT8_PC "#", G_hashtag); move_forward(lang_lexer); return lang_lexer; break; }
-        case ',': { make_new_token(GR, uT8_PC ",", G_comma); move_forward(lang_lexer); return lang_lexer; break; }
-        case '"': { make_new_token(GR, uT8_PC "\"", G_double_quote); move_forward(lang_lexer); return lang_lexer; break; }
-        default: break;
-    }
-    
-    if(lang_lexer->file_source_code[lang_lexer->source_code_index] == '\0')
-        make_new_token(END, uT8_PC "\0", G_end_of_file);
-    
-    end:
-    return lang_lexer;
+    stop_catching_errors(outer);
 }
 
 void destroy_lexer(_lexer *lex)
 {
     if(!(lex)) return;
 
-    /* Free the source code. */
-    free(lex->file_source_code);
+    /* Release the source code. */
+    destroy_line_index(&lex->lines);
+    destroy_source_buffer(lex->source);
+    lex->source = NULL;
     lex->file_source_code = NULL;
 
-    /* Free the overall structure pointer. */
-    free(lex);
-    lex = NULL;
+    /* The lexer itself goes with `front_end_arena`. */
 }
 
 #endif
\ No newline at end of file
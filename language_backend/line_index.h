@@ -0,0 +1,124 @@
+#ifndef line_indexing
+#define line_indexing
+
+/* Where every line of the source code starts.
+ * Diagnostics turn a token offset into a line and column with a binary search over `starts`,
+ * so the lexer never has to count lines itself.
+ * */
+typedef struct line_index
+{
+    /* `starts[i]` is the offset(into the whole file) of the first byte of line `first_line + i`. */
+    uSIZE       *starts;
+    uSIZE       amount;
+    uSIZE       capacity;
+
+    /* Line number of `starts[0]`. Always 1, unless the index only covers a chunk(see `parallel.h`). */
+    uSIZE       first_line;
+} _line_index;
+
+/* Index the lines of `data`(`size` bytes at offset `base` in the file, starting on line `first_line`).
+ * The newlines are counted with `count_newlines` first, so `starts` is sized exactly once.
+ * */
+void build_line_index(_line_index *index, const uT8 *data, uSIZE size, uSIZE base, uSIZE first_line)
+{
+    uSIZE amount = scan_kernels.count_newlines(data, data + size) + 1;
+
+    if(amount > index->capacity)
+    {
+        index->capacity = amount;
+        index->starts = realloc(index->starts, index->capacity * sizeof(*index->starts));
+        lang_assert(index->starts,
+            "Error allocating memory for the line index(%llu lines).\n",
+            OOC_allocation_error, amount)
+    }
+
+    index->first_line = first_line;
+    index->amount = 1;
+    index->starts[0] = base;
+
+    /* `memchr` is vectorized by libc, so this is no slower than the count. */
+    const uT8 *p = data, *end = data + size;
+    while((p = memchr(p, '\n', end - p)))
+    {
+        p++;
+        index->starts[index->amount] = base + (p - data);
+        index->amount++;
+    }
+}
+
+/* Index the lines of the next window(streaming only), keeping the lines of the windows before it.
+ * Errors are reported once the whole file is parsed, by then the window they were found in is gone.
+ * Windows always end right after a newline, so the last line indexed starts at `base`.
+ * */
+void extend_line_index(_line_index *index, const uT8 *data, uSIZE size, uSIZE base)
+{
+    if(!(index->amount))
+    {
+        build_line_index(index, data, size, base, 1);
+        return;
+    }
+
+    uSIZE amount = index->amount + scan_kernels.count_newlines(data, data + size);
+
+    if(amount > index->capacity)
+    {
+        index->capacity = amount > index->capacity * 2 ? amount : index->capacity * 2;
+        index->starts = realloc(index->starts, index->capacity * sizeof(*index->starts));
+        lang_assert(index->starts,
+            "Error allocating memory for the line index(%llu lines).\n",
+            OOC_allocation_error, amount)
+    }
+
+    const uT8 *p = data, *end = data + size;
+    while((p = memchr(p, '\n', end - p)))
+    {
+        p++;
+        index->starts[index->amount] = base + (p - data);
+        index->amount++;
+    }
+}
+
+/* Which entry of `starts` is the line holding `offset`? */
+static uSIZE line_index_search(_line_index *index, uSIZE offset)
+{
+    uSIZE low = 0, high = index->amount;
+
+    /* Find the last line that starts at or before `offset`. */
+    while(high - low > 1)
+    {
+        uSIZE middle = low + (high - low) / 2;
+
+        if(index->starts[middle] <= offset) low = middle;
+        else high = middle;
+    }
+
+    return low;
+}
+
+/* Line number of the byte at `offset` in the file. */
+nTL32 line_of_offset(_line_index *index, uSIZE offset)
+{
+    return index->first_line + line_index_search(index, offset);
+}
+
+/* Column(starting at 1) of the byte at `offset` in the file. */
+nTL32 column_of_offset(_line_index *index, uSIZE offset)
+{
+    return offset - index->starts[line_index_search(index, offset)] + 1;
+}
+
+/* Offset of the first byte of `line`, or `fallback` if `line` is past the end of the index. */
+uSIZE line_start_offset(_line_index *index, uSIZE line, uSIZE fallback)
+{
+    if(line < index->first_line || line - index->first_line >= index->amount) return fallback;
+    return index->starts[line - index->first_line];
+}
+
+void destroy_line_index(_line_index *index)
+{
+    free(index->starts);
+    index->starts = NULL;
+    index->amount = index->capacity = 0;
+}
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef parallel_front_end
+#define parallel_front_end
+#include <pthread.h>
+
+/* Chunks smaller than this are not worth a thread. */
+#define parallel_min_chunk_size     0x10000
+
+/* A piece of the source code that is lexed and parsed on a thread of its own.
+ * Chunks always start at the beginning of a line and end after a newline(or at the end of the file).
+ * */
+typedef struct front_end_chunk
+{
+    /* Bytes [`base`, `base + size`) of the source code, `base` is on line `first_line`. */
+    uSIZE           base;
+    uSIZE           size;
+    nTL32           first_line;
+
+    _source_buffer  *source;
+    pthread_t       thread;
+
+    /* The compilation the chunk is part of. The chunk runs as a compilation of its own, that borrows the memory info of this one. */
+    _compiler_context   *whole;
+
+    /* The ast of the chunk, and the symbols its nodes refer to. */
+    _ast_tree       segment;
+    _symbol_table   *local_symbols;
+
+    /* The errors found in the chunk. */
+    _diagnostics    diagnostics;
+} _front_end_chunk;
+
+static void *run_chunk(void *argument)
+{
+    _front_end_chunk *chunk = argument;
+
+    _compiler_context *context = new_compiler_context();
+    context->memory_info = chunk->whole->memory_info;
+
+    _lexer *l = init_lexer_region(context, chunk->source, chunk->base, chunk->size, chunk->first_line);
+    _parser *p = init_parser(l);
+
+    tokenize(l);
+    parse_tokens(p);
+
+    /* The last chunk ends the program. */
+    if(!(l->more_input) && !(ast_has_been_comitted())) commit_ast();
+
+    /* Hand the ast, symbols and errors over to the main thread, everything else goes. */
+    chunk->segment = tree;
+    chunk->local_symbols = symbol_table;
+    chunk->diagnostics = context->diagnostics;
+    tree = (_ast_tree) { 0 };
+    symbol_table = NULL;
+    context->diagnostics = (_diagnostics) { 0 };
+
+    /* The memory info is only borrowed. */
+    context->memory_info = NULL;
+
+    destroy_line_index(&l->lines);
+    destroy_compiler_context(context);
+
+    return NULL;
+}
+
+/* Lex and parse the source code of `lang_parser` on up to `jobs` threads.
+ *
+ * The first line is done by the calling thread, since it is the only line that can hold `#incmem`.
+ * The rest is split at newlines into chunks. Statements never span lines, so a chunk parses exactly
+ * the same as it would have as part of the whole file. Each chunk gets its own ast and symbol table,
+ * which are stitched onto `tree` in order afterwards; symbols are interned again in that order, so
+ * they get the same IDs as they would have serially.
+ *
+ * Each chunk keeps its own errors too, which are handed to the whole compilation; they are reported in
+ * source order(see `report_diagnostics`), so the diagnostics are the same as the serial run's.
+ * */
+void run_parser_parallel(_parser *lang_parser, uT32 jobs)
+{
+    use_compiler_context(lang_parser->context);
+
+    _lexer *l = lang_parser->lang_lexer;
+    _source_buffer *source = l->source;
+    uSIZE size = l->source_code_size;
+
+    /* The first line. */
+    const uT8 *newline = memchr(l->file_source_code, '\n', size);
+    uSIZE first_line_size = newline ? (uSIZE) (newline - l->file_source_code) + 1 : size;
+    uSIZE rest = size - first_line_size;
+
+    uT32 amount = rest / parallel_min_chunk_size;
+    if(amount > jobs) amount = jobs;
+
+    if(amount < 2)
+    {
+        run_parser(lang_parser);
+        return;
+    }
+
+    _front_end_chunk *chunks = calloc(amount, sizeof(*chunks));
+    lang_assert(chunks,
+        "Error allocating memory for the parallel front end.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    /* Split at the first newline after each `rest / amount` bytes. */
+    uSIZE start = first_line_size;
+    uT32 made = 0;
+    for(uT32 i = 0; i < amount && start < size; i++)
+    {
+        uSIZE end = first_line_size + rest / amount * (i + 1);
+
+        if(i == amount - 1 || end >= size) end = size;
+        else
+        {
+            newline = memchr(&l->file_source_code[end], '\n', size - end);
+            end = newline ? (uSIZE) (newline - l->file_source_code) + 1 : size;
+        }
+
+        chunks[made] = (_front_end_chunk) {
+            .base = start,
+            .size = end - start,
+            .first_line = line_of_offset(&l->lines, start),
+            .source = source,
+            .whole = lang_parser->context
+        };
+
+        made++;
+        start = end;
+    }
+
+    trace(TC_parser, TL_info, "Parsing %llu bytes in %llu chunks", rest, made);
+
+    /* The first line goes first, the chunks need whatever `#incmem` it has to say. */
+    set_lexer_region(l, 0, first_line_size);
+    tokenize(l);
+    parse_tokens(lang_parser);
+
+    for(uT32 i = 0; i < made; i++)
+    {
+        nT32 failed = pthread_create(&chunks[i].thread, NULL, run_chunk, &chunks[i]);
+        lang_assert(failed == 0,
+            "Error starting a thread for the parallel front end.\n\tTry rerunning without `--jobs`.\n",
+            OOC_allocation_error)
+    }
+
+    for(uT32 i = 0; i < made; i++)
+        pthread_join(chunks[i].thread, NULL);
+
+    /* Stitch the chunks on in order. */
+    for(uT32 i = 0; i < made; i++)
+    {
+        take_diagnostics(&active_context->diagnostics, &chunks[i].diagnostics);
+
+        _symbol_table *chunk_symbols = chunks[i].local_symbols;
+        uT32 *symbol_map = NULL;
+
+        if(chunk_symbols)
+        {
+            symbol_map = malloc(chunk_symbols->amount * sizeof(*symbol_map) + 1);
+            lang_assert(symbol_map,
+                "Error allocating memory for the parallel front end.\n\tTry rerunning the program.\n",
+                OOC_allocation_error)
+
+            for(uT32 id = 0; id < chunk_symbols->amount; id++)
+                symbol_map[id] = intern(uT8_PCC &chunk_symbols->arena[chunk_symbols->names[id]], chunk_symbols->lengths[id]);
+        }
+
+        append_ast_segment(&chunks[i].segment, symbol_map);
+
+        free(symbol_map);
+        free_symbol_table(chunk_symbols);
+        free_ast_tree(&chunks[i].segment);
+    }
+
+    free(chunks);
+
+    set_lexer_region(l, 0, size);
+    if(!(ast_has_been_comitted())) commit_ast();
+}
+
+#endif
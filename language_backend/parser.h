@@ -2,28 +2,36 @@
 #define parser
 #include "dot_mem_parser/dot_mem_run.h"
 
-typedef struct variable_decl_info
+typedef struct parser
 {
-    enum DT_tokens datatype;
-    uT8 *variable_name;
+    _lexer      *lang_lexer;
 
-    union {
-        uT8 *string_value;
-        uT32 integer_value;
-        uT8 char_value;
-        uT8 *hex_value;
-    } variable_value;
-} _var_decl_info;
+    /* The compilation the parser is part of(the same one as `lang_lexer`). */
+    _compiler_context   *context;
 
-_var_decl_info *vdinfo = NULL;
+    /* Index of `token_data` in `token_stream`. */
+    uT32        token_index;
 
-typedef struct parser
-{
-    _lexer      *lang_lexer;
-    _lexer      *previous_lexer_state;
-    _token      previous_token;
+    /* Where the statement being parsed starts, and what `tree` had before it(see `skip_failed_statement`). */
+    uT32        statement_token;
+    uT32        statement_nodes;
+    uT32        statement_strings;
+
+    /* Parsing a file pulled in by `#include`(see `include.h`). */
+    bool        included;
 } _parser;
 
+/* Look `ahead` tokens past the current token without moving.
+ * Looking past the end of the stream returns the END token.
+ * */
+_token *peek_token(_parser *p, uT32 ahead)
+{
+    uT32 index = p->token_index + ahead;
+
+    if(index >= token_stream->amount) index = token_stream->amount - 1;
+    return &token_stream->entries[index];
+}
+
 #include "ast.h"
 
 _parser *init_parser(_lexer *lang_lexer)
@@ -32,35 +40,67 @@ _parser *init_parser(_lexer *lang_lexer)
         "No valid memory for lexer.\n\tTry rerunning the program.\n", 
         OOC_allocation_error)
 
-    _parser *language_parser = calloc(1, sizeof(*language_parser));
+    use_compiler_context(lang_lexer->context);
 
-    lang_assert(language_parser, 
-        "Error allocating memory for the parser.\n\tTry rerunning the program.\n", 
-        OOC_allocation_error)
+    _parser *language_parser = front_end_alloc(sizeof(*language_parser));
 
     language_parser->lang_lexer = lang_lexer;
-    language_parser->previous_lexer_state = NULL; // We don't have a previous state
-
-    make_new_token(DEF, uT8_PC "\0", 0);
+    language_parser->context = lang_lexer->context;
+    language_parser->token_index = 0;
 
-    vdinfo = calloc(1, sizeof(*vdinfo));
     return language_parser;
 }
 
 void parse_keyword(_parser *p);
-void parse_datatype(_parser *p);
 void parse_var_decl(_parser *p);
 void parse_macro(_parser *p);
+_token *parse_quoted_value(_parser *p);
+bool use_shared_dot_mem(struct dot_mem_store *store, uT8 *dot_mem_filename);
 
-void get_state(_parser *p, bool expect_string, uT8 opening_quote)
+/* Move on to the next token. The END token is never moved past. */
+void get_state(_parser *p)
 {
-    p->previous_lexer_state = p->lang_lexer;
-    p->lang_lexer = get_next_state(p->lang_lexer, expect_string, opening_quote);
+    if(token_data && token_data->type_of_token != END) p->token_index++;
+    token_data = &token_stream->entries[p->token_index];
 }
 
-void run_parser(_parser *lang_parser)
+/* After an error: take back whatever the failed statement added to `tree`, and move on to the first
+ * token on a later line than the statement started on(statements never span lines).
+ * A failed declaration that got as far as its name still declares it, with the type `Unknown`, so the
+ * uses of the variable are not each reported as not declared as well(see `resolve_variables`).
+ * */
+static void skip_failed_statement(_parser *p)
+{
+    tree.amount = p->statement_nodes;
+    tree.strings_size = p->statement_strings;
+
+    _token *statement = &token_stream->entries[p->statement_token];
+    _token *name = statement + 1;
+    nTL32 line = token_line(statement);
+
+    if(statement->type_of_token == VD && name->type_of_token == DT && token_line(name) == line &&
+       (name->token_id == DT_word || name->token_id == DT_char))
+        add_ast_node(variable_decl, name->symbol, add_ast_node(no_operand, Unknown, 0, name, name), statement, name);
+
+    while(get_TOT() != END && token_line(token_data) == line)
+        get_state(p);
+}
+
+/* Parse everything in `token_stream`.
+ * A statement with an error(see `diagnostics.h`) is left out, parsing carries on with the next line.
+ * */
+void parse_tokens(_parser *lang_parser)
 {
-    get_state(lang_parser, false, 0);
+    jmp_buf recovery;
+
+    use_compiler_context(lang_parser->context);
+
+    lang_parser->token_index = 0;
+    token_data = NULL;
+    get_state(lang_parser);
+
+    jmp_buf *outer = catch_errors(&recovery);
+    if(setjmp(recovery)) skip_failed_statement(lang_parser);
 
     /* Get new lexer state. */
     while(get_TOT() != END)
@@ -68,53 +108,100 @@ void run_parser(_parser *lang_parser)
         /* If the ast has been comitted then the program ended whilst parsing a section of the code. */
         if(ast_has_been_comitted())
         {
-            printf("Program Ended.");
-            exit(0);
+            trace(TC_parser, TL_info, "Program Ended.");
+            break;
         }
 
+        lang_parser->statement_token = lang_parser->token_index;
+        lang_parser->statement_nodes = tree.amount;
+        lang_parser->statement_strings = tree.strings_size;
+        diagnose_at(token_data->offset);
+
         switch(get_TOT())
         {
             case KW: parse_keyword(lang_parser);break;
-            case DT: parse_datatype(lang_parser);break;
+            case DT: break;    // a value on its own does nothing
             case VD: parse_var_decl(lang_parser);break;
             case GR: {
                 /* Check if it is a valid grammar value for the parser to parse. */
-                lang_assert(token_data->token_info.GR_token_info.grammar_token == G_hashtag, "Invalid grammar on line %ld.\n", invalid_grammar_error, lang_parser->lang_lexer->line)
+                lang_assert(get_GTT() == G_hashtag, "Invalid grammar on line %ld.\n", invalid_grammar_error, get_TL())
             
                 parse_macro(lang_parser);
                 break;
             }
-            default: printf("Unknown TOT: %d", get_TOT());break;
+            default: trace(TC_parser, TL_error, "Unknown TOT: %llu", get_TOT());break;
         }
 
-        if(!(token_data->type_of_token == END))
-            get_state(lang_parser, false, 0);
+        if(!(get_TOT() == END))
+            get_state(lang_parser);
     }
-    printf("Done");
+
+    stop_catching_errors(outer);
+    trace(TC_parser, TL_info, "Done, %llu tokens", token_stream->amount);
+}
+
+void run_parser(_parser *lang_parser)
+{
+    /* Lex everything up front, the parser only ever indexes `token_stream` from here on.
+     * When streaming, "everything" is the whole lines in the current window, and that is repeated
+     * window after window. Statements never span lines, so no statement is cut in half.
+     * */
+    use_compiler_context(lang_parser->context);
+
+    do {
+        tokenize(lang_parser->lang_lexer);
+        parse_tokens(lang_parser);
+    } while(lang_parser->lang_lexer->more_input && next_lexer_window(lang_parser->lang_lexer));
+
+    if(!(ast_has_been_comitted())) commit_ast();
 }
 
 void parse_macro(_parser *p)
 {
     /* The ast does not deal with macros. */
+    _token *hashtag = token_data;
 
-    get_state(p, false, 0);
+    get_state(p);
+    lang_assert(get_TOT() == KW && get_TL() == token_line(hashtag),
+        "Expected `include` or `incmem` after `#` on line %ld.\n",
+        invalid_grammar_error, token_line(hashtag))
 
     switch(get_KTT())
     {
         case KW_include: {
-            printf("Including other source file.\n");
+            /* The syntax is the same as `#incmem`: `#include "filename.sum"`, the path being relative
+             * to the file the `#include` is in. The file is parsed and linked in after the parser is done.
+             * */
+            get_state(p);
+            lang_assert(get_TOT() == GR && get_GTT() == G_double_quote && get_TL() == token_line(hashtag),
+                "Expected opening double quote for `include` on line %ld.\n",
+                expected_DQ_error, token_line(hashtag))
+
+            _token *path = parse_quoted_value(p);
+            lang_assert(path,
+                "Expected a file to include on line %ld.\n",
+                missing_parts_error, token_line(hashtag))
+
+            trace(TC_parser, TL_info, "Including other source file on line %llu.", token_line(hashtag));
+
+            add_ast_include(token_text(path), path->length, hashtag, token_data);
             break;
         }
         case KW_incmem: {
-            lang_assert(p->lang_lexer->line == 1, 
+            /* Included files are parsed under the `.mem` file of the program including them. */
+            lang_assert(!(p->included),
+                "`#incmem` can only be used in the file being compiled, not in a file it includes.\n",
+                incmem_in_included_file_error)
+
+            lang_assert(get_TL() == 1, 
                 "Expected `#incmem` on line 1. Found on line %ld.\n", 
-                incmem_not_on_line_1_error, p->lang_lexer->line)
+                incmem_not_on_line_1_error, get_TL())
 
-            get_state(p, false, 0);
+            get_state(p);
             lang_assert(get_GTT() == G_double_quote, 
                 "Expected opening double quote for `incmem`, got %s (%s) instead.\n",
                 expected_DQ_error, get_GTV(), get_GTTN())
-            get_state(p, true, '"');
+            get_state(p);
             
             /* We now have whatever value is inside the double quotes.
              * The syntax should be as follows in the .sum file:
@@ -122,160 +209,311 @@ void parse_macro(_parser *p)
              * */
             uT8 *dot_mem_filename = get_DTV();
             dot_mem_filename = uT8_PC initiate_path(dot_mem_file_location_folder, uT8_PC dot_mem_filename);
-            uT8 *dot_mem_file_data = NULL;
 
-            FILE *f = fopen(nT8_PC dot_mem_filename, "r");
-
-            lang_assert(f, 
-                "The file \"%s\" passed to `incmem` doesn't exist, or the path is wrong.\n",
-                file_not_exist_error, dot_mem_filename)
-
-
-            fseek(f, 0, SEEK_END);
-            size_t dot_mem_file_size = ftell(f);
-            dot_mem_file_data = calloc(dot_mem_file_size, sizeof(*dot_mem_file_data));
-            lang_assert(dot_mem_file_data,
-                "Error allocating memory for the `.mem` file.\n\tTry rerunning the program.\n",
-                OOC_allocation_error)
-            fseek(f, 0, SEEK_SET);
+            /* In a batch, every `.mem` file is parsed once for all of the programs using it. */
+            bool found;
+            if(p->context->dot_mem_store) found = use_shared_dot_mem(p->context->dot_mem_store, dot_mem_filename);
+            else
+            {
+                _source_buffer *dot_mem_file_data = init_source_buffer(nT8_PC dot_mem_filename);
 
-            fread(dot_mem_file_data, sizeof(uT8), dot_mem_file_size, f);
+                /* Parse the .mem file. */
+                if((found = dot_mem_file_data != NULL))
+                {
+                    run_dot_mem_parser(p->context, dot_mem_file_data, dot_mem_filename);
+                    destroy_source_buffer(dot_mem_file_data);
+                }
+            }
 
-            fclose(f);
+            if(!(found))
+            {
+                /* The error does not come back here, the path is freed before it. */
+                nT8 missing[strlen(nT8_PCC dot_mem_filename) + 1];
+                strcpy(missing, nT8_PCC dot_mem_filename);
+                free(dot_mem_filename);
 
-            /* Parse the .mem file. */
-            run_dot_mem_parser(dot_mem_file_data, dot_mem_filename);
+                lang_error("The file \"%s\" passed to `incmem` doesn't exist, or the path is wrong.\n",
+                    file_not_exist_error, missing)
+            }
 
+            add_dependency(nT8_PC dot_mem_filename);
             free(dot_mem_filename);
-            free(dot_mem_file_data);
-            get_state(p, false, 0);
-
-            
-            exit(0);
+            get_state(p);
             break;
         }
-        default: break;
+        default: {
+            lang_error("Expected `include` or `incmem` after `#` on line %ld.\n",
+                invalid_grammar_error, token_line(hashtag))
+        }
+    }
+}
+
+/* Move past the value between a pair of quotations, starting on the opening quotation.
+ * Leaves the parser on the closing quotation. Returns the string token, or NULL for an empty string(`''`).
+ * */
+_token *parse_quoted_value(_parser *p)
+{
+    enum grammar_tokens opening_quote = get_GTT();
+    _token *value = NULL;
+
+    get_state(p);    // get the string(or the closing quotation, if the string is empty)
+    if(get_TOT() == DT)
+    {
+        value = token_data;
+        get_state(p);
     }
-    exit(0);
+
+    lang_assert(get_TOT() == GR && get_GTT() == opening_quote,
+        "Unexpected end to string on line %ld.\n",
+        missing_quote_error, get_TL())
+
+    return value;
+}
+
+/* Add a string operand for the quoted value starting on the opening quotation. */
+uT32 parse_string_operand(_parser *p)
+{
+    _token *opening = token_data;
+    _token *value = parse_quoted_value(p);
+
+    if(!(value)) return add_ast_string(uT8_PCC "", 0, opening, token_data);
+    return add_ast_string(token_text(value), value->length, opening, token_data);
 }
 
 void parse_keyword(_parser *p)
 {
+    _token *statement = token_data;
+
     switch(get_KTT())
     {
         case KW_print: {
-            get_state(p, false, 0);    // we have `print`, this will get `'`
-            
+            uT32 operand = no_node;
+
+            get_state(p);    // we have `print`, this will get `'` or the value to print
+            lang_assert(get_TOT() != END && get_TL() == token_line(statement),
+                "Expected string or integer/decimal/hexadecimal value on line %ld.\n",
+                missing_parts_error, token_line(statement))
+
             switch(get_TOT())
             {
                 case GR: {
                     /* With `print`, getting a grammar token means we are printing a string. */
-                    lang_assert(get_GTT() == G_single_quote, 
+                    lang_assert(get_GTT() == G_single_quote || get_GTT() == G_double_quote,
                         "Expected string or integer/decimal/hexadecimal value on line %ld.\n",
-                        invalid_grammar_error, p->lang_lexer->line)
+                        invalid_grammar_error, get_TL())
 
-                    printf("Printing String");
+                    operand = parse_string_operand(p);
+                    break;
                 }
                 case DT: {
-                    /* If the DTT (Data Token Type) is `DT_word`, then the `print` statement is recieving a variable name
-                     * to print.
+                    /* If the DTT (Data Token Type) is `DT_word`(or `DT_char`, a one letter name), then the `print`
+                     * statement is recieving a variable name to print.
                      * */
-                    if(get_DTT() == DT_word) goto printing_variable;
-
-                    printf("Printing Data Type: %s\nValue: %s\n", get_DTTN(), get_DTV());
+                    switch(get_DTT())
+                    {
+                        case DT_integer: operand = add_ast_number(integer_operand, token_data->number.integer, token_data);break;
+                        case DT_hex: operand = add_ast_number(hex_operand, token_data->number.integer, token_data);break;
+                        case DT_float: operand = add_ast_number(float_operand, token_data->number.integer, token_data);break;
+                        default: operand = add_ast_node(variable_operand, token_data->symbol, 0, token_data, token_data);break;
+                    }
                     break;
                 }
-                case VD: {
-                    printing_variable:
-                    printf("Printing Variable");
-                    break;
+                default: {
+                    lang_error("Expected string or integer/decimal/hexadecimal value on line %ld.\n",
+                        invalid_grammar_error, get_TL())
                 }
-                default: break;
             }
-            exit(0);
-            
-            //get_state(p, true);     // get the string to print
 
-            //new_tree_entry(print_statement);
-            
-            /* Make sure there is an ending `'`. */
-            //lang_assert(p->lang_lexer->val == '\'', "Expected `'` at end of `print` statement on line %ld.\n", missing_quote_error, p->lang_lexer->line)
-
-            //get_state(p, false);    // get the ending `'`
+            trace(TC_parser, TL_debug, "Printing operand of kind %llu, statement at offset %llu", tree.kind[operand], statement->offset);
 
+            add_ast_node(print_statement, operand, 0, statement, token_data);
             break;
         }
         case KW_exit: {
-            printf("Exiting");
+            uT32 exit_code = 0;
+
+            /* `exit` can be given a status on the same line. */
+            if(peek_token(p, 1)->type_of_token == DT && token_line(peek_token(p, 1)) == get_TL())
+            {
+                get_state(p);
+                lang_assert(get_DTT() == DT_integer,
+                    "Expected integer exit status on line %ld.\n",
+                    unexpect_value_error, get_TL())
+
+                lang_assert(token_data->number.integer <= 0xFF,
+                    "Exit status %llu on line %ld is too large, it must be between 0 and 255.\n",
+                    unexpect_value_error, token_data->number.integer, get_TL())
+
+                exit_code = token_data->number.integer;
+            }
+
+            trace(TC_parser, TL_debug, "Exiting with %llu", exit_code);
+
+            add_ast_node(exit_statement, exit_code, 0, statement, token_data);
             break;
         }
         default: break;
     }
 }
 
-void parse_datatype(_parser *p)
-{
-}
-
 void parse_var_decl(_parser *p)
 {
-    vdinfo->datatype = token_data->token_info.DT_token_info.data_type_token;
+    _token *statement = token_data;
+    enum DT_tokens declared_type = get_DTT();
 
-    get_state(p, false, 0);
-    lang_assert(token_data->type_of_token != END, 
-        "Unexpected EOF.\n", 
+    get_state(p);
+    /* END with more input to come is only the end of a window(or chunk), the name is missing either way. */
+    lang_assert(get_TOT() != END || p->lang_lexer->more_input,
+        "Unexpected EOF.\n",
         unexpected_EOF)
+    lang_assert(get_TOT() == DT && (get_DTT() == DT_word || get_DTT() == DT_char) && get_TL() == token_line(statement),
+        "Expected a variable name on line %ld.\n",
+        no_variable_name_error, token_line(statement))
+
+    uT32 variable_symbol = token_data->symbol;
+
+    _token *name = token_data;
+    enum var_decl_DT datatype;
+    switch(declared_type)
+    {
+        case DT_integer: datatype = Int;break;
+        case DT_string: datatype = Str;break;
+        case DT_hex: datatype = Hex;break;
+        case DT_char: datatype = Char;break;
+        default: {
+            lang_error("A variable cannot be declared as `%.*s` on line %ld.\n",
+                parser_invalid_syntax, (nT32) statement->length, token_text(statement), token_line(statement))
+        }
+    }
+
+    /* Nothing else on the line means the variable is not initialized. */
+    if(peek_token(p, 1)->type_of_token == END || token_line(peek_token(p, 1)) != get_TL())
+    {
+        add_ast_node(variable_decl, variable_symbol, add_ast_node(no_operand, datatype, 0, name, name), statement, name);
+
+        /* If we are at the EOF, `check_is_EOF` will automatically commit the AST. */
+        if(check_is_EOF(p)) return;
 
-    vdinfo->variable_name = token_data->token_info.DT_token_info.data_type_value;
+        /* Check if the programs memory specification requires variables to be initialized. */
+        if(program_memory_info->require_initialized_variables)
+            lang_error("Variable `%s` is not initialized on line %ld.\n", missing_equals_error, symbol_name(variable_symbol), get_TL())
+
+        return;
+    }
 
-    get_state(p, false, 0);
-    
-    if(token_data->type_of_token == GR)
+    get_state(p);
+
+    if(get_TOT() == GR)
     {
-        if(token_data->token_info.GR_token_info.grammar_token == G_equals)
+        if(get_GTT() == G_equals)
         {
-            switch(vdinfo->datatype)
+            uT32 value = no_node;
+
+            get_state(p);
+            lang_assert(get_TOT() != END && get_TL() == token_line(statement),
+                "Expected a value for `%s` on line %ld.\n",
+                missing_parts_error, symbol_name(variable_symbol), token_line(statement))
+
+            bool quoted = get_TOT() == GR && (get_GTT() == G_single_quote || get_GTT() == G_double_quote);
+
+            switch(declared_type)
             {
                 case DT_string: {
-                    printf("here");
-                    get_state(p, false, 0);
-                    lang_assert(token_data->token_info.GR_token_info.grammar_value == '\'', "Expected string on line %ld.\n", missing_quote_error, p->lang_lexer->line)
-                    
-                    get_state(p, true, token_data->token_info.GR_token_info.grammar_token == G_single_quote ? '\'' : '"');
-                    printf("%s", token_data->token_info.DT_token_info.data_type_value);
-                    get_state(p, false, 0);
-                    lang_assert(token_data->token_info.GR_token_info.grammar_value == '\'', "Unexpected end to string on line %ld.\n", missing_quote_error, p->lang_lexer->line)
-                    exit(0);
+                    lang_assert(quoted, "Expected string on line %ld.\n", missing_quote_error, get_TL())
+
+                    value = parse_string_operand(p);
+                    break;
                 }
                 case DT_integer: {
-                    printf("Integer");
-                    exit(0);
+                    /* Integers can also be given in quotes(e.g. `int age = '15'`). */
+                    if(quoted)
+                    {
+                        _token *opening = token_data;
+                        _token *quoted_value = parse_quoted_value(p);
+                        const uT8 *digits = quoted_value ? token_text(quoted_value) : NULL;
+                        uT32 length = quoted_value ? quoted_value->length : 0;
+                        uSIZE integer = 0;
+                        bool overflow = false;
+
+                        lang_assert(length > 0,
+                            "Expected integer value for `%s` on line %ld.\n",
+                            grammar_mismatch_error, symbol_name(variable_symbol), get_TL())
+
+                        for(uT32 i = 0; i < length; i++)
+                        {
+                            lang_assert(is_number(digits[i]),
+                                "Expected integer value for `%s` on line %ld.\n",
+                                grammar_mismatch_error, symbol_name(variable_symbol), get_TL())
+
+                            overflow |= __builtin_mul_overflow(integer, 10, &integer) ||
+                                        __builtin_add_overflow(integer, digits[i] - '0', &integer);
+                        }
+
+                        lang_assert(!(overflow),
+                            "The value of `%s` on line %ld is too large.\n",
+                            lexing_too_large_number_error, symbol_name(variable_symbol), get_TL())
+
+                        value = add_ast_node(integer_operand, (uT32) integer, (uT32) (integer >> 32), opening, token_data);
+                        break;
+                    }
+
+                    lang_assert(get_TOT() == DT && get_DTT() == DT_integer,
+                        "Expected integer value for `%s` on line %ld.\n",
+                        grammar_mismatch_error, symbol_name(variable_symbol), get_TL())
+
+                    value = add_ast_number(integer_operand, token_data->number.integer, token_data);
+                    break;
+                }
+                case DT_hex: {
+                    lang_assert(get_TOT() == DT && get_DTT() == DT_hex,
+                        "Expected hexadecimal value for `%s` on line %ld.\n",
+                        grammar_mismatch_error, symbol_name(variable_symbol), get_TL())
+
+                    value = add_ast_number(hex_operand, token_data->number.integer, token_data);
+                    break;
+                }
+                case DT_char: {
+                    _token *opening = token_data;
+
+                    lang_assert(quoted, "Expected character on line %ld.\n", missing_quote_error, get_TL())
+
+                    _token *quoted_value = parse_quoted_value(p);
+                    lang_assert(quoted_value && quoted_value->length == 1,
+                        "Expected one character for `%s` on line %ld.\n",
+                        grammar_mismatch_error, symbol_name(variable_symbol), get_TL())
+
+                    value = add_ast_character(token_text(quoted_value)[0], opening, token_data);
+                    break;
+                }
+                default: {
+                    lang_error("A variable cannot be declared as `%.*s` on line %ld.\n",
+                        parser_invalid_syntax, (nT32) statement->length, token_text(statement), token_line(statement))
                 }
-                default: break;
             }
-        } else {
-            if(program_memory_info->require_initialized_variables) { lang_error("Unexpected value without `=` on line %ld.\n", missing_equals_error, p->lang_lexer->line) }
-        }
-    } else {
-        if(lexer_peek_and_return(p->lang_lexer) == '\n') { move_forward(p->lang_lexer); return; }
 
-        /* If we are at the EOF, `check_is_EOF` will automatically commit the AST. */
-        if(check_is_EOF(p)) return;
+            trace(TC_parser, TL_debug, "Variable of type %llu initialized, statement at offset %llu", declared_type, statement->offset);
+
+            add_ast_node(variable_decl, variable_symbol, value, statement, token_data);
+            return;
+        }
 
+        /* A value without `=`. */
+        if(program_memory_info->require_initialized_variables) { lang_error("Unexpected value without `=` on line %ld.\n", missing_equals_error, get_TL()) }
+    } else {
         /* Check if the programs memory specification requires variables to be initialized. */
         if(program_memory_info->require_initialized_variables)
-            lang_assert(token_data->type_of_token != DT, "Unexpected value without `=` on line %ld.\n", unexpect_value_error, p->lang_lexer->line)
+            lang_assert(get_TOT() != DT, "Unexpected value without `=` on line %ld.\n", unexpect_value_error, get_TL())
     }
+
+    add_ast_node(variable_decl, variable_symbol, add_ast_node(no_operand, datatype, 0, name, name), statement, name);
 }
 
 void destroy_parser(_parser *lang_parser)
 {
     if(!(lang_parser)) return;
 
-    if(lang_parser->lang_lexer) { free(lang_parser->lang_lexer); lang_parser->lang_lexer = NULL; }
-    if(lang_parser->previous_lexer_state) { free(lang_parser->previous_lexer_state); lang_parser->previous_lexer_state = NULL; }
-
-    free(lang_parser);
+    /* The lexer is owned by whoever created it(see `destroy_lexer`), the parser itself goes with `front_end_arena`. */
+    lang_parser->lang_lexer = NULL;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,251 @@
+#ifndef scanning
+#define scanning
+#include <pthread.h>
+
+/* Kernels that move through runs of source code many bytes at a time.
+ * Each one takes the range [`p`, `end`) and returns where the run stops(`end` at most).
+ *
+ * `skip_blank` - skip spaces, tabs, carriage returns and newlines
+ * `scan_word` - find the end of a word(`a-z`, `A-Z` and, if `allow_underscore`, `_`)
+ * `scan_string` - find the first `'`, `"` or newline(the end of a string body)
+ * `count_newlines` - count the newlines in [`p`, `end`)
+ *
+ * `init_scan_kernels` picks AVX2, SSE2 or plain C versions depending on what the CPU supports.
+ * */
+typedef struct scan_kernel_set
+{
+    const uT8   *(*skip_blank)(const uT8 *p, const uT8 *end);
+    const uT8   *(*scan_word)(const uT8 *p, const uT8 *end, bool allow_underscore);
+    const uT8   *(*scan_string)(const uT8 *p, const uT8 *end);
+    uSIZE       (*count_newlines)(const uT8 *p, const uT8 *end);
+
+    /* Name of the instruction set in use, for diagnostics. */
+    const nT8   *name;
+} _scan_kernel_set;
+
+static _scan_kernel_set scan_kernels = { NULL, NULL, NULL, NULL, NULL };
+
+#define is_blank(c)         (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+#define is_word_char(c, u)  ((((c) | 0x20) >= 'a' && ((c) | 0x20) <= 'z') || ((u) && (c) == '_'))
+#define is_string_end(c)    (c == '\'' || c == '"' || c == '\n')
+
+/* Plain C versions. Also used for whatever is left over after the vector loops. */
+static const uT8 *skip_blank_scalar(const uT8 *p, const uT8 *end)
+{
+    while(p < end && is_blank(*p)) p++;
+    return p;
+}
+
+static const uT8 *scan_word_scalar(const uT8 *p, const uT8 *end, bool allow_underscore)
+{
+    while(p < end && is_word_char(*p, allow_underscore)) p++;
+    return p;
+}
+
+static const uT8 *scan_string_scalar(const uT8 *p, const uT8 *end)
+{
+    while(p < end && !(is_string_end(*p))) p++;
+    return p;
+}
+
+static uSIZE count_newlines_scalar(const uT8 *p, const uT8 *end)
+{
+    uSIZE newlines = 0;
+
+    for(; p < end; p++)
+        if(*p == '\n') newlines++;
+
+    return newlines;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+/* A byte is a letter when `(c | 0x20) - 'a'` is below 26. SSE2/AVX2 only compare signed bytes,
+ * so the range is shifted down by 128 first: letters then land on [-128, -103].
+ * */
+#define letter_bias         (128 - 'a')
+#define letter_limit        (-128 + 26)
+
+__attribute__((target("sse2")))
+static const uT8 *skip_blank_sse2(const uT8 *p, const uT8 *end)
+{
+    const __m128i space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r'), nl = _mm_set1_epi8('\n');
+
+    while(p + 16 <= end)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+        __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, nl)));
+
+        uT32 not_blank = ~_mm_movemask_epi8(blank) & 0xFFFF;
+        if(not_blank) return p + __builtin_ctz(not_blank);
+
+        p += 16;
+    }
+
+    return skip_blank_scalar(p, end);
+}
+
+__attribute__((target("sse2")))
+static const uT8 *scan_word_sse2(const uT8 *p, const uT8 *end, bool allow_underscore)
+{
+    const __m128i lower = _mm_set1_epi8(0x20), bias = _mm_set1_epi8(letter_bias);
+    const __m128i limit = _mm_set1_epi8(letter_limit), underscore = _mm_set1_epi8('_');
+
+    while(p + 16 <= end)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+        __m128i shifted = _mm_add_epi8(_mm_or_si128(chunk, lower), bias);
+        __m128i word = _mm_cmplt_epi8(shifted, limit);
+
+        if(allow_underscore) word = _mm_or_si128(word, _mm_cmpeq_epi8(chunk, underscore));
+
+        uT32 not_word = ~_mm_movemask_epi8(word) & 0xFFFF;
+        if(not_word) return p + __builtin_ctz(not_word);
+
+        p += 16;
+    }
+
+    return scan_word_scalar(p, end, allow_underscore);
+}
+
+__attribute__((target("sse2")))
+static const uT8 *scan_string_sse2(const uT8 *p, const uT8 *end)
+{
+    const __m128i sq = _mm_set1_epi8('\''), dq = _mm_set1_epi8('"'), nl = _mm_set1_epi8('\n');
+
+    while(p + 16 <= end)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) p);
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, sq), _mm_cmpeq_epi8(chunk, dq)),
+                                   _mm_cmpeq_epi8(chunk, nl));
+
+        uT32 mask = _mm_movemask_epi8(hit);
+        if(mask) return p + __builtin_ctz(mask);
+
+        p += 16;
+    }
+
+    return scan_string_scalar(p, end);
+}
+
+__attribute__((target("sse2")))
+static uSIZE count_newlines_sse2(const uT8 *p, const uT8 *end)
+{
+    const __m128i nl = _mm_set1_epi8('\n');
+    uSIZE newlines = 0;
+
+    while(p + 16 <= end)
+    {
+        newlines += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) p), nl)));
+        p += 16;
+    }
+
+    return newlines + count_newlines_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const uT8 *skip_blank_avx2(const uT8 *p, const uT8 *end)
+{
+    const __m256i space = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r'), nl = _mm256_set1_epi8('\n');
+
+    while(p + 32 <= end)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) p);
+        __m256i blank = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+                                        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr), _mm256_cmpeq_epi8(chunk, nl)));
+
+        uT32 not_blank = ~(uT32) _mm256_movemask_epi8(blank);
+        if(not_blank) return p + __builtin_ctz(not_blank);
+
+        p += 32;
+    }
+
+    return skip_blank_sse2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const uT8 *scan_word_avx2(const uT8 *p, const uT8 *end, bool allow_underscore)
+{
+    const __m256i lower = _mm256_set1_epi8(0x20), bias = _mm256_set1_epi8(letter_bias);
+    const __m256i limit = _mm256_set1_epi8(letter_limit), underscore = _mm256_set1_epi8('_');
+
+    while(p + 32 <= end)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) p);
+        __m256i shifted = _mm256_add_epi8(_mm256_or_si256(chunk, lower), bias);
+        __m256i word = _mm256_cmpgt_epi8(limit, shifted);
+
+        if(allow_underscore) word = _mm256_or_si256(word, _mm256_cmpeq_epi8(chunk, underscore));
+
+        uT32 not_word = ~(uT32) _mm256_movemask_epi8(word);
+        if(not_word) return p + __builtin_ctz(not_word);
+
+        p += 32;
+    }
+
+    return scan_word_sse2(p, end, allow_underscore);
+}
+
+__attribute__((target("avx2")))
+static const uT8 *scan_string_avx2(const uT8 *p, const uT8 *end)
+{
+    const __m256i sq = _mm256_set1_epi8('\''), dq = _mm256_set1_epi8('"'), nl = _mm256_set1_epi8('\n');
+
+    while(p + 32 <= end)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) p);
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, sq), _mm256_cmpeq_epi8(chunk, dq)),
+                                      _mm256_cmpeq_epi8(chunk, nl));
+
+        uT32 mask = _mm256_movemask_epi8(hit);
+        if(mask) return p + __builtin_ctz(mask);
+
+        p += 32;
+    }
+
+    return scan_string_sse2(p, end);
+}
+
+__attribute__((target("avx2")))
+static uSIZE count_newlines_avx2(const uT8 *p, const uT8 *end)
+{
+    const __m256i nl = _mm256_set1_epi8('\n');
+    uSIZE newlines = 0;
+
+    while(p + 32 <= end)
+    {
+        newlines += __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) p), nl)));
+        p += 32;
+    }
+
+    return newlines + count_newlines_sse2(p, end);
+}
+#endif
+
+static void pick_scan_kernels()
+{
+    scan_kernels = (_scan_kernel_set) { skip_blank_scalar, scan_word_scalar, scan_string_scalar, count_newlines_scalar, "scalar" };
+
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2"))
+        scan_kernels = (_scan_kernel_set) { skip_blank_avx2, scan_word_avx2, scan_string_avx2, count_newlines_avx2, "avx2" };
+    else if(__builtin_cpu_supports("sse2"))
+        scan_kernels = (_scan_kernel_set) { skip_blank_sse2, scan_word_sse2, scan_string_sse2, count_newlines_sse2, "sse2" };
+    #endif
+}
+
+/* Pick the kernels once per process, however many lexers(on however many threads) ask. */
+static pthread_once_t scan_kernels_picked = PTHREAD_ONCE_INIT;
+
+void init_scan_kernels()
+{
+    pthread_once(&scan_kernels_picked, pick_scan_kernels);
+}
+
+#endif
@@ -0,0 +1,255 @@
+#ifndef source_buffer
+#define source_buffer
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* How much to read at a time when the source cannot be mapped (pipes, FIFOs, etc). */
+#define source_read_chunk_size      0x10000
+
+/* Sources at least this big are streamed through a window instead of being loaded whole. */
+#define source_stream_threshold     0x40000000
+
+/* Starting size of the streaming window. It only grows if a single line does not fit. */
+#define source_window_size          0x100000
+
+/* Source code shared by the `.sum` lexer and the `.mem` lexer.
+ * The lexers only ever borrow `data`, they never copy it.
+ * */
+typedef struct source_buffer
+{
+    /* The source code. There is always a readable `\0` at `data[size]`. */
+    uT8         *data;
+
+    /* Size of the source code in bytes(excluding the `\0`). */
+    uSIZE       size;
+
+    /* Was `data` obtained via `mmap`? If not, it is heap memory. */
+    bool        mapped;
+
+    /* Size of the mapping, only used when `mapped` is true. */
+    uSIZE       mapped_size;
+
+    /* Streaming only(see `init_source_stream`).
+     * `data` is a window over the file, `base` is the file offset of `data[0]`.
+     * `size` only covers whole lines, `filled` is how much of the window was read in.
+     * */
+    bool        streaming;
+    nT32        fd;
+    uSIZE       base;
+    uSIZE       filled;
+    uSIZE       capacity;
+    bool        end_of_input;
+} _source_buffer;
+
+/* Read everything from `fd` into a heap buffer.
+ * Used when `fd` is not a regular file, or when a mapping would not leave room for the `\0`.
+ * */
+static bool read_source_fd(nT32 fd, _source_buffer *buffer)
+{
+    uSIZE capacity = source_read_chunk_size;
+    buffer->data = malloc(capacity + 1);
+    buffer->size = 0;
+
+    if(!(buffer->data)) return false;
+
+    while(true)
+    {
+        if(buffer->size == capacity)
+        {
+            capacity *= 2;
+            uT8 *grown = realloc(buffer->data, capacity + 1);
+            if(!(grown)) { free(buffer->data); buffer->data = NULL; return false; }
+
+            buffer->data = grown;
+        }
+
+        ssize_t amount_read = read(fd, &buffer->data[buffer->size], capacity - buffer->size);
+        if(amount_read == 0) break;
+        if(amount_read < 0) { free(buffer->data); buffer->data = NULL; return false; }
+
+        buffer->size += amount_read;
+    }
+
+    buffer->data[buffer->size] = '\0';
+    buffer->mapped = false;
+    return true;
+}
+
+/* Open `filename` and obtain its source code.
+ * Regular files get mapped read-only. Anything else(a pipe, for example) is read in.
+ * Returns NULL if the file does not exist.
+ * */
+_source_buffer *init_source_buffer(nT8 *filename)
+{
+    nT32 fd = open(filename, O_RDONLY);
+    if(fd < 0) return NULL;
+
+    _source_buffer *buffer = calloc(1, sizeof(*buffer));
+    lang_assert(buffer,
+        "Error allocating memory for the source of `%s`.\n\tTry rerunning the program.\n",
+        OOC_allocation_error, filename)
+
+    struct stat file_info;
+    lang_assert(fstat(fd, &file_info) == 0,
+        "Error obtaining information about `%s`.\n",
+        OOC_source_code_read_error, filename)
+
+    /* If the file size is a multiple of the page size there would be no zero-filled
+     * tail after the last byte, so the `\0` the lexers rely on would not exist.
+     * Those files(and empty ones) take the `read` path instead.
+     * */
+    uSIZE page_size = sysconf(_SC_PAGESIZE);
+    if(S_ISREG(file_info.st_mode) && file_info.st_size > 0 && (file_info.st_size % page_size) != 0)
+    {
+        void *mapping = mmap(NULL, file_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(mapping != MAP_FAILED)
+        {
+            madvise(mapping, file_info.st_size, MADV_SEQUENTIAL);
+
+            buffer->data = uT8_PC mapping;
+            buffer->size = file_info.st_size;
+            buffer->mapped = true;
+            buffer->mapped_size = file_info.st_size;
+
+            close(fd);
+            return buffer;
+        }
+    }
+
+    lang_assert(read_source_fd(fd, buffer),
+        "Error reading in all of the source code for `%s`.\n",
+        OOC_source_code_read_error, filename)
+
+    close(fd);
+    return buffer;
+}
+
+/* Should `filename` be streamed rather than loaded whole?
+ * True for very large files, and for pipes and the like(their size cannot be known up front).
+ * */
+bool source_should_stream(nT8 *filename)
+{
+    struct stat file_info;
+
+    if(stat(filename, &file_info) != 0) return false;
+    if(!(S_ISREG(file_info.st_mode))) return true;
+
+    return (uSIZE) file_info.st_size >= source_stream_threshold;
+}
+
+/* Open `filename` for streaming. No source code is read until `next_source_window`.
+ * Returns NULL if the file does not exist.
+ * */
+_source_buffer *init_source_stream(nT8 *filename, uSIZE window_size)
+{
+    nT32 fd = open(filename, O_RDONLY);
+    if(fd < 0) return NULL;
+
+    _source_buffer *buffer = calloc(1, sizeof(*buffer));
+    lang_assert(buffer,
+        "Error allocating memory for the source of `%s`.\n\tTry rerunning the program.\n",
+        OOC_allocation_error, filename)
+
+    /* One extra byte so the last window can always be `\0` terminated. */
+    buffer->data = malloc(window_size + 1);
+    lang_assert(buffer->data,
+        "Error allocating memory for the source of `%s`.\n\tTry rerunning the program.\n",
+        OOC_allocation_error, filename)
+
+    buffer->streaming = true;
+    buffer->fd = fd;
+    buffer->capacity = window_size;
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return buffer;
+}
+
+/* Slide the window forward to the next run of whole lines.
+ * The part of the last line that did not fit is carried over to the front of the window,
+ * so no token is ever cut in half. Returns false once everything has been handed out.
+ * */
+bool next_source_window(_source_buffer *buffer)
+{
+    uSIZE leftover = buffer->filled - buffer->size;
+
+    memmove(buffer->data, &buffer->data[buffer->size], leftover);
+    buffer->base += buffer->size;
+    buffer->filled = leftover;
+    buffer->size = 0;
+
+    while(true)
+    {
+        while(!(buffer->end_of_input) && buffer->filled < buffer->capacity)
+        {
+            ssize_t amount_read = read(buffer->fd, &buffer->data[buffer->filled], buffer->capacity - buffer->filled);
+            lang_assert(amount_read >= 0,
+                "Error reading in the source code at offset %llu.\n",
+                OOC_source_code_read_error, buffer->base + buffer->filled)
+
+            if(amount_read == 0) buffer->end_of_input = true;
+            buffer->filled += amount_read;
+        }
+
+        if(buffer->end_of_input)
+        {
+            buffer->size = buffer->filled;
+            break;
+        }
+
+        /* Lines are short, so looking backwards for the last newline is cheap. */
+        uSIZE last_newline = buffer->filled;
+        while(last_newline > 0 && buffer->data[last_newline - 1] != '\n') last_newline--;
+
+        if(last_newline > 0)
+        {
+            buffer->size = last_newline;
+            break;
+        }
+
+        /* A single line is bigger than the window, the window has to grow to fit it. */
+        buffer->capacity *= 2;
+        buffer->data = realloc(buffer->data, buffer->capacity + 1);
+        lang_assert(buffer->data,
+            "Error allocating memory for a line of %llu+ bytes at offset %llu.\n",
+            OOC_allocation_error, buffer->filled, buffer->base)
+    }
+
+    buffer->data[buffer->filled] = '\0';
+    return buffer->size > 0;
+}
+
+/* Swap a mapping for a heap copy of the source code, so that it can be edited in place. */
+void make_source_buffer_editable(_source_buffer *buffer)
+{
+    if(!(buffer->mapped)) return;
+
+    uT8 *copy = malloc(buffer->size + 1);
+    lang_assert(copy,
+        "Error allocating memory for a copy of the source code(%llu bytes).\n",
+        OOC_allocation_error, buffer->size)
+
+    memcpy(copy, buffer->data, buffer->size);
+    copy[buffer->size] = '\0';
+
+    munmap(buffer->data, buffer->mapped_size);
+    buffer->data = copy;
+    buffer->mapped = false;
+}
+
+void destroy_source_buffer(_source_buffer *buffer)
+{
+    if(!(buffer)) return;
+
+    if(buffer->streaming) close(buffer->fd);
+
+    if(buffer->mapped) munmap(buffer->data, buffer->mapped_size);
+    else free(buffer->data);
+    buffer->data = NULL;
+
+    free(buffer);
+}
+
+#endif
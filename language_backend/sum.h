@@ -3,24 +3,168 @@
 
 #define dot_mem_file_location_folder    uT8_PC "dot_mem/"
 
+#include "trace.h"
 #include "lexer.h"
 #include "../mem_outline_lang/mem_outline.h"
 #include "parser.h"
+#include "variables.h"
+#include "constants.h"
+#include "bytecode.h"
+#include "vm.h"
+#include "jit.h"
+#include "executable.h"
+#include "c_source.h"
+#include "cache.h"
+#include "include.h"
+#include "incremental.h"
+#include "parallel.h"
+#include "batch.h"
 
-void run(nT8 *filename)
+_compiler_context *new_compiler_context()
 {
-    _lexer *lex = init_lexer(filename);
-    _parser *pars = init_parser(lex);
+    _compiler_context *context = calloc(1, sizeof(*context));
+    lang_assert(context,
+        "Error allocating memory for the compiler context.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    context->syntax_tree = calloc(1, sizeof(*context->syntax_tree));
+    context->variables = calloc(1, sizeof(*context->variables));
+    lang_assert(context->syntax_tree && context->variables,
+        "Error allocating memory for the compiler context.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
 
+    use_compiler_context(context);
+    init_ast();
     init_program_memory_info();
-    new_tree_entry(ast_tree_init);
 
-    run_parser(pars);
+    return context;
+}
+
+void destroy_compiler_context(_compiler_context *context)
+{
+    if(!(context)) return;
+
+    _compiler_context *previous = active_context;
+    use_compiler_context(context);
+
+    free_diagnostics(&context->diagnostics);
+    destroy_token_stream();
+    destroy_tree();
+    destroy_variable_table();
+    destroy_constant_pool();
+    destroy_bytecode();
+    destroy_symbol_table();
+    release_cached_program();
+    if(context->memory_info_borrowed) context->memory_info = NULL;
+    destroy_program_memory_info();
+    destroy_front_end_arena();
+
+    for(uT32 i = 0; i < context->dependency_amount; i++) free(context->dependencies[i]);
+    free(context->dependencies);
+
+    free(context->syntax_tree);
+    free(context->variables);
+    free(context);
+
+    use_compiler_context(previous == context ? NULL : previous);
+}
+
+/* Compile `filename` in a compilation of its own, and return it with its errors still to be reported.
+ * `streaming` - see `init_lexer`. Very large files, and pipes, are always streamed.
+ * `jobs` - lex and parse on up to this many threads(see `run_parser_parallel`), and parse the included
+ * files on as many(see `link_includes`). Streamed sources are always lexed and parsed on one.
+ * `cache_directory` - look the program up in, and store it to, the compilation cache there(see `cache.h`).
+ * NULL leaves the cache alone.
+ * `dot_mem_store` - share `.mem` files with the other compilations of a batch(see `batch.h`), or NULL.
+ * */
+_compiler_context *compile(nT8 *filename, bool streaming, uT32 jobs, const nT8 *cache_directory, struct dot_mem_store *dot_mem_store)
+{
+    jmp_buf recovery;
+
+    _compiler_context *context = new_compiler_context();
+    context->dot_mem_store = dot_mem_store;
+
+    /* A file that cannot be compiled at all is an error of its compilation like any other. */
+    jmp_buf *outer = catch_errors(&recovery);
+    if(setjmp(recovery))
+    {
+        stop_catching_errors(outer);
+        return context;
+    }
+
+    lang_assert(check_file(filename), "The file `%s` has the wrong extension.\n\tThe extension should be `.sum`.\n", wrong_extension_error, filename)
+
+    _lexer *lex = init_lexer(context, filename, streaming || source_should_stream(filename));
+    stop_catching_errors(outer);
+
+    _parser *pars = init_parser(lex);
+    bool cached = cache_directory && load_cached_program(lex->source, cache_directory, false);
+
+    /* A cached program is already parsed, the lexer is only left to provide the line index. */
+    if(!(cached))
+    {
+        if(jobs > 1 && !(lex->source->streaming)) run_parser_parallel(pars, jobs);
+        else run_parser(pars);
+
+        link_includes(filename, lex, jobs, cache_directory);
+    }
+
+    resolve_variables(&lex->lines);
+    build_constant_pool();
+
+    /* Only a program without errors gets bytecode. */
+    if(!(context->diagnostics.amount))
+    {
+        compile_bytecode();
+        optimize_bytecode();
+    }
+
+    if(cache_directory && !(cached) && !(context->diagnostics.amount)) store_cached_program(lex->source, cache_directory, false);
 
     destroy_lexer(lex);
     destroy_parser(pars);
-    destroy_token_reference(token_data->type_of_token);
-    destroy_tree();
+
+    return context;
+}
+
+/* Compile `filename`(see `compile`) and report every error of the program, at once. A program without
+ * errors is then run: interpreted(see `run_bytecode`), or compiled to machine code first if `jit`(see `compile_jit`).
+ * Returns the status the program should exit with: that of the first error, or the one the program exited with.
+ * */
+nT32 run(nT8 *filename, bool streaming, uT32 jobs, const nT8 *cache_directory, bool jit)
+{
+    _compiler_context *context = compile(filename, streaming, jobs, cache_directory, NULL);
+    nT32 status = report_diagnostics(&context->diagnostics);
+
+    if(context->bytecode)
+    {
+        use_compiler_context(context);
+        status = jit ? run_jit(context->bytecode, program_constants.rodata) : run_bytecode(context->bytecode, program_constants.rodata, stdout);
+    }
+
+    destroy_compiler_context(context);
+    return status;
+}
+
+/* Compile `filename`(see `compile`) and report every error of the program, at once. A program without
+ * errors is then written to `output` rather than run: as an executable(see `write_executable`), or as C
+ * if `c_source`(see `write_c_source`).
+ * Returns the status of the first error, 0 if there was none.
+ * */
+nT32 build(nT8 *filename, bool streaming, uT32 jobs, const nT8 *cache_directory, const nT8 *output, bool c_source)
+{
+    _compiler_context *context = compile(filename, streaming, jobs, cache_directory, NULL);
+    nT32 status = report_diagnostics(&context->diagnostics);
+
+    if(context->bytecode)
+    {
+        use_compiler_context(context);
+        if(c_source) write_c_source(filename, program_memory_info, output);
+        else write_executable(context->bytecode, active_context->constants, program_memory_info, output);
+    }
+
+    destroy_compiler_context(context);
+    return status;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+#ifndef symbols
+#define symbols
+
+/* Every identifier is interned once, and is referred to by its symbol ID from then on.
+ * Two identifiers are the same identifier exactly when their IDs are equal.
+ *
+ * The names themselves live back to back(each `\0` terminated) in one arena, so interning an
+ * identifier that was already seen allocates nothing.
+ * */
+typedef struct symbol_table
+{
+    /* The names. Addressed by offset, so the arena can grow without invalidating anything. */
+    nT8         *arena;
+    uSIZE       arena_size;
+    uSIZE       arena_capacity;
+
+    /* `names[id]` is the offset of the name of symbol `id` in `arena`. */
+    uSIZE       *names;
+    uT32        *lengths;
+    uT32        amount;
+    uT32        capacity;
+
+    /* Open addressing hash table of `id + 1`(0 is an empty slot). Always a power of two in size. */
+    uT32        *slots;
+    uT32        slot_mask;
+
+    /* The arrays point into a cache file(see `cache.h`), they are not freed. */
+    bool        mapped;
+} _symbol_table;
+
+/* The symbols of the compilation that is running(see `context.h`). */
+#define symbol_table        (active_context->symbol_names)
+
+/* FNV-1a. */
+static inline uT32 symbol_hash(const uT8 *name, uSIZE length)
+{
+    uT32 h = 0x811C9DC5;
+
+    for(uSIZE i = 0; i < length; i++)
+        h = (h ^ name[i]) * 0x01000193;
+
+    return h;
+}
+
+void init_symbol_table()
+{
+    symbol_table = calloc(1, sizeof(*symbol_table));
+    lang_assert(symbol_table,
+        "Error allocating memory for the symbol table.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    symbol_table->arena_capacity = 0x1000;
+    symbol_table->capacity = 0x100;
+    symbol_table->slot_mask = 0x200 - 1;
+
+    symbol_table->arena = malloc(symbol_table->arena_capacity);
+    symbol_table->names = malloc(symbol_table->capacity * sizeof(*symbol_table->names));
+    symbol_table->lengths = malloc(symbol_table->capacity * sizeof(*symbol_table->lengths));
+    symbol_table->slots = calloc(symbol_table->slot_mask + 1, sizeof(*symbol_table->slots));
+    lang_assert(symbol_table->arena && symbol_table->names && symbol_table->lengths && symbol_table->slots,
+        "Error allocating memory for the symbol table.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+}
+
+/* Double the hash table, keeping it at most half full. */
+static void grow_symbol_slots()
+{
+    uT32 slot_mask = (symbol_table->slot_mask << 1) | 1;
+    uT32 *slots = calloc(slot_mask + 1, sizeof(*slots));
+    lang_assert(slots,
+        "Error allocating memory for the symbol table.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    for(uT32 id = 0; id < symbol_table->amount; id++)
+    {
+        uT32 slot = symbol_hash(uT8_PCC &symbol_table->arena[symbol_table->names[id]], symbol_table->lengths[id]) & slot_mask;
+
+        while(slots[slot]) slot = (slot + 1) & slot_mask;
+        slots[slot] = id + 1;
+    }
+
+    free(symbol_table->slots);
+    symbol_table->slots = slots;
+    symbol_table->slot_mask = slot_mask;
+}
+
+/* A table loaded from the cache moves to the heap before a name is added to it. */
+static void unmap_symbol_table()
+{
+    symbol_table->arena_capacity = symbol_table->arena_size + 0x1000;
+    symbol_table->capacity = symbol_table->amount + 0x100;
+
+    symbol_table->arena = heap_copy(symbol_table->arena, symbol_table->arena_size, symbol_table->arena_capacity);
+    symbol_table->names = heap_copy(symbol_table->names, symbol_table->amount * sizeof(*symbol_table->names), symbol_table->capacity * sizeof(*symbol_table->names));
+    symbol_table->lengths = heap_copy(symbol_table->lengths, symbol_table->amount * sizeof(*symbol_table->lengths), symbol_table->capacity * sizeof(*symbol_table->lengths));
+    symbol_table->slots = heap_copy(symbol_table->slots, (symbol_table->slot_mask + 1) * sizeof(*symbol_table->slots), (symbol_table->slot_mask + 1) * sizeof(*symbol_table->slots));
+
+    symbol_table->mapped = false;
+}
+
+/* Get the symbol ID of `name`(`length` bytes, does not need to be `\0` terminated).
+ * The first time a name is seen it is copied into the arena and given the next ID.
+ * */
+uT32 intern(const uT8 *name, uSIZE length)
+{
+    if(!(symbol_table)) init_symbol_table();
+
+    uT32 slot = symbol_hash(name, length) & symbol_table->slot_mask;
+
+    for(; symbol_table->slots[slot]; slot = (slot + 1) & symbol_table->slot_mask)
+    {
+        uT32 id = symbol_table->slots[slot] - 1;
+
+        if(symbol_table->lengths[id] == length && memcmp(&symbol_table->arena[symbol_table->names[id]], name, length) == 0)
+            return id;
+    }
+
+    /* A new name. */
+    if(symbol_table->mapped) unmap_symbol_table();
+
+    if(symbol_table->arena_size + length + 1 > symbol_table->arena_capacity)
+    {
+        while(symbol_table->arena_size + length + 1 > symbol_table->arena_capacity) symbol_table->arena_capacity *= 2;
+
+        symbol_table->arena = realloc(symbol_table->arena, symbol_table->arena_capacity);
+        lang_assert(symbol_table->arena,
+            "Error allocating memory for the symbol table.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    if(symbol_table->amount == symbol_table->capacity)
+    {
+        symbol_table->capacity *= 2;
+        symbol_table->names = realloc(symbol_table->names, symbol_table->capacity * sizeof(*symbol_table->names));
+        symbol_table->lengths = realloc(symbol_table->lengths, symbol_table->capacity * sizeof(*symbol_table->lengths));
+        lang_assert(symbol_table->names && symbol_table->lengths,
+            "Error allocating memory for the symbol table.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    uT32 id = symbol_table->amount;
+    symbol_table->amount++;
+
+    symbol_table->names[id] = symbol_table->arena_size;
+    symbol_table->lengths[id] = length;
+    memcpy(&symbol_table->arena[symbol_table->arena_size], name, length);
+    symbol_table->arena[symbol_table->arena_size + length] = '\0';
+    symbol_table->arena_size += length + 1;
+
+    symbol_table->slots[slot] = id + 1;
+    if(symbol_table->amount * 2 > symbol_table->slot_mask) grow_symbol_slots();
+
+    return id;
+}
+
+/* Name of symbol `id`, `\0` terminated. Only valid until the next `intern`(the arena might move). */
+const nT8 *symbol_name(uT32 id)
+{
+    return &symbol_table->arena[symbol_table->names[id]];
+}
+
+void free_symbol_table(_symbol_table *table)
+{
+    if(!(table)) return;
+
+    if(table->mapped)
+    {
+        free(table);
+        return;
+    }
+
+    free(table->arena);
+    free(table->names);
+    free(table->lengths);
+    free(table->slots);
+    free(table);
+}
+
+void destroy_symbol_table()
+{
+    free_symbol_table(symbol_table);
+    symbol_table = NULL;
+}
+
+#endif
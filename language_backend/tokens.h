@@ -52,32 +52,69 @@ enum token_type
     NONE // Used for `token_name`
 };
 
+#include "dot_mem_parser/dot_mem_token_list.h"
+#include "keywords/keywords.h"
+#include "symbols.h"
+
+/* Value of a number token, decoded by the lexer(see `obtain_number`).
+ * `integer` for `DT_integer` and `DT_hex`, `decimal` for `DT_float`.
+ * */
+typedef union token_number
+{
+    uSIZE       integer;
+    double      decimal;
+} _token_number;
+
+/* A single token.
+ * Tokens do not own their value. The value is `length` bytes at `offset` in the source code.
+ * */
 typedef struct token
 {
-    enum token_type     type_of_token;
-
-    /* Token information. */
-    union {
-        struct {
-            uT8     *keyword_value;
-            enum keyword_tokens keyword_token;
-        } KW_token_info;
-
-        struct {
-            uT8     *data_type_value;
-            enum DT_tokens data_type_token;
-        } DT_token_info;
-
-        struct {
-            uT8     grammar_value;
-            enum grammar_tokens grammar_token;
-        } GR_token_info;
-    } token_info;
+    /* Where the value of the token is in the source code(an offset into the whole file). */
+    uSIZE       offset;
+    uT32        length;
+
+    /* Symbol ID of a name(`DT_word` and `DT_char` tokens), see `intern`. */
+    uT32        symbol;
+
+    /* Only set for number tokens. */
+    _token_number number;
+
+    /* `enum token_type`. */
+    uT8         type_of_token;
+
+    /* `enum keyword_tokens`, `enum DT_tokens` or `enum grammar_tokens`, depending on `type_of_token`. */
+    uT8         token_id;
 } _token;
 
-_token *token_data = NULL;
+/* Every token of a source file, in order.
+ * The lexer fills it in once(see `tokenize`), the parser then indexes it.
+ * */
+typedef struct token_stream
+{
+    _token      *entries;
+    uT32        amount;
+    uT32        capacity;
+
+    /* The source code the tokens refer to(borrowed from the lexer).
+     * `source[0]` is at `source_base` in the file, which is only ever non-zero when streaming.
+     * */
+    uT8         *source;
+    uSIZE       source_base;
+
+    /* Where the lines of `source` start(borrowed from the lexer, see `token_line`). */
+    _line_index *lines;
+
+    /* Scratch memory for `get_DTV`/`get_KTV`, so that a value can be handed out `\0` terminated. */
+    uT8         *value_buffer;
+    uT32        value_buffer_size;
+} _token_stream;
+
+/* The tokens of the compilation that is running(see `context.h`). */
+#define token_stream        (active_context->token_list)
 
-void clear_out_token(enum token_type);
+/* The token the parser is currently looking at(points into `token_stream`). */
+#define token_data          (active_context->current_token)
 
 /* Decipher the GTT.
  * GTT - Grammar Token Type
@@ -104,11 +141,9 @@ enum grammar_tokens decipher_GTT(uT8 val)
  * */
 enum keyword_tokens decipher_KTT(uT8 *val)
 {
-    if(strcmp(nT8_PCC val, "print") == 0) return KW_print;
-    if(strcmp(nT8_PCC val, "include") == 0) return KW_include;
-    if(strcmp(nT8_PCC val, "incmem") == 0) return KW_incmem;
-    if(strcmp(nT8_PCC val, "exit") == 0) return KW_exit;
+    const _keyword *k = lookup_keyword(val, strlen(nT8_PCC val));
 
+    if(k && k->sum_type == KW) return k->sum_token;
     return KW_unknown;
 }
 
@@ -117,12 +152,9 @@ enum keyword_tokens decipher_KTT(uT8 *val)
  * */
 enum DT_tokens decipher_DTT(uT8 *val)
 {
-    if(strcmp(nT8_PCC val, "int") == 0) return DT_integer;
-    if(strcmp(nT8_PCC val, "string") == 0) return DT_string;
-    if(strcmp(nT8_PCC val, "float") == 0) return DT_float;
-    if(strcmp(nT8_PCC val, "hex") == 0) return DT_hex;
-    if(strcmp(nT8_PCC val, "char") == 0) return DT_char;
+    const _keyword *k = lookup_keyword(val, strlen(nT8_PCC val));
 
+    if(k && k->sum_type == VD) return k->sum_token;
     return DT_word;
 }
 
@@ -184,12 +216,26 @@ enum token_type get_TOT()
     return token_data->type_of_token;
 }
 
+/* What line is `t` on? Tokens only store their offset, the line comes from the line index. */
+nTL32 token_line(_token *t)
+{
+    return line_of_offset(token_stream->lines, t->offset);
+}
+
+/* Get the TL.
+ * TL - Token Line
+ * */
+nTL32 get_TL()
+{
+    return token_line(token_data);
+}
+
 /* Get the KTT.
  * KTT - Keyword Token Type
  * */
 enum keyword_tokens get_KTT()
 {
-    return token_data->token_info.KW_token_info.keyword_token;
+    return token_data->token_id;
 }
 
 /* Get the DTT.
@@ -197,7 +243,7 @@ enum keyword_tokens get_KTT()
  * */
 enum DT_tokens get_DTT()
 {
-    return token_data->token_info.DT_token_info.data_type_token;
+    return token_data->token_id;
 }
 
 /* Get the GTT.
@@ -205,9 +251,8 @@ enum DT_tokens get_DTT()
  * */
 enum grammar_tokens get_GTT()
 {
-    return token_data->token_info.GR_token_info.grammar_token;
+    return token_data->token_id;
 }
-
 /* Get the TOTN.
  * TOTN - Type Of Token Name
  * */
@@ -279,15 +324,37 @@ uT8 *get_GTTN()
     return uT8_PC "Unknown GTT (Grammar Token Type)";
 }
 
+/* Copy the value of `t` into the scratch memory of `token_stream`.
+ * The returned value is only valid until the next call.
+ * */
+uT8 *get_token_value(_token *t)
+{
+    if(t->length + 1 > token_stream->value_buffer_size)
+    {
+        token_stream->value_buffer_size = t->length + 1;
+        token_stream->value_buffer = realloc(token_stream->value_buffer, token_stream->value_buffer_size);
+        lang_assert(token_stream->value_buffer,
+            "Error allocating memory for token value.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    memcpy(token_stream->value_buffer, &token_stream->source[t->offset - token_stream->source_base], t->length);
+    token_stream->value_buffer[t->length] = '\0';
+    return token_stream->value_buffer;
+}
+
+/* The value of `t`, in the source code(not `\0` terminated, it is `t->length` bytes long). */
+const uT8 *token_text(_token *t)
+{
+    return &token_stream->source[t->offset - token_stream->source_base];
+}
+
 /* Get the DTV.
  * DTV - Data Token Value
  * */
 uT8 *get_DTV()
 {
-    if(token_data->token_info.DT_token_info.data_type_value)
-        return uT8_PC token_data->token_info.DT_token_info.data_type_value;
-    
-    return uT8_PC "\0";
+    return get_token_value(token_data);
 }
 
 /* Get the KTV.
@@ -295,7 +362,7 @@ uT8 *get_DTV()
  * */
 uT8 *get_KTV()
 {
-    return uT8_PC token_data->token_info.KW_token_info.keyword_value;
+    return get_token_value(token_data);
 }
 
 /* Get the GTV.
@@ -303,135 +370,101 @@ uT8 *get_KTV()
  * */
 uT8 *get_GTV()
 {
-    return uT8_PC make_uT8_ptr(token_data->token_info.GR_token_info.grammar_value);
+    return uT8_PC make_uT8_ptr(token_stream->source[token_data->offset - token_stream->source_base]);
+}
+
+void init_token_stream(_lexer *l)
+{
+    token_stream = calloc(1, sizeof(*token_stream));
+    lang_assert(token_stream,
+        "Error allocating memory for the token stream.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    /* Rough guess of how many tokens there will be, the stream grows if needed. */
+    token_stream->capacity = l->source_code_size / 4 + 16;
+    token_stream->entries = calloc(token_stream->capacity, sizeof(*token_stream->entries));
+    lang_assert(token_stream->entries,
+        "Error allocating memory for the token stream.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    token_stream->source = l->file_source_code;
+    token_stream->source_base = l->source_code_base;
+    token_stream->lines = &l->lines;
+}
+
+/* Empty `token_stream` so it can be refilled from the current window of `l`(streaming only). */
+void reset_token_stream(_lexer *l)
+{
+    token_stream->amount = 0;
+    token_stream->source = l->file_source_code;
+    token_stream->source_base = l->source_code_base;
+    token_stream->lines = &l->lines;
 }
 
-/* Create new data for a token.
+/* Append a new token to `token_stream`, and return it.
+ * `offset` is relative to `l->file_source_code`, the token stores it relative to the file.
  * TT - Token Type
  * */
-void make_new_token(enum token_type TT, uT8 *value, uT32 token_value)
+_token *make_new_token(_lexer *l, enum token_type TT, uT32 token_value, uSIZE offset, uSIZE length)
 {
-    /* Make sure we have valid memory. */
-    if(!(token_data))
+    if(token_stream->amount == token_stream->capacity)
     {
-        token_data = calloc(1, sizeof(*token_data));
-        lang_assert(token_data,
-            "Error allocating memory for token data.\n\tTry rerunning the program.\n",
+        token_stream->capacity *= 2;
+        token_stream->entries = realloc(
+            token_stream->entries,
+            token_stream->capacity * sizeof(*token_stream->entries)
+        );
+        lang_assert(token_stream->entries,
+            "Error allocating memory for tokens.\n",
             OOC_allocation_error)
     }
-    else clear_out_token(token_data->type_of_token);
 
-    /* Make sure the allocation occurred. */
-    lang_assert(token_data, "Error allocating memory for tokens.\n", OOC_allocation_error)
+    _token *t = &token_stream->entries[token_stream->amount];
+    token_stream->amount++;
 
-    token_data->type_of_token = TT;
+    t->type_of_token = TT;
+    t->token_id = token_value;
+    t->offset = l->source_code_base + offset;
+    t->length = length;
+
+    if(TT == DT && (token_value == DT_word || token_value == DT_char))
+        t->symbol = intern(&l->file_source_code[offset], length);
 
     /* What type of token is it? */
     switch(TT)
     {
-        case KW: {
-            token_data->token_info.KW_token_info.keyword_token = token_value;
-
-            token_data->token_info.KW_token_info.keyword_value = calloc(strlen(nT8_PCC value), sizeof(uT8));
-            lang_assert(token_data->token_info.KW_token_info.keyword_value, 
-                "Error allocating memory for token value.\n\tToken Type(TT): %d\n\tToken Value: %s\n", 
-                OOC_allocation_error, TT, value)
-
-            /* Copy over from `value` to `keyword_value`. */
-            memcpy(token_data->token_info.KW_token_info.keyword_value, value, strlen(nT8_PCC value));
-            memset(&token_data->token_info.KW_token_info.keyword_value[strlen(nT8_PCC value)], '\0', 1);
-            
-            printf("Created new KW(Keyword) token:\n\tKeyword Token: %d (%s)\n\tKeyword Value: %s\n", token_value, token_name(token_value, NULL, NONE), value);
-            break;
-        }
-        case GR: {
-            token_data->token_info.GR_token_info.grammar_token = token_value;
-            token_data->token_info.GR_token_info.grammar_value = value[0];
-            printf("Created new GR(Grammar) token:\n\tGrammar Token: %d (%s)\n\tGrammar Value: %c\n", token_value, token_name(token_value, NULL, NONE), value[0]);
-            break;
-        }
-        case VD: {
-            token_data->token_info.DT_token_info.data_type_token = token_value;
-            printf("Created new VD(Variable Declaration) token:\n\tData Type Token: %d (%s)\n\n", token_value, token_name(token_value, NULL, NONE));
-            break;
-        }
-        case DT: {
-            token_data->token_info.DT_token_info.data_type_token = token_value;
-
-            token_data->token_info.DT_token_info.data_type_value = calloc(strlen(nT8_PCC value), sizeof(uT8));
-            lang_assert(token_data->token_info.DT_token_info.data_type_value, 
-                "Error allocating memory for token value.\n\tToken Type(TT): %d\n\tToken Value: %s\n", 
-                OOC_allocation_error, TT, value)
-
-            /* Copy over from `value` to `data_type_value`. */
-            memcpy(token_data->token_info.DT_token_info.data_type_value, value, strlen(nT8_PCC value));
-            memset(&token_data->token_info.DT_token_info.data_type_value[strlen(nT8_PCC value)], '\0', 1);
-            
-            printf("Created new DT(Datatype) token:\n\tDatatype Token: %d (%s)\n\tDatatype Value: %s\n", token_value, token_name(token_value, NULL, NONE), value);
-            break;
-        }
-        case DEF: break;
-        case END: break;
+        case KW: trace(TC_lexer, TL_debug, "Created new KW(Keyword) token %llu at offset %llu, length %llu", token_value, t->offset, length);break;
+        case GR: trace(TC_lexer, TL_debug, "Created new GR(Grammar) token %llu at offset %llu", token_value, t->offset);break;
+        case VD: trace(TC_lexer, TL_debug, "Created new VD(Variable Declaration) token %llu at offset %llu", token_value, t->offset);break;
+        case DT: trace(TC_lexer, TL_debug, "Created new DT(Datatype) token %llu at offset %llu, length %llu", token_value, t->offset, length);break;
+        case END: trace(TC_lexer, TL_debug, "Created new END token at offset %llu", t->offset);break;
         default: break;
     }
 
-    /* "Free" the memory from `value`. */
-    value = NULL;
+    return t;
 }
 
-void make_new_token_alone(uT8 *value, _lexer *l)
+/* Create a token for a word, which is either a keyword or a variable name. */
+void make_new_token_alone(_lexer *l, uSIZE offset, uSIZE length)
 {
-    if(strcmp(nT8_PCC value, "print") == 0) { make_new_token(KW, uT8_PC value, KW_print); return; }
-    if(strcmp(nT8_PCC value, "exit") == 0) { make_new_token(KW, uT8_PC value, KW_exit); return; }
-    if(strcmp(nT8_PCC value, "int") == 0) { make_new_token(VD, uT8_PC value, DT_integer); return; }
-    if(strcmp(nT8_PCC value, "str") == 0) { make_new_token(VD, uT8_PC value, DT_string); return; }
-    if(strcmp(nT8_PCC value, "hex") == 0) { make_new_token(VD, uT8_PC value, DT_hex); return; }
-    if(strcmp(nT8_PCC value, "include") == 0) { make_new_token(KW, uT8_PC value, KW_include); return; }
-    if(strcmp(nT8_PCC value, "incmem") == 0) { make_new_token(KW, uT8_PC value, KW_incmem); return; }
-
-    make_new_token(DT, uT8_PC value, DT_word);
-    //lang_error("Unknown keyword `%s` on line %ld.\n", not_a_keyword_error, value, l->line)
-}
+    const _keyword *k = lookup_keyword(&l->file_source_code[offset], length);
 
-/* Free any allocation made on the previous token.
- * LT - Last Token
- * */
-void clear_out_token(enum token_type LT)
-{
-    switch(LT)
-    {
-        case KW: {
-            printf("\t\tReleased:\n\t\t\tToken: %d\n\t\t\tValue: %s\n\n", token_data->token_info.KW_token_info.keyword_token, token_data->token_info.KW_token_info.keyword_value);
-            free(token_data->token_info.KW_token_info.keyword_value);
-            token_data->token_info.KW_token_info.keyword_value = NULL;
-            break;
-        }
-        case GR: {
-            printf("\t\tReleased:\n\t\t\tToken: %d\n\t\t\tValue: %c\n\n", token_data->token_info.GR_token_info.grammar_token, token_data->token_info.GR_token_info.grammar_value);
-            token_data->token_info.GR_token_info.grammar_value = '\0';
-            break;
-        }
-        case DT: {
-            printf("\t\tReleased:\n\t\t\tToken: %d\n\t\t\tValue: %s\n\n", token_data->token_info.DT_token_info.data_type_token, token_data->token_info.DT_token_info.data_type_value);
-            free(token_data->token_info.DT_token_info.data_type_value);
-            token_data->token_info.DT_token_info.data_type_value = NULL;
-            break;
-        }
-        case DEF: break;
-        case END: break;
-        default: break;
-    }
+    if(k && k->sum_type != NONE) { make_new_token(l, k->sum_type, k->sum_token, offset, length); return; }
+
+    make_new_token(l, DT, DT_word, offset, length);
+    //lang_error("Unknown keyword `%s` on line %ld.\n", not_a_keyword_error, value, lexer_line(l))
 }
 
-/* Destroy the `token_data` variable.
- * LT - Last Token
- * */
-void destroy_token_reference(enum token_type LT)
+/* Destroy `token_stream`. */
+void destroy_token_stream()
 {
-    /* Make sure all data is cleared. */
-    clear_out_token(LT);
+    if(!(token_stream)) return;
+
+    free(token_stream->entries);
+    free(token_stream->value_buffer);
+    free(token_stream);
 
-    free(token_data);
+    token_stream = NULL;
     token_data = NULL;
 }
 
@@ -0,0 +1,150 @@
+#ifndef tracing
+#define tracing
+
+/* Trace categories. `SUM_TRACE` selects which ones are recorded(e.g. `SUM_TRACE=lexer,parser`). */
+enum trace_categories
+{
+    TC_lexer    = 0x01,
+    TC_parser   = 0x02,
+    TC_dot_mem  = 0x04,
+    TC_ast      = 0x08,
+    TC_all      = 0x0F
+};
+
+/* Trace levels. `SUM_TRACE_LEVEL` selects the most detailed level that is recorded. */
+enum trace_levels
+{
+    TL_error    = 0x00,
+    TL_info,
+    TL_debug
+};
+
+/* Tracing only exists when built with `make run TRACE=1`(which defines `sum_trace`).
+ * Otherwise `trace` expands to `((void)0)`, so it costs nothing. Either way it is one statement, so it can be
+ * used as the body of an `if` with an `else`.
+ *
+ * Records are kept in binary form in a ring buffer, and are only formatted when dumped(on exit,
+ * or on demand with `trace_dump`). Because of that, a record can only hold numbers: `format` must
+ * be a string literal and may only use `%llu`/`%llx` conversions, at most `trace_max_args` of them.
+ * */
+#ifdef sum_trace
+#include <pthread.h>
+#include <time.h>
+
+#define trace_max_args      3
+#define trace_ring_size     0x4000   // must be a power of two
+
+typedef struct trace_record
+{
+    uSIZE           timestamp;
+    const nT8       *format;
+    uSIZE           args[trace_max_args];
+    uT8             category;
+    uT8             level;
+} _trace_record;
+
+static _trace_record trace_ring[trace_ring_size];
+
+/* How many records were ever pushed. Only the last `trace_ring_size` are still in `trace_ring`. */
+static uSIZE trace_head = 0;
+
+/* Filled in by `init_tracing` from the environment, once, by whichever thread traces first. */
+static uT8 trace_categories_wanted = 0;
+static uT8 trace_level_wanted = TL_info;
+static pthread_once_t trace_initialized = PTHREAD_ONCE_INIT;
+
+void trace_dump(FILE *out);
+
+static void trace_dump_on_exit()
+{
+    trace_dump(stderr);
+}
+
+static void init_tracing()
+{
+    const nT8 *categories = getenv("SUM_TRACE");
+    const nT8 *level = getenv("SUM_TRACE_LEVEL");
+
+    if(categories)
+    {
+        if(strstr(categories, "all")) trace_categories_wanted = TC_all;
+        if(strstr(categories, "lexer")) trace_categories_wanted |= TC_lexer;
+        if(strstr(categories, "parser")) trace_categories_wanted |= TC_parser;
+        if(strstr(categories, "mem")) trace_categories_wanted |= TC_dot_mem;
+        if(strstr(categories, "ast")) trace_categories_wanted |= TC_ast;
+    }
+
+    if(level)
+    {
+        if(strcmp(level, "error") == 0) trace_level_wanted = TL_error;
+        if(strcmp(level, "info") == 0) trace_level_wanted = TL_info;
+        if(strcmp(level, "debug") == 0) trace_level_wanted = TL_debug;
+    }
+
+    if(trace_categories_wanted) atexit(trace_dump_on_exit);
+}
+
+static inline bool trace_wants(uT8 category, uT8 level)
+{
+    pthread_once(&trace_initialized, init_tracing);
+    return (trace_categories_wanted & category) && level <= trace_level_wanted;
+}
+
+void trace_push(uT8 category, uT8 level, const nT8 *format, const uSIZE *args)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    /* Threads of the parallel front end share the ring. */
+    _trace_record *record = &trace_ring[__atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED) & (trace_ring_size - 1)];
+
+    record->timestamp = (uSIZE) now.tv_sec * 1000000000ULL + now.tv_nsec;
+    record->format = format;
+    record->category = category;
+    record->level = level;
+    memcpy(record->args, args, sizeof(record->args));
+}
+
+/* The `0` in front keeps the array valid when there are no arguments, it is skipped in `trace_push`. */
+#define trace(category, level, format, ...)                                             \
+do {                                                                                    \
+    if(trace_wants(category, level))                                                    \
+        trace_push(category, level, format, &((uSIZE [trace_max_args + 1]) { 0, ##__VA_ARGS__ })[1]); \
+} while(0)
+
+/* Format and print every record still in the ring buffer, oldest first. */
+void trace_dump(FILE *out)
+{
+    uSIZE first = trace_head > trace_ring_size ? trace_head - trace_ring_size : 0;
+    uSIZE start_time = trace_ring[first & (trace_ring_size - 1)].timestamp;
+
+    if(first > 0) fprintf(out, "[trace] %llu older records were overwritten.\n", first);
+
+    for(uSIZE i = first; i < trace_head; i++)
+    {
+        _trace_record *record = &trace_ring[i & (trace_ring_size - 1)];
+        const nT8 *category = "ast";
+
+        switch(record->category)
+        {
+            case TC_lexer: category = "lexer";break;
+            case TC_parser: category = "parser";break;
+            case TC_dot_mem: category = "mem";break;
+            default: break;
+        }
+
+        fprintf(out, "[trace] %10.6f %-6s %-5s ",
+            (record->timestamp - start_time) / 1e9, category,
+            record->level == TL_error ? "error" : record->level == TL_info ? "info" : "debug");
+        fprintf(out, record->format, record->args[0], record->args[1], record->args[2]);
+        fprintf(out, "\n");
+    }
+
+    fflush(out);
+}
+#else
+#define trace(category, level, format, ...)   ((void)0)
+#define trace_dump(out)                         ((void)0)
+#endif
+
+#endif
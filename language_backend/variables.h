@@ -0,0 +1,200 @@
+#ifndef variable_resolution
+#define variable_resolution
+
+/* Variable that has no slot. */
+#define no_slot     0xFFFFFFFF
+
+/* The variables of the program.
+ * Every declared variable gets a dense slot number(0, 1, 2 ... in order of first declaration) and its type,
+ * so later stages(and the runtime) refer to a variable by its slot, not by its name.
+ *
+ * Names are already hashed once, by `intern`(see `symbols.h`), so finding the slot of a name is
+ * indexing `slot_of_symbol` with its symbol ID.
+ * */
+typedef struct variable_table
+{
+    /* `slot_of_symbol[id]` is the slot of symbol `id`, or `no_slot` if it is not a variable. */
+    uT32            *slot_of_symbol;
+    uT32            symbol_capacity;
+
+    /* Indexed by slot. */
+    uT32            *symbol_of_slot;
+    enum DT_tokens  *types;
+    uT32            *declarations;      // the `variable_decl` node that first declared it
+    uT32            *typed_by;          // the one its type comes from: that one, unless it did not parse(see `Unknown`)
+
+    uT32            amount;
+    uT32            capacity;
+} _variable_table;
+
+/* The variables of the compilation that is running(see `context.h`). */
+#define program_variables   (*active_context->variables)
+
+/* The type a variable declaration gives its variable. */
+enum DT_tokens variable_decl_type(uT32 node)
+{
+    switch(variable_decl_datatype(node))
+    {
+        case Str: return DT_string;
+        case Hex: return DT_hex;
+        case Char: return DT_char;
+        default: return DT_integer;
+    }
+}
+
+/* Slot of symbol `symbol`, or `no_slot` if no variable has that name. */
+uT32 variable_slot(uT32 symbol)
+{
+    if(symbol >= program_variables.symbol_capacity) return no_slot;
+    return program_variables.slot_of_symbol[symbol];
+}
+
+/* Make sure `slot_of_symbol` covers every symbol in `symbol_table`. */
+static void reserve_symbol_slots()
+{
+    uT32 amount = symbol_table ? symbol_table->amount : 0;
+    if(amount <= program_variables.symbol_capacity) return;
+
+    program_variables.slot_of_symbol = realloc(program_variables.slot_of_symbol, amount * sizeof(*program_variables.slot_of_symbol));
+    lang_assert(program_variables.slot_of_symbol,
+        "Error allocating memory for the variable table.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    memset(&program_variables.slot_of_symbol[program_variables.symbol_capacity], 0xFF,
+        (amount - program_variables.symbol_capacity) * sizeof(*program_variables.slot_of_symbol));
+    program_variables.symbol_capacity = amount;
+}
+
+/* Give symbol `symbol` the next slot. */
+static uT32 declare_variable(uT32 symbol, enum DT_tokens type, uT32 node)
+{
+    if(program_variables.amount == program_variables.capacity)
+    {
+        program_variables.capacity = program_variables.capacity ? program_variables.capacity * 2 : 0x40;
+        program_variables.symbol_of_slot = realloc(program_variables.symbol_of_slot, program_variables.capacity * sizeof(*program_variables.symbol_of_slot));
+        program_variables.types = realloc(program_variables.types, program_variables.capacity * sizeof(*program_variables.types));
+        program_variables.declarations = realloc(program_variables.declarations, program_variables.capacity * sizeof(*program_variables.declarations));
+        program_variables.typed_by = realloc(program_variables.typed_by, program_variables.capacity * sizeof(*program_variables.typed_by));
+        lang_assert(program_variables.symbol_of_slot && program_variables.types && program_variables.declarations && program_variables.typed_by,
+            "Error allocating memory for the variable table.\n\tTry rerunning the program.\n",
+            OOC_allocation_error)
+    }
+
+    uT32 slot = program_variables.amount++;
+    program_variables.symbol_of_slot[slot] = symbol;
+    program_variables.types[slot] = type;
+    program_variables.declarations[slot] = node;
+    program_variables.typed_by[slot] = node;
+    program_variables.slot_of_symbol[symbol] = slot;
+
+    trace(TC_ast, TL_debug, "Symbol %llu is slot %llu", symbol, slot);
+    return slot;
+}
+
+/* Resolve the nodes of `tree` from `first` on again(see `resolve_variables`), keeping what the nodes
+ * before it declared. For when those nodes did not change(see `apply_edit`).
+ * */
+void resolve_variables_from(_line_index *lines, uT32 first)
+{
+    jmp_buf recovery;
+    volatile uT32 node = first;
+
+    reserve_symbol_slots();
+
+    /* Slots are given in the order of the nodes, the ones of the nodes from `first` on are the last ones. */
+    while(program_variables.amount && program_variables.declarations[program_variables.amount - 1] >= first)
+    {
+        program_variables.amount--;
+        program_variables.slot_of_symbol[program_variables.symbol_of_slot[program_variables.amount]] = no_slot;
+    }
+
+    for(uT32 slot = 0; slot < program_variables.amount; slot++)
+        if(program_variables.typed_by[slot] >= first)
+        {
+            program_variables.typed_by[slot] = program_variables.declarations[slot];
+            program_variables.types[slot] = variable_decl_type(program_variables.declarations[slot]);
+        }
+
+    /* Errors are found at their nodes, so the ones of the nodes from `first` on are found again. */
+    uSIZE errors_from = first ? (uSIZE) -1 : 0;
+    for(uT32 i = first; i < tree.amount; i++)
+        if(tree.span_start[i] < errors_from) errors_from = tree.span_start[i];
+
+    forget_diagnostics(&active_context->diagnostics, errors_from, (uSIZE) -1, 0, undeclared_variable_error);
+    forget_diagnostics(&active_context->diagnostics, errors_from, (uSIZE) -1, 0, variable_redeclared_error);
+
+    jmp_buf *outer = catch_errors(&recovery);
+    if(setjmp(recovery)) node++;
+
+    for(; node < tree.amount; node++)
+        switch(tree.kind[node])
+        {
+            case variable_decl: {
+                uT32 slot = variable_slot(tree.a[node]);
+                enum DT_tokens type = variable_decl_type(node);
+
+                if(slot == no_slot)
+                {
+                    declare_variable(tree.a[node], type, node);
+                    break;
+                }
+
+                /* A declaration that did not parse conflicts with nothing, its type is not known. */
+                if(variable_decl_datatype(node) == Unknown) break;
+                if(variable_decl_datatype(program_variables.typed_by[slot]) == Unknown)
+                {
+                    program_variables.types[slot] = type;
+                    program_variables.typed_by[slot] = node;
+                    break;
+                }
+
+                diagnose_at(tree.span_start[node]);
+                lang_assert(program_variables.types[slot] == type,
+                    "Variable `%s` on line %ld was already declared with another type on line %ld.\n",
+                    variable_redeclared_error, symbol_name(tree.a[node]), line_of_offset(lines, tree.span_start[node]),
+                    line_of_offset(lines, tree.span_start[program_variables.typed_by[slot]]))
+                break;
+            }
+            case variable_operand: {
+                uT32 slot = variable_slot(tree.a[node]);
+
+                tree.b[node] = slot;
+                diagnose_at(tree.span_start[node]);
+                lang_assert(slot != no_slot,
+                    "Variable `%s` on line %ld is not declared.\n",
+                    undeclared_variable_error, symbol_name(tree.a[node]), line_of_offset(lines, tree.span_start[node]))
+                break;
+            }
+            default: break;
+        }
+
+    stop_catching_errors(outer);
+
+    trace(TC_ast, TL_info, "Resolved %llu variables, from node %llu", program_variables.amount, first);
+}
+
+/* Walk `tree` in order, giving every declared variable a slot and resolving every use of one.
+ * The slot of a `variable_operand` goes in its `b`. `lines` is the line index of the source code `tree`
+ * was parsed from(for errors).
+ *
+ * Declaring a variable again with the same type reuses its slot, with another type is an error.
+ * So is using a variable before it is declared(a declaration that failed to parse still declares it). Either way resolving carries on with the next node.
+ * Every run starts over, errors of an earlier run are forgotten.
+ * */
+void resolve_variables(_line_index *lines)
+{
+    resolve_variables_from(lines, 0);
+}
+
+void destroy_variable_table()
+{
+    free(program_variables.slot_of_symbol);
+    free(program_variables.symbol_of_slot);
+    free(program_variables.types);
+    free(program_variables.declarations);
+    free(program_variables.typed_by);
+
+    program_variables = (_variable_table) { 0 };
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef virtual_machine
+#define virtual_machine
+
+/* Go to the code of the next instruction.
+ * Every instruction ends with its own indirect jump(rather than all of them going back to one `switch`),
+ * so the branch predictor sees each instruction's successor separately.
+ * */
+#define dispatch_next()     goto *dispatch[*ip++]
+
+/* Read the next operand of the instruction being run. */
+#define read_operand(into)  { memcpy(&into, ip, sizeof(uT32)); ip += sizeof(uT32); }
+
+/* Write `value` to `into` in base 10 or 16(with `0x`, digits in upper case), and return how many characters that took.
+ * `into` has to have room for 20.
+ * */
+static uT32 format_number(nT8 *into, uSIZE value, uT8 base)
+{
+    nT8 digits[20];
+    uT32 amount = 0, length = 0;
+
+    do
+    {
+        digits[amount++] = "0123456789ABCDEF"[value % base];
+        value /= base;
+    } while(value);
+
+    if(base == 16) { into[length++] = '0'; into[length++] = 'x'; }
+    while(amount) into[length++] = digits[--amount];
+
+    return length;
+}
+
+/* Print `value` in base `base`(see `format_number`), and a newline, to `out`. */
+static void print_number(FILE *out, uSIZE value, uT8 base)
+{
+    nT8 text[24];
+    uT32 length = format_number(text, value, base);
+
+    text[length++] = '\n';
+    fwrite_unlocked(text, 1, length, out);
+}
+
+/* Run `program`, with its numbers and strings in `rodata`. Everything printed goes to `out`, which is locked for
+ * the whole run(the prints use the `_unlocked` functions).
+ * Returns the status the program exited with.
+ * */
+nT32 run_bytecode(_bytecode *program, const uT8 *rodata, FILE *out)
+{
+    static const void *dispatch[opcode_amount] = {
+        [op_load_number] = &&load_number,
+        [op_load_string] = &&load_string,
+        [op_load_zero] = &&load_zero,
+        [op_load_slot] = &&load_slot,
+        [op_store_slot] = &&store_slot,
+        [op_print_string] = &&print_string,
+        [op_print_integer] = &&print_integer,
+        [op_print_hex] = &&print_hex,
+        [op_print_float] = &&print_float,
+        [op_exit] = &&exit_program,
+        [op_halt] = &&halt,
+        [op_store_number] = &&store_number,
+        [op_store_string] = &&store_string,
+        [op_store_zero] = &&store_zero,
+        [op_print_string_constant] = &&print_string_constant,
+        [op_print_integer_constant] = &&print_integer_constant,
+        [op_print_hex_constant] = &&print_hex_constant,
+        [op_print_float_constant] = &&print_float_constant,
+        [op_print_slot_string] = &&print_slot_string,
+        [op_print_slot_integer] = &&print_slot_integer,
+        [op_print_slot_hex] = &&print_slot_hex
+    };
+
+    uSIZE *slots = calloc(program->slots + 1, sizeof(*slots));
+    lang_assert(slots,
+        "Error allocating memory for the variables of the program.\n\tTry rerunning the program.\n",
+        OOC_allocation_error)
+
+    uT8 *ip = program->code;
+    uSIZE accumulator = 0;
+    uT32 operand = 0, slot = 0, length = 0;
+    nT32 status = 0;
+
+    flockfile(out);
+    dispatch_next();
+
+    load_number:
+        read_operand(operand)
+        memcpy(&accumulator, &rodata[operand], sizeof(accumulator));
+        dispatch_next();
+
+    load_string:
+        read_operand(operand)
+        accumulator = (uSIZE) &rodata[operand];
+        dispatch_next();
+
+    load_zero:
+        accumulator = 0;
+        dispatch_next();
+
+    load_slot:
+        read_operand(operand)
+        accumulator = slots[operand];
+        dispatch_next();
+
+    store_slot:
+        read_operand(operand)
+        slots[operand] = accumulator;
+        dispatch_next();
+
+    print_string:
+        if(accumulator) fwrite_unlocked((const nT8 *) accumulator, 1, strlen((const nT8 *) accumulator), out);
+        putc_unlocked('\n', out);
+        dispatch_next();
+
+    print_integer:
+        print_number(out, accumulator, 10);
+        dispatch_next();
+
+    print_hex:
+        print_number(out, accumulator, 16);
+        dispatch_next();
+
+    print_float: {
+        double value;
+
+        read_operand(operand)
+        memcpy(&value, &accumulator, sizeof(value));
+        fprintf(out, "%.15g\n", value);
+        dispatch_next();
+    }
+
+    exit_program:
+        read_operand(operand)
+        status = operand;
+        goto halt;
+
+    store_number:
+        read_operand(slot)
+        read_operand(operand)
+        memcpy(&slots[slot], &rodata[operand], sizeof(*slots));
+        dispatch_next();
+
+    store_string:
+        read_operand(slot)
+        read_operand(operand)
+        slots[slot] = (uSIZE) &rodata[operand];
+        dispatch_next();
+
+    store_zero:
+        read_operand(slot)
+        slots[slot] = 0;
+        dispatch_next();
+
+    print_slot_string:
+        read_operand(slot)
+        if(slots[slot]) fwrite_unlocked((const nT8 *) slots[slot], 1, strlen((const nT8 *) slots[slot]), out);
+        putc_unlocked('\n', out);
+        dispatch_next();
+
+    print_slot_integer:
+        read_operand(slot)
+        print_number(out, slots[slot], 10);
+        dispatch_next();
+
+    print_slot_hex:
+        read_operand(slot)
+        print_number(out, slots[slot], 16);
+        dispatch_next();
+
+    print_string_constant:
+        read_operand(operand)
+        read_operand(length)
+        fwrite_unlocked(&rodata[operand], 1, length, out);
+        putc_unlocked('\n', out);
+        dispatch_next();
+
+    print_integer_constant:
+        read_operand(operand)
+        memcpy(&accumulator, &rodata[operand], sizeof(accumulator));
+        print_number(out, accumulator, 10);
+        dispatch_next();
+
+    print_hex_constant:
+        read_operand(operand)
+        memcpy(&accumulator, &rodata[operand], sizeof(accumulator));
+        print_number(out, accumulator, 16);
+        dispatch_next();
+
+    print_float_constant: {
+        double value;
+
+        read_operand(operand)
+        memcpy(&value, &rodata[operand], sizeof(value));
+        fprintf(out, "%.15g\n", value);
+        dispatch_next();
+    }
+
+    halt:
+        free(slots);
+        fflush_unlocked(out);
+        funlockfile(out);
+
+        return status;
+}
+
+#undef dispatch_next
+#undef read_operand
+
+#endif
@@ -3,11 +3,87 @@
 
 int main(int args, char *argv[])
 {
-    lang_assert(args > 1, "Expected file as argument.\n", no_file_given_error)
+    bool streaming = false;
+    bool jit = false;
+    uT32 jobs = 1;
+    bool jobs_given = false;
+    const nT8 *cache_directory = NULL;
+    const nT8 *output = NULL;
+    bool c_source = false;
+    nT8 *files[args];
+    uT32 inputs = 0;
+    _source_edit edits[args];
+    uT32 edit_amount = 0;
 
-    lang_assert(check_file(argv[1]), "The file `%s` has the wrong extension.\n\tThe extension should be `.sum`.\n", wrong_extension_error, argv[1])
+    /* The last option given that only means something for a single file, NULL if there was none. */
+    const nT8 *file_option = NULL;
 
-    run(argv[1]);
+    for(nT32 i = 1; i < args; i++)
+    {
+        /* `--stream` - lex the file through a fixed size window. Only the source code held in memory is bounded,
+         * its line index and tree still grow with the file(see `init_lexer`).
+         * */
+        if(strcmp(argv[i], "--stream") == 0) { streaming = true; file_option = argv[i]; continue; }
 
-    return 0;
+        /* `--jit` - run the program as machine code, `--interpret` - run it on the virtual machine(the default). */
+        if(strcmp(argv[i], "--jit") == 0) { jit = true; file_option = argv[i]; continue; }
+        if(strcmp(argv[i], "--interpret") == 0) { jit = false; file_option = argv[i]; continue; }
+
+        /* `--emit-elf FILE` - write the program as an executable to `FILE`, `--emit-c FILE` - as C, instead of running it. */
+        if(strcmp(argv[i], "--emit-elf") == 0 && i + 1 < args) { file_option = argv[i]; output = argv[++i]; c_source = false; continue; }
+        if(strcmp(argv[i], "--emit-c") == 0 && i + 1 < args) { file_option = argv[i]; output = argv[++i]; c_source = true; continue; }
+
+        /* `--edit START END TEXT` - run the file as if the bytes [`START`, `END`) were `TEXT`, without saving it.
+         * Given more than once, the edits are applied in order(see `apply_edit`).
+         * */
+        if(strcmp(argv[i], "--edit") == 0 && i + 3 < args)
+        {
+            edits[edit_amount].start = strtoull(argv[i + 1], NULL, 10);
+            edits[edit_amount].end = strtoull(argv[i + 2], NULL, 10);
+            edits[edit_amount].replacement = uT8_PCC argv[i + 3];
+            edits[edit_amount].replacement_length = strlen(argv[i + 3]);
+            edit_amount++;
+            file_option = argv[i];
+            i += 3;
+            continue;
+        }
+
+        /* `--jobs N` - lex and parse on `N` threads, `--jobs 0` uses one per CPU. */
+        if(strcmp(argv[i], "--jobs") == 0 && i + 1 < args)
+        {
+            jobs = strtoul(argv[++i], NULL, 10);
+            if(jobs == 0) jobs = sysconf(_SC_NPROCESSORS_ONLN);
+            jobs_given = true;
+            continue;
+        }
+
+        /* `--cache` - reuse what an earlier run parsed, from `SUM_CACHE_DIR`(`.sum_cache` by default). */
+        if(strcmp(argv[i], "--cache") == 0)
+        {
+            cache_directory = getenv("SUM_CACHE_DIR");
+            if(!(cache_directory) || !(cache_directory[0])) cache_directory = default_cache_directory;
+            continue;
+        }
+
+        /* Everything else is a file to compile, a directory of them, or `@` and a file listing them. */
+        files[inputs++] = argv[i];
+    }
+
+    lang_assert(inputs, "Expected file as argument.\n", no_file_given_error)
+
+    /* More than one file is a batch(see `run_batch`), on one thread per CPU unless `--jobs` says otherwise. */
+    struct stat info;
+    if(inputs > 1 || files[0][0] == '@' || (stat(files[0], &info) == 0 && S_ISDIR(info.st_mode)))
+    {
+        /* A batch is only compiled, nothing of it is run, written or edited. */
+        lang_assert(!(file_option),
+            "`%s` only works with a single file.\n\tA batch(more than one file, a directory or `@FILE`) is only compiled.\n",
+            batch_option_error, file_option)
+
+        return run_batch(files, inputs, jobs_given ? jobs : (uT32) sysconf(_SC_NPROCESSORS_ONLN), cache_directory);
+    }
+
+    if(edit_amount) return run_edited(files[0], edits, edit_amount, jit);
+    if(output) return build(files[0], streaming, jobs, cache_directory, output, c_source);
+    return run(files[0], streaming, jobs, cache_directory, jit);
 }
\ No newline at end of file
@@ -101,16 +101,18 @@ typedef struct memory_info
     uT32                    PD_vars_size;
 } _memory_info;
 
-static _memory_info *program_memory_info = NULL;
+/* The memory info of the compilation that is running(see `context.h`). */
+#define program_memory_info (active_context->memory_info)
 
 /* Default values just in case user does not create there own `.mem` file.
  * `default_program_bytesize` - allow programs up to 1MB.
  * */
 #define default_program_bytesize        0x100000
 
+/* `program_memory_info`, and everything it points to besides `PD_vars` itself, lives in `front_end_arena`. */
 void init_program_memory_info()
 {
-    program_memory_info = calloc(1, sizeof(*program_memory_info));
+    program_memory_info = front_end_alloc(sizeof(*program_memory_info));
 
     program_memory_info->PD_vars = NULL;
     program_memory_info->PD_vars_size = 0;
@@ -138,12 +140,7 @@ void try_init_PD_vars()
     }
 
     if(!(program_memory_info->PD_vars[program_memory_info->PD_vars_size]))
-    {
-        program_memory_info->PD_vars[program_memory_info->PD_vars_size] = calloc(1, sizeof(*program_memory_info->PD_vars[program_memory_info->PD_vars_size]));
-        lang_assert(program_memory_info->PD_vars[program_memory_info->PD_vars_size],
-            "Error allocating new PD Variable index.\n\tTry rerunning the program.\n",
-            OOC_allocation_error)
-    }
+        program_memory_info->PD_vars[program_memory_info->PD_vars_size] = front_end_alloc(sizeof(*program_memory_info->PD_vars[program_memory_info->PD_vars_size]));
 }
 
 void create_next_PD_var_element()//(uT8 *var_name, enum predefined_variable_types var_type, uT32 memory_needed, void *data)
@@ -154,22 +151,16 @@ void create_next_PD_var_element()//(uT8 *var_name, enum predefined_variable_type
         (program_memory_info->PD_vars_size + 1) * sizeof(*program_memory_info->PD_vars)
     );
 
-    program_memory_info->PD_vars[program_memory_info->PD_vars_size] = calloc(1, sizeof(*program_memory_info->PD_vars[program_memory_info->PD_vars_size]));
-    lang_assert(program_memory_info->PD_vars[program_memory_info->PD_vars_size],
-        "Error allocating memory for new PD Variable index.\n\tTry rerunning the program.\n",
+    lang_assert(program_memory_info->PD_vars,
+        "Error allocating memory for PD Variables.\n\tTry rerunning the program.\n",
         OOC_allocation_error)
+
+    program_memory_info->PD_vars[program_memory_info->PD_vars_size] = front_end_alloc(sizeof(*program_memory_info->PD_vars[program_memory_info->PD_vars_size]));
 }
 
 void assign_PD_var_name(uT8 *name)
 {
-    /* Make sure we have enough memory. */
-    program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_name = calloc(strlen(nT8_PCC name), sizeof(*program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_name));
-    lang_assert(program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_name, 
-        "Error allocating memory for new PD variable name.\n\tTry rerunning the program.\n", 
-        OOC_allocation_error)
-
-    memcpy(program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_name, name, strlen(nT8_PCC name));
-    memset(&program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_name[strlen(nT8_PCC name)], 0, 1);
+    program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_name = front_end_copy(name, strlen(nT8_PCC name));
 }
 uT8 *get_curr_PD_var_name()
 {
@@ -202,7 +193,7 @@ void assign_PD_var_value_byte(uT8 value, uT16 index)
     if(program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_size > 1)
     {
         if(!(program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_data.ptr_byte_data))
-            program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_data.ptr_byte_data = calloc(program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_size, sizeof(*program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_data.ptr_byte_data));
+            program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_data.ptr_byte_data = front_end_alloc(program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_size * sizeof(*program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_data.ptr_byte_data));
     
         memset(&program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_data.ptr_byte_data[index], value, 1);
         return;
@@ -211,4 +202,20 @@ void assign_PD_var_value_byte(uT8 value, uT16 index)
     program_memory_info->PD_vars[program_memory_info->PD_vars_size]->PD_var_data.byte_data = value;
 }
 
+/* The bytes PD variable `var` is preset to, NULL if it is not(see `assign_PD_var_value_byte`). */
+const uT8 *PD_var_bytes(_predefined_variables *var)
+{
+    if(var->PD_var_size > 1) return var->PD_var_data.ptr_byte_data;
+    return &var->PD_var_data.byte_data;
+}
+
+/* Only `PD_vars` is on the heap, everything else goes with `front_end_arena`. */
+void destroy_program_memory_info()
+{
+    if(!(program_memory_info)) return;
+
+    free(program_memory_info->PD_vars);
+    program_memory_info = NULL;
+}
+
 #endif
\ No newline at end of file
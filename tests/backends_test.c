@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <sys/wait.h>
+#include "../common.h"
+
+/* Checks every way of running a program gives the same result: each fixture is run on the virtual machine
+ * (`--interpret`), as machine code(`--jit`), as an executable(`--emit-elf`) and as C built by `gcc`(`--emit-c`),
+ * and has to print exactly the same and exit with the same status every time.
+ * Run with `make test`, from the root of the repository(after `make run`).
+ * */
+static const nT8 *fixtures[] = {
+    "tests/backends.sum",
+    "tests/test2.sum",
+    "tests/include.sum",
+};
+
+/* The first one is what the others are compared against. */
+static const nT8 *backends[] = { "--interpret", "--jit", "--emit-elf", "--emit-c" };
+
+#define amount_of(array)    (sizeof(array) / sizeof(*(array)))
+
+#define compiler            "./bin/main.o"
+#define built_program       "bin/backends_program"
+
+/* Run `command`, and return the status it exited with(-1 if it did not exit). */
+static nT32 run_command(const nT8 *command)
+{
+    nT32 status = system(command);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/* Run `fixture` with `backend`, its output goes to `output`. Returns the status it exited with, -1 if it could not be built. */
+static nT32 run_backend(const nT8 *fixture, const nT8 *backend, const nT8 *output)
+{
+    nT8 command[0x400];
+
+    if(strcmp(backend, "--emit-elf") == 0)
+    {
+        snprintf(command, sizeof(command), compiler " --emit-elf " built_program " %s", fixture);
+        if(run_command(command)) return -1;
+    }
+    else if(strcmp(backend, "--emit-c") == 0)
+    {
+        snprintf(command, sizeof(command), compiler " --emit-c " built_program ".c %s && gcc -O2 -w " built_program ".c -o " built_program, fixture);
+        if(run_command(command)) return -1;
+    }
+    else
+    {
+        snprintf(command, sizeof(command), compiler " %s %s > %s", backend, fixture, output);
+        return run_command(command);
+    }
+
+    snprintf(command, sizeof(command), "./" built_program " > %s", output);
+    return run_command(command);
+}
+
+/* The whole file at `path`, on the heap(`size` set to its size). */
+static uT8 *read_file(const nT8 *path, uSIZE *size)
+{
+    FILE *file = fopen(path, "rb");
+    if(!(file)) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uT8 *data = malloc(*size + 1);
+    if(data && fread(data, 1, *size, file) != *size)
+    {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+    return data;
+}
+
+int main()
+{
+    uT32 failed = 0;
+
+    for(uT32 i = 0; i < amount_of(fixtures); i++)
+    {
+        uSIZE expected_size, size;
+        nT32 expected_status = run_backend(fixtures[i], backends[0], built_program ".expected");
+        uT8 *expected = read_file(built_program ".expected", &expected_size);
+        bool same = true;
+
+        for(uT32 b = 1; b < amount_of(backends); b++)
+        {
+            nT32 status = run_backend(fixtures[i], backends[b], built_program ".out");
+            uT8 *output = read_file(built_program ".out", &size);
+
+            if(status != expected_status || !(expected) || !(output) || size != expected_size || memcmp(output, expected, size) != 0)
+            {
+                fprintf(stderr, "`%s` with `%s` exits with %d after %llu bytes of output, with `%s` with %d after %llu.\n",
+                    fixtures[i], backends[b], status, output ? size : 0, backends[0], expected_status, expected ? expected_size : 0);
+                same = false;
+            }
+
+            free(output);
+        }
+
+        free(expected);
+        if(!(same)) failed++;
+    }
+
+    remove(built_program);
+    remove(built_program ".c");
+    remove(built_program ".out");
+    remove(built_program ".expected");
+
+    printf("%u of %u fixtures run the same with every backend.\n", (uT32) amount_of(fixtures) - failed, (uT32) amount_of(fixtures));
+    return failed ? 1 : 0;
+}
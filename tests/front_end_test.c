@@ -0,0 +1,462 @@
+#include <stdio.h>
+#include <dirent.h>
+#include "../common.h"
+
+/* Checks of the front end on small programs written for each check: each one is compiled(see `compile`)
+ * and its tree and errors looked at. Run with `make test`, from the root of the repository.
+ * */
+#define scratch_directory   "/tmp/sum_front_end"
+#define scratch_cache       scratch_directory "/cache"
+
+static uT32 checks, failed;
+
+static void check(bool passed, const nT8 *what)
+{
+    checks++;
+    if(passed) return;
+
+    fprintf(stderr, "Failed: %s.\n", what);
+    failed++;
+}
+
+static void write_file(const nT8 *path, const void *data, uSIZE size)
+{
+    FILE *file = fopen(path, "wb");
+    if(!(file) || fwrite(data, 1, size, file) != size)
+    {
+        fprintf(stderr, "Could not write `%s`.\n", path);
+        exit(1);
+    }
+    fclose(file);
+}
+
+static void write_text(const nT8 *path, const nT8 *text)
+{
+    write_file(path, text, strlen(text));
+}
+
+/* The whole file at `path`, on the heap(`size` set to its size). */
+static uT8 *read_file(const nT8 *path, uSIZE *size)
+{
+    FILE *file = fopen(path, "rb");
+    if(!(file)) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uT8 *data = malloc(*size + 1);
+    if(data && fread(data, 1, *size, file) != *size)
+    {
+        free(data);
+        data = NULL;
+    }
+
+    fclose(file);
+    return data;
+}
+
+/* Write `source` to `name` in the scratch directory, and compile it. The compilation is left active. */
+static _compiler_context *compile_source(const nT8 *name, const nT8 *source, uT32 jobs, const nT8 *cache_directory)
+{
+    nT8 path[0x100];
+    snprintf(path, sizeof(path), scratch_directory "/%s", name);
+    write_text(path, source);
+
+    _compiler_context *context = compile(path, false, jobs, cache_directory, NULL);
+    use_compiler_context(context);
+    return context;
+}
+
+/* Does `context` have an error with `error_code`(any error at all, if it is 0)? */
+static bool has_error(_compiler_context *context, nT32 error_code)
+{
+    for(uT32 i = 0; i < context->diagnostics.amount; i++)
+        if(!(error_code) || context->diagnostics.entries[i].error_code == error_code) return true;
+
+    return false;
+}
+
+/* The `nth` node(from 0) of kind `kind` in the active tree, `no_node` if there is none. */
+static uT32 find_node(enum action kind, uT32 nth)
+{
+    for(uT32 node = 0; node < tree.amount; node++)
+        if(tree.kind[node] == kind && nth-- == 0) return node;
+
+    return no_node;
+}
+
+/* Is the `nth` operand of kind `kind` the number `value`? */
+static bool number_is(enum action kind, uT32 nth, uSIZE value)
+{
+    uT32 node = find_node(kind, nth);
+    return node != no_node && ast_number(node) == value;
+}
+
+/* Numbers are decoded once, by the lexer: both spellings of hexadecimal, and every way one can be too large. */
+static void check_numbers()
+{
+    _compiler_context *context = compile_source("numbers.sum",
+        "hex a = 1Fh\nhex b = 0x1f\nint c = 255\nprint 1.5\nprint 18446744073709551615\nprint 0FFFFFFFFFFFFFFFFh\n", 1, NULL);
+
+    double one_and_a_half = 1.5;
+    uSIZE bits;
+    memcpy(&bits, &one_and_a_half, sizeof(bits));
+
+    check(!(has_error(context, 0)), "numbers that fit are not errors");
+    check(number_is(hex_operand, 0, 0x1F) && number_is(hex_operand, 1, 0x1F), "`1Fh` and `0x1f` are both 0x1F");
+    check(number_is(integer_operand, 0, 255), "`255` is 255");
+    check(number_is(float_operand, 0, bits), "`1.5` is 1.5");
+    check(number_is(integer_operand, 1, ~0ULL), "the largest integer is not too large");
+    check(number_is(hex_operand, 2, ~0ULL), "leading zeros do not make a hexadecimal number too large");
+    destroy_compiler_context(context);
+
+    static const struct { const nT8 *source; nT32 error_code; const nT8 *what; } errors[] = {
+        { "print 18446744073709551616\n", lexing_too_large_number_error, "an integer over 64 bits is too large" },
+        { "print 0x10000000000000000\n", lexing_too_large_number_error, "17 hexadecimal digits are too large" },
+        { "print 10000000000000000h\n", lexing_too_large_number_error, "17 digits before `h` are too large" },
+        { "print 0x\n", unexpected_end_of_hex_error, "`0x` alone is not a number" },
+        { "print 12AB\n", lexing_invalid_hex_value_error, "hexadecimal digits need `0x` or `h`" },
+        { "print 1.\n", unexpected_end_of_decimal_error, "a decimal needs digits after the `.`" },
+        { "print 0xABT\n", lexing_invalid_hex_value_error, "a number ends where it ends" },
+    };
+
+    for(uT32 i = 0; i < sizeof(errors) / sizeof(*errors); i++)
+    {
+        context = compile_source("numbers.sum", errors[i].source, 1, NULL);
+        check(has_error(context, errors[i].error_code), errors[i].what);
+        destroy_compiler_context(context);
+    }
+
+    /* Too many digits for a double to hold goes through `strtod`, which can overflow. */
+    nT8 source[0x200] = "print 1";
+    memset(&source[7], '0', 400);
+    strcpy(&source[407], ".5\n");
+
+    context = compile_source("numbers.sum", source, 1, NULL);
+    check(has_error(context, lexing_too_large_number_error), "a decimal too large for a double is too large");
+    destroy_compiler_context(context);
+}
+
+/* Path of the(only) file in the cache into `path`, false if there is none. With `remove_all`, every file in it is removed instead. */
+static bool find_cache_file(nT8 *path, uSIZE size, bool remove_all)
+{
+    DIR *directory = opendir(scratch_cache);
+    struct dirent *entry;
+    bool found = false;
+
+    while(directory && (entry = readdir(directory)))
+    {
+        if(entry->d_name[0] == '.') continue;
+
+        snprintf(path, size, scratch_cache "/%s", entry->d_name);
+        if(remove_all) remove(path);
+        else found = true;
+    }
+
+    if(directory) closedir(directory);
+    return found;
+}
+
+/* Compile `name` against the cache: is it loaded from it, and does it compile(with its `.mem` info) like it does without it? */
+static bool loads_from_cache(const nT8 *name, const nT8 *source, bool *same)
+{
+    _compiler_context *fresh = compile_source(name, source, 1, NULL);
+    _compiler_context *context = compile_source(name, source, 1, scratch_cache);
+    _memory_info *x = context->memory_info, *y = fresh->memory_info;
+
+    *same = !(has_error(context, 0)) && context->bytecode && x->PD_vars_size == y->PD_vars_size && x->mem_in_bytes == y->mem_in_bytes &&
+            (!(x->PD_vars) || strcmp(nT8_PC x->PD_vars[0]->PD_var_name, nT8_PC y->PD_vars[0]->PD_var_name) == 0);
+
+    bool loaded = context->cache_mapping != NULL;
+    destroy_compiler_context(context);
+    destroy_compiler_context(fresh);
+    return loaded;
+}
+
+/* A cache file is only used when it checks out: a damaged, cut short or stale one is parsed again instead,
+ * and leaves nothing of itself behind(see `load_cached_program`).
+ * */
+static void check_cache()
+{
+    static const nT8 source[] = "#incmem \"custom.mem\"\nprint 'cached'\nint a = 1\nprint a\n";
+    nT8 path[0x200];
+    uSIZE size;
+    bool same;
+
+    mkdir(scratch_cache, 0755);
+    find_cache_file(path, sizeof(path), true);
+
+    check(!(loads_from_cache("cached.sum", source, &same)) && same, "a program is parsed the first time");
+    check(loads_from_cache("cached.sum", source, &same) && same, "a program is loaded from the cache the second time");
+    check(find_cache_file(path, sizeof(path), false), "the cache has a file");
+
+    /* One byte of the nodes changed: the checksum no longer matches. */
+    uT8 *data = read_file(path, &size);
+    _cache_header *header = (_cache_header *) data;
+    data[header->kind] ^= 0xFF;
+    write_file(path, data, size);
+    check(!(loads_from_cache("cached.sum", source, &same)) && same, "a damaged cache file is not used");
+    free(data);
+
+    /* The file is written again after it was not used, cut short it no longer matches its size. */
+    data = read_file(path, &size);
+    write_file(path, data, size / 2);
+    check(!(loads_from_cache("cached.sum", source, &same)) && same, "a cache file cut short is not used");
+    free(data);
+
+    /* The checksum matches, but the `.mem` info claims one more PD variable than there is: the loader
+     * has taken in the ones that are there by the time it runs out, they have to be taken back.
+     * */
+    data = read_file(path, &size);
+    header = (_cache_header *) data;
+    ((_cached_memory_info *) &data[header->memory_info])->PD_vars++;
+    header->checksum = hash_bytes(&data[cache_checksum_start], size - cache_checksum_start, cache_format_version);
+    write_file(path, data, size);
+    check(!(loads_from_cache("cached.sum", source, &same)) && same, "a cache file with a broken `.mem` info is not used");
+    check(loads_from_cache("cached.sum", source, &same) && same, "the cache file written instead is used");
+    free(data);
+
+    /* An included file that changed makes the cache file stale. */
+    write_text(scratch_directory "/dependency.sum", "print 'before'\n");
+    compile_source("depends.sum", "#include \"dependency.sum\"\n", 1, scratch_cache);
+    destroy_compiler_context(active_context);
+    write_text(scratch_directory "/dependency.sum", "print 'after!'\n");
+
+    _compiler_context *context = compile_source("depends.sum", "#include \"dependency.sum\"\n", 1, scratch_cache);
+    uT32 node = find_node(string_operand, 0);
+    check(!(context->cache_mapping) && node != no_node && strcmp(nT8_PC &tree.strings[tree.a[node]], "after!") == 0,
+        "a cache file is not used once a file it includes changed");
+    destroy_compiler_context(context);
+
+    find_cache_file(path, sizeof(path), true);
+    rmdir(scratch_cache);
+    remove(scratch_directory "/cached.sum");
+    remove(scratch_directory "/depends.sum");
+    remove(scratch_directory "/dependency.sum");
+}
+
+/* How many nodes of kind `kind` the active tree has. */
+static uT32 count_nodes(enum action kind)
+{
+    uT32 amount = 0;
+
+    for(uT32 node = 0; node < tree.amount; node++)
+        if(tree.kind[node] == kind) amount++;
+
+    return amount;
+}
+
+/* Every file is linked in once, however it is reached: through a cycle, another path or a copy of it. */
+static void check_includes()
+{
+    write_text(scratch_directory "/cycle_b.sum", "#include \"cycle_a.sum\"\nprint 'b'\n");
+    _compiler_context *context = compile_source("cycle_a.sum", "#include \"cycle_b.sum\"\nprint 'a'\n", 1, NULL);
+    uT32 cycle_back = find_node(include_statement, 1);
+
+    check(!(has_error(context, 0)) && context->bytecode, "files including each other compile");
+    check(count_nodes(print_statement) == 2 && cycle_back != no_node && tree.b[cycle_back] == include_repeated,
+        "a file including the file that included it adds nothing");
+    destroy_compiler_context(context);
+
+    write_text(scratch_directory "/copy_one.sum", "print 'copy'\n");
+    write_text(scratch_directory "/copy_two.sum", "print 'copy'\n");
+    context = compile_source("copies.sum", "#include \"copy_one.sum\"\n#include \"./copy_one.sum\"\n#include \"copy_two.sum\"\n", 1, NULL);
+    check(!(has_error(context, 0)) && count_nodes(print_statement) == 1, "another path to a file, or a copy of it, is the same file");
+    destroy_compiler_context(context);
+
+    context = compile_source("missing.sum", "#include \"no_such_file.sum\"\nprint 'a'\n", 1, NULL);
+    check(has_error(context, file_not_exist_error), "including a file that does not exist is an error");
+    destroy_compiler_context(context);
+
+    remove(scratch_directory "/cycle_a.sum");
+    remove(scratch_directory "/cycle_b.sum");
+    remove(scratch_directory "/copy_one.sum");
+    remove(scratch_directory "/copy_two.sum");
+    remove(scratch_directory "/copies.sum");
+    remove(scratch_directory "/missing.sum");
+}
+
+static nT32 compare_errors(const void *left, const void *right)
+{
+    const _diagnostic *l = left, *r = right;
+
+    if(l->offset != r->offset) return l->offset < r->offset ? -1 : 1;
+    if(l->error_code != r->error_code) return l->error_code - r->error_code;
+    return strcmp(l->message ? l->message : "", r->message ? r->message : "");
+}
+
+/* Do `x` and `y` have the same tree, symbols and errors? */
+static bool same_compilation(_compiler_context *x, _compiler_context *y)
+{
+    _ast_tree *tx = x->syntax_tree, *ty = y->syntax_tree;
+    _symbol_table *sx = x->symbol_names, *sy = y->symbol_names;
+    _diagnostics *dx = &x->diagnostics, *dy = &y->diagnostics;
+
+    if(tx->amount != ty->amount || tx->strings_size != ty->strings_size ||
+       memcmp(tx->kind, ty->kind, tx->amount * sizeof(*tx->kind)) != 0 ||
+       memcmp(tx->a, ty->a, tx->amount * sizeof(*tx->a)) != 0 ||
+       memcmp(tx->b, ty->b, tx->amount * sizeof(*tx->b)) != 0 ||
+       memcmp(tx->span_start, ty->span_start, tx->amount * sizeof(*tx->span_start)) != 0 ||
+       memcmp(tx->span_length, ty->span_length, tx->amount * sizeof(*tx->span_length)) != 0 ||
+       memcmp(tx->strings, ty->strings, tx->strings_size) != 0)
+        return false;
+
+    if((sx ? sx->amount : 0) != (sy ? sy->amount : 0)) return false;
+    for(uT32 id = 0; sx && id < sx->amount; id++)
+        if(strcmp(&sx->arena[sx->names[id]], &sy->arena[sy->names[id]]) != 0) return false;
+
+    if(dx->amount != dy->amount) return false;
+    qsort(dx->entries, dx->amount, sizeof(*dx->entries), compare_errors);
+    qsort(dy->entries, dy->amount, sizeof(*dy->entries), compare_errors);
+
+    for(uT32 i = 0; i < dx->amount; i++)
+        if(compare_errors(&dx->entries[i], &dy->entries[i]) != 0) return false;
+
+    return true;
+}
+
+/* A program of about `size` bytes(on the heap), mixing lines that compile with lines that have errors. */
+static nT8 *generate_program(uSIZE size)
+{
+    static const nT8 *lines[] = {
+        "print 'hello world'\n", "int a = 5\n", "int a = 6\n", "str s = 'hi'\n", "hex h = 1Fh\n", "char c = 'z'\n",
+        "print a\n", "print s\n", "print h\n", "print 3.5\n", "print 0x10\n", "\n", "int = 4\n", "str a = 5\n",
+        "print q\n", "@@\n", "print 'unterminated\n", "print 99999999999999999999\n", "str other = 'x'\n", "print other\n",
+    };
+
+    nT8 *source = malloc(size + 0x40);
+    uSIZE used = 0;
+    uT32 random_state = 1;
+
+    while(used < size)
+    {
+        random_state = random_state * 1103515245 + 12345;
+        const nT8 *line = lines[(random_state >> 8) % (sizeof(lines) / sizeof(*lines))];
+
+        memcpy(&source[used], line, strlen(line));
+        used += strlen(line);
+    }
+    strcpy(&source[used], "exit 3\n");
+
+    return source;
+}
+
+/* A file large enough to be split into chunks(see `run_parser_parallel`) parses the same on many threads as on one. */
+static void check_parallel_front_end()
+{
+    nT8 *source = generate_program(parallel_min_chunk_size * 6);
+
+    _compiler_context *serial = compile_source("parallel.sum", source, 1, NULL);
+    _compiler_context *parallel = compile_source("parallel.sum", source, 4, NULL);
+
+    check(has_error(serial, 0) && same_compilation(serial, parallel), "a file parses the same on 4 threads as on 1");
+
+    destroy_compiler_context(parallel);
+    destroy_compiler_context(serial);
+    free(source);
+    remove(scratch_directory "/parallel.sum");
+}
+
+/* A file lexed through windows(see `init_lexer`) parses the same as one loaded whole, statements that
+ * straddle two windows included.
+ * */
+static void check_streaming()
+{
+    nT8 *source = generate_program(source_window_size * 5 / 2);
+
+    _compiler_context *whole = compile_source("streamed.sum", source, 1, NULL);
+    _compiler_context *streamed = compile(scratch_directory "/streamed.sum", true, 1, NULL, NULL);
+
+    check(has_error(whole, 0) && same_compilation(whole, streamed), "a streamed file parses the same as one loaded whole");
+
+    destroy_compiler_context(streamed);
+    destroy_compiler_context(whole);
+    free(source);
+    remove(scratch_directory "/streamed.sum");
+}
+
+/* Run the batch of `inputs` on `jobs` threads, with what it prints in `printed`(on the heap). Returns its status. */
+static nT32 run_quiet_batch(nT8 **inputs, uT32 amount, uT32 jobs, uT8 **printed)
+{
+    uSIZE size;
+    nT32 output = dup(1), errors = dup(2);
+    FILE *file = fopen(scratch_directory "/batch.out", "wb");
+
+    fflush(stdout);
+    fflush(stderr);
+    dup2(fileno(file), 1);
+    dup2(fileno(file), 2);
+
+    nT32 status = run_batch(inputs, amount, jobs, NULL);
+
+    fflush(stdout);
+    fflush(stderr);
+    dup2(output, 1);
+    dup2(errors, 2);
+    close(output);
+    close(errors);
+    fclose(file);
+
+    *printed = read_file(scratch_directory "/batch.out", &size);
+    (*printed)[size] = '\0';
+    remove(scratch_directory "/batch.out");
+    return status;
+}
+
+/* A batch compiles every `.sum` file it is given(through directories and response files), and fails
+ * with the status of the first file that failed.
+ * */
+static void check_batch()
+{
+    uT8 *printed;
+
+    mkdir(scratch_directory "/batch", 0755);
+    mkdir(scratch_directory "/batch/nested", 0755);
+    write_text(scratch_directory "/batch/a.sum", "print 'a'\n");
+    write_text(scratch_directory "/batch/b.sum", "print q\n");
+    write_text(scratch_directory "/batch/c.sum", "#incmem \"custom.mem\"\nprint 'c'\n");
+    write_text(scratch_directory "/batch/notes.txt", "not a program\n");
+    write_text(scratch_directory "/batch/nested/d.sum", "#incmem \"custom.mem\"\nexit 5\n");
+    write_text(scratch_directory "/batch/list", "# Only the files that compile.\n" scratch_directory "/batch/a.sum\n\n" scratch_directory "/batch/nested\n");
+
+    nT8 *directory[] = { scratch_directory "/batch" };
+    nT32 status = run_quiet_batch(directory, 1, 3, &printed);
+    check(status == undeclared_variable_error && strstr(nT8_PC printed, "[BATCH] 4 files on 3 threads") && strstr(nT8_PC printed, "3 compiled, 1 failed"),
+        "a directory is a batch of the `.sum` files in it, and fails with its failed file");
+    check(strstr(nT8_PC printed, "1 `.mem` files parsed once each for 2 programs") != NULL, "a `.mem` file is parsed once for a batch");
+    free(printed);
+
+    nT8 *response_file[] = { "@" scratch_directory "/batch/list" };
+    status = run_quiet_batch(response_file, 1, 1, &printed);
+    check(status == 0 && strstr(nT8_PC printed, "[BATCH] 2 files on 1 thread ") && strstr(nT8_PC printed, "2 compiled, 0 failed"),
+        "a response file lists the files and directories of a batch");
+    free(printed);
+
+    remove(scratch_directory "/batch/a.sum");
+    remove(scratch_directory "/batch/b.sum");
+    remove(scratch_directory "/batch/c.sum");
+    remove(scratch_directory "/batch/notes.txt");
+    remove(scratch_directory "/batch/list");
+    remove(scratch_directory "/batch/nested/d.sum");
+    rmdir(scratch_directory "/batch/nested");
+    rmdir(scratch_directory "/batch");
+}
+
+int main()
+{
+    mkdir(scratch_directory, 0755);
+
+    check_numbers();
+    check_cache();
+    check_includes();
+    check_parallel_front_end();
+    check_streaming();
+    check_batch();
+
+    remove(scratch_directory "/numbers.sum");
+    rmdir(scratch_directory);
+
+    printf("%u of %u front end checks passed.\n", checks - failed, checks);
+    return failed ? 1 : 0;
+}
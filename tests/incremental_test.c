@@ -0,0 +1,226 @@
+#include <stdio.h>
+#include "../common.h"
+
+/* Checks `apply_edit` against parsing the edited source code from scratch.
+ * Every seed makes a program out of `program_lines`, then edits it `edits_per_seed` times. After every
+ * edit, the session's tree, constants and errors have to be exactly those of a new session on the edited file.
+ * Run with `make test`.
+ * */
+#define seeds               300
+#define edits_per_seed      20
+
+static const nT8 *program_lines[] = {
+    "print 'hello world'\n",
+    "print 'a b  c'\n",
+    "int a = 5\n",
+    "int a = 6\n",
+    "str s = 'hi'\n",
+    "hex h = 0x1F\n",
+    "hex h\n",
+    "char c = 'z'\n",
+    "char c\n",
+    "print c\n",
+    "print a\n",
+    "print s\n",
+    "print h\n",
+    "print 3.5\n",
+    "print 0x10\n",
+    "exit 3\n",
+    "\n",
+    "    \n",
+    "0str s = 'hi'\n",
+    "print 'unterminated\n",
+    "int = 4\n",
+    "str a = 5\n",
+    "print q\n",
+    "@@\n",
+    "exit 300\n",
+    "#include \"sum_edit_lib.sum\"\n",
+    "#include \"no_such_file.sum\"\n",
+};
+
+/* What `sum_edit_lib.sum` has, next to the file being edited. */
+static const nT8 library[] = "int l = 2\nprint 'lib'\nprint l\n";
+
+/* What an edit puts in place of what it removes, besides a whole line. */
+static const nT8 *edit_fragments[] = {
+    "", " ", "\n", "'", "0", "x", "int ", "print ", "= ", "a", "s", "7", "\n\n", "str s = 'hi'\n",
+};
+
+#define amount_of(array)    (sizeof(array) / sizeof(*(array)))
+
+static uT32 random_state;
+
+static uT32 next_random(uT32 below)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return (random_state >> 8) % below;
+}
+
+static void write_file(const nT8 *path, const uT8 *data, uSIZE size)
+{
+    FILE *file = fopen(path, "wb");
+    if(!(file) || fwrite(data, 1, size, file) != size)
+    {
+        fprintf(stderr, "Could not write `%s`.\n", path);
+        exit(1);
+    }
+    fclose(file);
+}
+
+static nT32 compare_errors(const void *left, const void *right)
+{
+    const _diagnostic *l = left, *r = right;
+
+    if(l->offset != r->offset) return l->offset < r->offset ? -1 : 1;
+    if(l->error_code != r->error_code) return l->error_code - r->error_code;
+    return strcmp(l->message ? l->message : "", r->message ? r->message : "");
+}
+
+/* Does the node `node` of `tree` in `context` say the same as the node `node` of `other`'s? */
+static bool same_node(_compiler_context *context, _compiler_context *other, uT32 node)
+{
+    _ast_tree *x = context->syntax_tree, *y = other->syntax_tree;
+
+    if(x->kind[node] != y->kind[node] || x->span_start[node] != y->span_start[node] || x->span_length[node] != y->span_length[node])
+        return false;
+
+    switch(x->kind[node])
+    {
+        case variable_operand:
+            if(x->b[node] != y->b[node]) return false;
+            /* Fall through, symbols are compared by name. */
+        case variable_decl: {
+            const nT8 *name_x = &context->symbol_names->arena[context->symbol_names->names[x->a[node]]];
+            const nT8 *name_y = &other->symbol_names->arena[other->symbol_names->names[y->a[node]]];
+
+            return strcmp(name_x, name_y) == 0 && (x->kind[node] == variable_operand || x->b[node] == y->b[node]);
+        }
+        case string_operand:
+        case char_operand: return x->b[node] == y->b[node] && memcmp(&x->strings[x->a[node]], &y->strings[y->a[node]], x->b[node]) == 0;
+        case include_statement: return x->b[node] == y->b[node] && strcmp(nT8_PC &x->strings[x->a[node]], nT8_PC &y->strings[y->a[node]]) == 0;
+        default: return x->a[node] == y->a[node] && x->b[node] == y->b[node];
+    }
+}
+
+/* Report the first way `edited` differs from `parsed`. */
+static bool same_result(_incremental_session *edited, _incremental_session *parsed)
+{
+    _compiler_context *x = edited->context, *y = parsed->context;
+
+    if(x->syntax_tree->amount != y->syntax_tree->amount)
+    {
+        fprintf(stderr, "%u nodes after the edit, %u when parsed again.\n", x->syntax_tree->amount, y->syntax_tree->amount);
+        return false;
+    }
+
+    for(uT32 node = 0; node < x->syntax_tree->amount; node++)
+        if(!(same_node(x, y, node)))
+        {
+            fprintf(stderr, "Node %u differs.\n", node);
+            return false;
+        }
+
+    /* The strings of the dropped nodes do not stay behind. */
+    if(x->syntax_tree->strings_size != y->syntax_tree->strings_size)
+    {
+        fprintf(stderr, "%u bytes of strings after the edit, %u when parsed again.\n", x->syntax_tree->strings_size, y->syntax_tree->strings_size);
+        return false;
+    }
+
+    if(x->variables->amount != y->variables->amount || x->constants->literals != y->constants->literals ||
+       x->constants->bytes_saved != y->constants->bytes_saved || x->constants->rodata_size != y->constants->rodata_size ||
+       memcmp(x->constants->rodata, y->constants->rodata, x->constants->rodata_size) != 0)
+    {
+        fprintf(stderr, "Variables or constants differ.\n");
+        return false;
+    }
+
+    for(uT32 node = 0; node < x->syntax_tree->amount; node++)
+    {
+        uT32 cx = x->constants->constant_of_node[node], cy = y->constants->constant_of_node[node];
+        if(cx != cy || (cx != no_constant && x->constants->entries[cx].offset != y->constants->entries[cy].offset))
+        {
+            fprintf(stderr, "The constant of node %u differs.\n", node);
+            return false;
+        }
+    }
+
+    _diagnostics *dx = &x->diagnostics, *dy = &y->diagnostics;
+    qsort(dx->entries, dx->amount, sizeof(*dx->entries), compare_errors);
+    qsort(dy->entries, dy->amount, sizeof(*dy->entries), compare_errors);
+
+    for(uT32 i = 0; i < dx->amount || i < dy->amount; i++)
+    {
+        if(i < dx->amount && i < dy->amount && compare_errors(&dx->entries[i], &dy->entries[i]) == 0) continue;
+
+        fprintf(stderr, "Errors differ:\n");
+        for(uT32 j = 0; j < dx->amount; j++) fprintf(stderr, "\tafter the edit @%llu: %s", dx->entries[j].offset, dx->entries[j].message);
+        for(uT32 j = 0; j < dy->amount; j++) fprintf(stderr, "\tparsed again  @%llu: %s", dy->entries[j].offset, dy->entries[j].message);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int args, char *argv[])
+{
+    const nT8 *path = args > 1 ? argv[1] : "/tmp/sum_edit.sum";
+    uT32 failed = 0;
+
+    const nT8 *slash = strrchr(path, '/');
+    nT8 library_path[0x1000];
+    snprintf(library_path, sizeof(library_path), "%.*ssum_edit_lib.sum", slash ? (nT32) (slash - path) + 1 : 0, path);
+    write_file(library_path, uT8_PCC library, strlen(library));
+
+    for(uT32 seed = 1; seed <= seeds; seed++)
+    {
+        random_state = seed;
+
+        /* The file always has something in it, an empty one is an error of its own. */
+        nT8 source[0x1000] = "print 'start'\n";
+        uT32 lines = 1 + next_random(12);
+        for(uT32 i = 0; i < lines; i++) strcat(source, program_lines[next_random(amount_of(program_lines))]);
+        write_file(path, uT8_PCC source, strlen(source));
+
+        _incremental_session *session = init_incremental(nT8_PC path);
+
+        for(uT32 e = 0; e < edits_per_seed; e++)
+        {
+            _source_buffer *buffer = session->lang_lexer->source;
+            const nT8 *replacement = next_random(3) ? edit_fragments[next_random(amount_of(edit_fragments))] : program_lines[next_random(amount_of(program_lines))];
+
+            /* Keep the program well under the size of `source`. */
+            uSIZE start = next_random(buffer->size + 1);
+            uSIZE end = start + next_random(buffer->size - start < 12 ? buffer->size - start + 1 : 12);
+            if(buffer->size - (end - start) + strlen(replacement) > 0xC00) replacement = "";
+
+            /* The first line stays, so the file is never empty. */
+            if(start < 14) start = end = 14;
+
+            _source_edit edit = { start, end, uT8_PCC replacement, strlen(replacement) };
+            apply_edit(session, edit);
+
+            write_file(path, buffer->data, buffer->size);
+            _incremental_session *parsed = init_incremental(nT8_PC path);
+
+            if(!(same_result(session, parsed)))
+            {
+                fprintf(stderr, "Seed %u, edit %u: [%llu, %llu) -> \"%s\" does not match parsing again. The source code is now:\n%.*s\n",
+                    seed, e, start, end, replacement, (nT32) buffer->size, buffer->data);
+                failed++;
+                destroy_incremental(parsed);
+                break;
+            }
+
+            destroy_incremental(parsed);
+        }
+
+        destroy_incremental(session);
+    }
+
+    remove(path);
+    remove(library_path);
+    printf("%u of %u seeds match parsing again after every edit.\n", seeds - failed, seeds);
+    return failed ? 1 : 0;
+}